@@ -0,0 +1,347 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_unroll.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * 04_Advanced/01_kernel_specialization - Compile-time unrolling and kernel specialization
+ *
+ * simdDotProductLarge (02_dot_product) and adjust_brightness_simd (04_image_processing)
+ * process exactly one vector per loop iteration. This example rewrites both as templates
+ * over the vector width (128/256/512 bits) and the unroll factor, using static_for<N>
+ * to expand the loop body at compile time.
+ *
+ * We'll:
+ * 1. Instantiate each kernel at several widths and unroll factors
+ * 2. Check every specialization against the scalar reference
+ * 3. Benchmark all specializations per input size and report the winner
+ * 4. Build a size-based dispatcher from the winners and use it
+ *
+ * For reductions the unroll factor also sets the number of independent accumulators,
+ * which hides FMA latency; for streaming kernels like brightness it mainly reduces
+ * loop overhead, so the best choice depends on whether data fits in cache.
+ */
+
+// Structure of Arrays layout (as in 02_dot_product)
+struct Vec3Array {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    Vec3Array(size_t size) : x(size), y(size), z(size) {}
+    size_t size() const { return x.size(); }
+};
+
+Vec3Array generateRandomVectors(size_t count, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    Vec3Array result(count);
+    for (size_t i = 0; i < count; i++) {
+        result.x[i] = dist(gen);
+        result.y[i] = dist(gen);
+        result.z[i] = dist(gen);
+    }
+    return result;
+}
+
+// 1. Brightness adjustment - Scalar reference
+void adjust_brightness_scalar(uint8_t* image, int size, int brightness) {
+    for (int i = 0; i < size; i++) {
+        int value = static_cast<int>(image[i]) + brightness;
+        image[i] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+    }
+}
+
+// 1. Brightness adjustment - Specialized by vector width and unroll factor
+// (brightness must be in [0, 255], like adjust_brightness_simd)
+template<int Bits, int Unroll>
+void adjust_brightness_unrolled(uint8_t* image, int size, int brightness) {
+    typedef VecU8<Bits> V;
+    const int lanes = V::lanes;
+    const int step = lanes * Unroll;
+    const typename V::type brightness_vec = V::set1(static_cast<uint8_t>(brightness));
+
+    // Main loop: Unroll vectors per iteration, expanded at compile time
+    int i = 0;
+    for (; i <= size - step; i += step) {
+        static_for<Unroll>([&](auto u) {
+            uint8_t* p = image + i + u * lanes;
+            V::store(p, V::adds(V::load(p), brightness_vec));
+        });
+    }
+
+    // Remaining full vectors
+    for (; i <= size - lanes; i += lanes) {
+        V::store(image + i, V::adds(V::load(image + i), brightness_vec));
+    }
+
+    // Remaining bytes
+    for (; i < size; i++) {
+        int value = static_cast<int>(image[i]) + brightness;
+        image[i] = static_cast<uint8_t>(std::min(255, value));
+    }
+}
+
+// 2. Dot product - Scalar reference
+float dot_product_scalar(const Vec3Array& a, const Vec3Array& b) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) {
+        sum += a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+    }
+    return sum;
+}
+
+// 2. Dot product - Specialized by vector width and unroll factor
+// Each unrolled slot has its own accumulator so the FMA chains are independent.
+template<int Bits, int Unroll>
+float dot_product_unrolled(const Vec3Array& a, const Vec3Array& b) {
+    typedef VecF32<Bits> V;
+    typedef typename V::type vec;
+    const size_t lanes = V::lanes;
+    const size_t step = lanes * Unroll;
+    const size_t size = a.size();
+
+    vec acc[Unroll];
+    static_for<Unroll>([&](auto u) { acc[u] = V::zero(); });
+
+    // Main loop: Unroll independent FMA chains
+    size_t i = 0;
+    for (; i + step <= size; i += step) {
+        static_for<Unroll>([&](auto u) {
+            size_t j = i + u * lanes;
+            vec r = V::fmadd(V::load(&a.x[j]), V::load(&b.x[j]), acc[u]);
+            r = V::fmadd(V::load(&a.y[j]), V::load(&b.y[j]), r);
+            acc[u] = V::fmadd(V::load(&a.z[j]), V::load(&b.z[j]), r);
+        });
+    }
+
+    // Remaining full vectors go into the first accumulator
+    for (; i + lanes <= size; i += lanes) {
+        vec r = V::fmadd(V::load(&a.x[i]), V::load(&b.x[i]), acc[0]);
+        r = V::fmadd(V::load(&a.y[i]), V::load(&b.y[i]), r);
+        acc[0] = V::fmadd(V::load(&a.z[i]), V::load(&b.z[i]), r);
+    }
+
+    // Combine accumulators and reduce horizontally
+    vec sum = acc[0];
+    static_for<Unroll>([&](auto u) {
+        if (u > 0) sum = V::add(sum, acc[u]);
+    });
+    float total = V::hsum(sum);
+
+    // Remaining elements
+    for (; i < size; i++) {
+        total += a.x[i] * b.x[i] + a.y[i] * b.y[i] + a.z[i] * b.z[i];
+    }
+    return total;
+}
+
+// Tables of all specializations we want to compare
+typedef void (*BrightnessFn)(uint8_t*, int, int);
+typedef float (*DotProductFn)(const Vec3Array&, const Vec3Array&);
+
+template<typename Fn>
+struct Variant {
+    const char* name;
+    Fn func;
+};
+
+#define BRIGHTNESS_VARIANT(bits, unroll) \
+    { "w" #bits "/u" #unroll, adjust_brightness_unrolled<bits, unroll> }
+#define DOT_PRODUCT_VARIANT(bits, unroll) \
+    { "w" #bits "/u" #unroll, dot_product_unrolled<bits, unroll> }
+
+const Variant<BrightnessFn> brightness_variants[] = {
+    BRIGHTNESS_VARIANT(128, 1), BRIGHTNESS_VARIANT(128, 4),
+    BRIGHTNESS_VARIANT(256, 1), BRIGHTNESS_VARIANT(256, 2),
+    BRIGHTNESS_VARIANT(256, 4), BRIGHTNESS_VARIANT(256, 8),
+#ifdef __AVX512BW__
+    BRIGHTNESS_VARIANT(512, 1), BRIGHTNESS_VARIANT(512, 2),
+    BRIGHTNESS_VARIANT(512, 4),
+#endif
+};
+
+const Variant<DotProductFn> dot_product_variants[] = {
+    DOT_PRODUCT_VARIANT(128, 1), DOT_PRODUCT_VARIANT(128, 4),
+    DOT_PRODUCT_VARIANT(256, 1), DOT_PRODUCT_VARIANT(256, 2),
+    DOT_PRODUCT_VARIANT(256, 4), DOT_PRODUCT_VARIANT(256, 8),
+#ifdef __AVX512F__
+    DOT_PRODUCT_VARIANT(512, 1), DOT_PRODUCT_VARIANT(512, 2),
+    DOT_PRODUCT_VARIANT(512, 4),
+#endif
+};
+
+// Keep the total amount of work per measurement roughly constant
+int iterations_for(size_t bytes) {
+    return static_cast<int>(std::max<size_t>(5, (size_t(1) << 29) / bytes));
+}
+
+void print_table_header(const char* size_label, size_t variant_count, const char* const* names) {
+    std::cout << std::setw(10) << size_label;
+    for (size_t v = 0; v < variant_count; v++) {
+        std::cout << std::setw(10) << names[v];
+    }
+    std::cout << std::setw(12) << "winner" << std::endl;
+}
+
+// Benchmarks every variant at every size, prints a table of GB/s and
+// records the fastest variant per size in the dispatcher.
+template<typename Fn, size_t N, typename RunFunc>
+SizeDispatcher<Fn> autotune(const Variant<Fn> (&variants)[N], const std::vector<size_t>& sizes,
+                            const char* size_label, size_t bytes_per_element, RunFunc run) {
+    const char* names[N];
+    for (size_t v = 0; v < N; v++) names[v] = variants[v].name;
+    print_table_header(size_label, N, names);
+
+    SizeDispatcher<Fn> dispatcher;
+    for (size_t size : sizes) {
+        size_t bytes = size * bytes_per_element;
+        int iterations = iterations_for(bytes);
+
+        std::cout << std::setw(10) << size;
+        size_t best = 0;
+        double best_time = 0.0;
+        for (size_t v = 0; v < N; v++) {
+            double us = measure_microseconds([&]() { run(variants[v].func, size); }, iterations);
+            double gbps = bytes / (us * 1e3);
+            std::cout << std::setw(10) << std::fixed << std::setprecision(2) << gbps;
+            if (v == 0 || us < best_time) {
+                best = v;
+                best_time = us;
+            }
+        }
+        std::cout << std::setw(12) << variants[best].name << std::endl;
+        dispatcher.add(size, variants[best].func, variants[best].name);
+    }
+    std::cout << "(columns are GB/s)" << std::endl;
+    return dispatcher;
+}
+
+int main() {
+    std::cout << "=== Compile-time Unrolling and Kernel Specialization ===" << std::endl;
+    std::cout << std::endl;
+
+    const size_t brightness_count = sizeof(brightness_variants) / sizeof(brightness_variants[0]);
+    const size_t dot_product_count = sizeof(dot_product_variants) / sizeof(dot_product_variants[0]);
+
+    // --------- 1. static_for -------------
+    std::cout << "1. static_for<N>" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << "Body expanded at compile time with indices: ";
+    static_for<4>([](auto i) {
+        // i is a std::integral_constant, usable in constant expressions
+        static_assert(decltype(i)::value < 4, "index out of range");
+        std::cout << decltype(i)::value << " ";
+    });
+    std::cout << std::endl << std::endl;
+
+    // --------- 2. Correctness -------------
+    std::cout << "2. Correctness of all specializations" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+
+    // Odd size so that both the unrolled, single-vector and scalar tails run
+    const int CHECK_SIZE = 4096 * 3 + 77;
+    std::vector<uint8_t> original(CHECK_SIZE);
+    for (int i = 0; i < CHECK_SIZE; i++) {
+        original[i] = static_cast<uint8_t>((i * 37) & 0xFF);
+    }
+    std::vector<uint8_t> expected(original);
+    adjust_brightness_scalar(expected.data(), CHECK_SIZE, 50);
+
+    bool all_ok = true;
+    for (size_t v = 0; v < brightness_count; v++) {
+        std::vector<uint8_t> image(original);
+        brightness_variants[v].func(image.data(), CHECK_SIZE, 50);
+        bool ok = (image == expected);
+        all_ok = all_ok && ok;
+        std::cout << "Brightness " << std::setw(8) << brightness_variants[v].name << ": "
+                  << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+
+    Vec3Array a = generateRandomVectors(CHECK_SIZE, 1);
+    Vec3Array b = generateRandomVectors(CHECK_SIZE, 2);
+    float reference = dot_product_scalar(a, b);
+    for (size_t v = 0; v < dot_product_count; v++) {
+        float result = dot_product_variants[v].func(a, b);
+        bool ok = std::fabs(result - reference) <= 1e-3f * std::max(1.0f, std::fabs(reference));
+        all_ok = all_ok && ok;
+        std::cout << "Dot product " << std::setw(7) << dot_product_variants[v].name << ": "
+                  << result << " (scalar " << reference << ") " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+    std::cout << std::endl;
+
+    // --------- 3. Autotuning -------------
+    std::cout << "3. Benchmark per size (width/unroll)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+
+    std::vector<size_t> byte_sizes = {4096, 65536, 1 << 20, 16 << 20};
+    std::vector<uint8_t> image(byte_sizes.back());
+    for (size_t i = 0; i < image.size(); i++) {
+        image[i] = static_cast<uint8_t>(i & 0x7F);
+    }
+
+    std::cout << "Brightness adjustment:" << std::endl;
+    SizeDispatcher<BrightnessFn> brightness_dispatcher = autotune(
+        brightness_variants, byte_sizes, "bytes", 1,
+        [&](BrightnessFn fn, size_t size) { fn(image.data(), static_cast<int>(size), 1); });
+    std::cout << std::endl;
+
+    std::vector<size_t> vector_counts = {256, 4096, 65536, 1 << 20};
+    Vec3Array big_a = generateRandomVectors(vector_counts.back(), 3);
+    Vec3Array big_b = generateRandomVectors(vector_counts.back(), 4);
+
+    // Views of the first `count` vectors are the same arrays; the kernel reads
+    // a.size() elements, so we benchmark on correctly-sized copies instead.
+    std::vector<Vec3Array> dot_inputs_a, dot_inputs_b;
+    for (size_t count : vector_counts) {
+        Vec3Array pa(count), pb(count);
+        std::copy(big_a.x.begin(), big_a.x.begin() + count, pa.x.begin());
+        std::copy(big_a.y.begin(), big_a.y.begin() + count, pa.y.begin());
+        std::copy(big_a.z.begin(), big_a.z.begin() + count, pa.z.begin());
+        std::copy(big_b.x.begin(), big_b.x.begin() + count, pb.x.begin());
+        std::copy(big_b.y.begin(), big_b.y.begin() + count, pb.y.begin());
+        std::copy(big_b.z.begin(), big_b.z.begin() + count, pb.z.begin());
+        dot_inputs_a.push_back(pa);
+        dot_inputs_b.push_back(pb);
+    }
+
+    std::cout << "Dot product (SoA):" << std::endl;
+    SizeDispatcher<DotProductFn> dot_dispatcher = autotune(
+        dot_product_variants, vector_counts, "vectors", 6 * sizeof(float),
+        [&](DotProductFn fn, size_t count) {
+            size_t idx = std::find(vector_counts.begin(), vector_counts.end(), count) - vector_counts.begin();
+            volatile float result = fn(dot_inputs_a[idx], dot_inputs_b[idx]);
+            (void)result;
+        });
+    std::cout << std::endl;
+
+    // --------- 4. Dispatch -------------
+    std::cout << "4. Dispatching to the winning specialization" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+
+    const size_t query_bytes[] = {1000, 50000, 300000, 100000000};
+    for (size_t bytes : query_bytes) {
+        std::cout << "Brightness on " << std::setw(9) << bytes << " bytes -> "
+                  << brightness_dispatcher.select(bytes).name << std::endl;
+    }
+
+    const size_t query_vectors[] = {100, 3000, 500000, 10000000};
+    for (size_t count : query_vectors) {
+        std::cout << "Dot product on " << std::setw(8) << count << " vectors -> "
+                  << dot_dispatcher.select(count).name << std::endl;
+    }
+
+    // Use the dispatcher for an actual call
+    std::vector<uint8_t> dispatched(original);
+    brightness_dispatcher.select(dispatched.size()).func(dispatched.data(), CHECK_SIZE, 50);
+    bool dispatched_ok = (dispatched == expected);
+    all_ok = all_ok && dispatched_ok;
+    std::cout << "Dispatched brightness result: " << (dispatched_ok ? "OK" : "MISMATCH") << std::endl;
+
+    return all_ok ? 0 : 1;
+}
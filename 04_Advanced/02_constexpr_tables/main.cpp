@@ -0,0 +1,441 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_tables.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdint>
+
+/**
+ * 04_Advanced/02_constexpr_tables - Compile-time lookup tables for shuffle kernels
+ *
+ * Many SIMD algorithms turn a comparison mask into a shuffle by looking it up in a
+ * precomputed table. Instead of filling those tables at startup, simd_tables.h builds
+ * them with constexpr functions: the compiler evaluates them, the data lands in .rodata
+ * (see `make asm`), and every table starts on a 64-byte cache line.
+ *
+ * We'll use the tables for:
+ * 1. Compile-time checks (static_assert) on the generated data
+ * 2. Stream compaction of floats with _mm256_permutevar8x32_ps
+ * 3. Partitioning floats around a pivot
+ * 4. Removing whitespace from text (pshufb byte compaction + nibble classifier)
+ * 5. Base64 validation (nibble classifier) and decoding (decode table)
+ * 6. UTF-8 validation (lead-byte length table with an ASCII fast path)
+ */
+
+// The tables are ordinary constant expressions
+static_assert(left_pack_permute_table[0x05].index[0] == 0, "lane 0 selected first");
+static_assert(left_pack_permute_table[0x05].index[1] == 2, "lane 2 selected second");
+static_assert(left_pack_permute_table[0x05].index[2] == 1, "unselected lanes follow");
+static_assert(left_pack_shuffle_table[0x80].index[0] == 7, "byte 7 packed to front");
+static_assert(left_pack_shuffle_table[0x80].index[1] == 0x80, "unused bytes are zeroed");
+static_assert(base64_decode_table['/'] == 63, "base64 '/' decodes to 63");
+static_assert(utf8_sequence_length_table[0xE2] == 3, "E2 starts a 3-byte sequence");
+
+// Whitespace classifier generated at compile time for this example
+constexpr bool is_whitespace(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+alignas(64) constexpr NibbleClassifier whitespace_classifier = make_nibble_classifier(is_whitespace);
+static_assert(whitespace_classifier.valid, "whitespace must fit a nibble classifier");
+
+// Loads a 16-byte nibble table into both 128-bit lanes
+inline __m256i broadcast_nibble_table(const uint8_t* table) {
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// Non-zero bytes where the input byte belongs to the classifier's set
+inline __m128i classify_bytes(__m128i v, __m128i lo_table, __m128i hi_table) {
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i lo = _mm_shuffle_epi8(lo_table, _mm_and_si128(v, nibble_mask));
+    __m128i hi = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+    return _mm_and_si128(lo, hi);
+}
+
+inline __m256i classify_bytes(__m256i v, __m256i lo_table, __m256i hi_table) {
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(lo_table, _mm256_and_si256(v, nibble_mask));
+    __m256i hi = _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask));
+    return _mm256_and_si256(lo, hi);
+}
+
+// 2. Stream compaction - Scalar implementation
+size_t compact_greater_scalar(const float* in, size_t n, float threshold, float* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (in[i] > threshold) {
+            out[count++] = in[i];
+        }
+    }
+    return count;
+}
+
+// 2. Stream compaction - SIMD implementation
+// `out` needs room for n + 7 floats, since every step stores a full vector.
+size_t compact_greater_simd(const float* in, size_t n, float threshold, float* out) {
+    __m256 threshold_vec = _mm256_set1_ps(threshold);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(in + i);
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(v, threshold_vec, _CMP_GT_OQ));
+
+        // Move the selected lanes to the front and store the whole vector
+        __m256i perm = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(left_pack_permute_table[mask].index));
+        _mm256_storeu_ps(out + count, _mm256_permutevar8x32_ps(v, perm));
+        count += _mm_popcnt_u32(mask);
+    }
+    for (; i < n; i++) {
+        if (in[i] > threshold) {
+            out[count++] = in[i];
+        }
+    }
+    return count;
+}
+
+// 3. Partition - Scalar implementation
+void partition_scalar(const float* in, size_t n, float pivot,
+                      float* lo_out, size_t& lo_count, float* hi_out, size_t& hi_count) {
+    lo_count = hi_count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (in[i] < pivot) lo_out[lo_count++] = in[i];
+        else hi_out[hi_count++] = in[i];
+    }
+}
+
+// 3. Partition - SIMD implementation
+// Both outputs need 7 floats of slack, as in compact_greater_simd.
+void partition_simd(const float* in, size_t n, float pivot,
+                    float* lo_out, size_t& lo_count, float* hi_out, size_t& hi_count) {
+    __m256 pivot_vec = _mm256_set1_ps(pivot);
+    lo_count = hi_count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(in + i);
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(v, pivot_vec, _CMP_LT_OQ));
+
+        __m256i lo_perm = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(left_pack_permute_table[mask].index));
+        __m256i hi_perm = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(left_pack_permute_table[mask ^ 0xFF].index));
+        _mm256_storeu_ps(lo_out + lo_count, _mm256_permutevar8x32_ps(v, lo_perm));
+        _mm256_storeu_ps(hi_out + hi_count, _mm256_permutevar8x32_ps(v, hi_perm));
+
+        int lo_n = _mm_popcnt_u32(mask);
+        lo_count += lo_n;
+        hi_count += 8 - lo_n;
+    }
+    for (; i < n; i++) {
+        if (in[i] < pivot) lo_out[lo_count++] = in[i];
+        else hi_out[hi_count++] = in[i];
+    }
+}
+
+// 4. Whitespace removal - Scalar implementation
+size_t remove_whitespace_scalar(const char* in, size_t n, char* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!is_whitespace(static_cast<uint8_t>(in[i]))) {
+            out[count++] = in[i];
+        }
+    }
+    return count;
+}
+
+// 4. Whitespace removal - SIMD implementation (16 bytes per iteration)
+// `out` needs 7 bytes of slack, since each half stores 8 bytes.
+size_t remove_whitespace_simd(const char* in, size_t n, char* out) {
+    const __m128i lo_table = _mm_load_si128(reinterpret_cast<const __m128i*>(whitespace_classifier.lo));
+    const __m128i hi_table = _mm_load_si128(reinterpret_cast<const __m128i*>(whitespace_classifier.hi));
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i keep_bytes = _mm_cmpeq_epi8(classify_bytes(v, lo_table, hi_table), zero);
+        int keep = _mm_movemask_epi8(keep_bytes);
+
+        // Compact each 8-byte half with one table lookup
+        int keep_lo = keep & 0xFF;
+        int keep_hi = (keep >> 8) & 0xFF;
+        __m128i shuf_lo = _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(left_pack_shuffle_table[keep_lo].index));
+        __m128i shuf_hi = _mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(left_pack_shuffle_table[keep_hi].index));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(v, shuf_lo));
+        count += _mm_popcnt_u32(keep_lo);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + count),
+                         _mm_shuffle_epi8(_mm_srli_si128(v, 8), shuf_hi));
+        count += _mm_popcnt_u32(keep_hi);
+    }
+    return count + remove_whitespace_scalar(in + i, n - i, out + count);
+}
+
+// 5. Base64 validation - Scalar implementation
+bool is_base64_scalar(const char* s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (base64_decode_table[static_cast<uint8_t>(s[i])] == 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 5. Base64 validation - SIMD implementation (32 bytes per iteration)
+bool is_base64_simd(const char* s, size_t n) {
+    const __m256i lo_table = broadcast_nibble_table(base64_classifier.lo);
+    const __m256i hi_table = broadcast_nibble_table(base64_classifier.hi);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m256i invalid = _mm256_cmpeq_epi8(classify_bytes(v, lo_table, hi_table), zero);
+        if (!_mm256_testz_si256(invalid, invalid)) {
+            return false;
+        }
+    }
+    return is_base64_scalar(s + i, n - i);
+}
+
+// 5. Base64 decoding with the decode table (input without padding)
+std::string base64_decode(const std::string& in) {
+    std::string out;
+    uint32_t bits = 0;
+    int bit_count = 0;
+    for (char c : in) {
+        uint8_t value = base64_decode_table[static_cast<uint8_t>(c)];
+        if (value == 0xFF) break;
+        bits = (bits << 6) | value;
+        bit_count += 6;
+        if (bit_count >= 8) {
+            bit_count -= 8;
+            out.push_back(static_cast<char>((bits >> bit_count) & 0xFF));
+        }
+    }
+    return out;
+}
+
+std::string base64_encode(const std::string& in) {
+    std::string out;
+    uint32_t bits = 0;
+    int bit_count = 0;
+    for (char c : in) {
+        bits = (bits << 8) | static_cast<uint8_t>(c);
+        bit_count += 8;
+        while (bit_count >= 6) {
+            bit_count -= 6;
+            out.push_back(base64_encode_table[(bits >> bit_count) & 0x3F]);
+        }
+    }
+    if (bit_count > 0) {
+        out.push_back(base64_encode_table[(bits << (6 - bit_count)) & 0x3F]);
+    }
+    return out;
+}
+
+// 6. UTF-8 validation - Scalar, table-driven
+bool is_utf8_scalar(const uint8_t* s, size_t n, size_t start = 0) {
+    size_t i = start;
+    while (i < n) {
+        uint8_t lead = s[i];
+        int length = utf8_sequence_length_table[lead];
+        if (length == 0 || i + length > n) return false;
+
+        // Continuation bytes must be 10xxxxxx
+        for (int k = 1; k < length; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return false;
+        }
+
+        // Reject overlong 3/4-byte forms, surrogates and code points above U+10FFFF
+        if (length >= 3) {
+            uint8_t second = s[i + 1];
+            if ((lead == 0xE0 && second < 0xA0) || (lead == 0xED && second > 0x9F) ||
+                (lead == 0xF0 && second < 0x90) || (lead == 0xF4 && second > 0x8F)) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+// 6. UTF-8 validation - Skips ASCII runs 32 bytes at a time
+bool is_utf8_simd(const uint8_t* s, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        // ASCII fast path: no byte has its top bit set
+        while (i + 32 <= n) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+            if (_mm256_movemask_epi8(v) != 0) break;
+            i += 32;
+        }
+        if (i + 32 > n) {
+            return is_utf8_scalar(s, n, i);
+        }
+
+        // Validate the multi-byte sequences in this block with the table
+        size_t block_end = i + 32;
+        while (i < block_end) {
+            int length = utf8_sequence_length_table[s[i]];
+            if (length == 0 || i + length > n) return false;
+            if (length > 1 && !is_utf8_scalar(s, i + length, i)) return false;
+            i += length;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+bool is_aligned64(const T& table) {
+    return reinterpret_cast<uintptr_t>(&table) % 64 == 0;
+}
+
+int main() {
+    std::cout << "=== Compile-time Lookup Tables ===" << std::endl;
+    std::cout << std::endl;
+
+    // --------- 1. Table properties -------------
+    std::cout << "1. Generated tables" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << "left_pack_permute_table:    " << sizeof(left_pack_permute_table) << " bytes, 64-byte aligned: "
+              << (is_aligned64(left_pack_permute_table) ? "yes" : "no") << std::endl;
+    std::cout << "left_pack_shuffle_table:    " << sizeof(left_pack_shuffle_table) << " bytes, 64-byte aligned: "
+              << (is_aligned64(left_pack_shuffle_table) ? "yes" : "no") << std::endl;
+    std::cout << "base64_decode_table:        " << sizeof(base64_decode_table) << " bytes, 64-byte aligned: "
+              << (is_aligned64(base64_decode_table) ? "yes" : "no") << std::endl;
+    std::cout << "utf8_sequence_length_table: " << sizeof(utf8_sequence_length_table) << " bytes, 64-byte aligned: "
+              << (is_aligned64(utf8_sequence_length_table) ? "yes" : "no") << std::endl;
+
+    std::cout << "Permutation for mask 0b00100110: [";
+    for (int k = 0; k < 8; k++) {
+        std::cout << left_pack_permute_table[0x26].index[k] << (k < 7 ? ", " : "]");
+    }
+    std::cout << std::endl << std::endl;
+
+    bool all_ok = true;
+    const size_t N = 1 << 20;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> data(N);
+    for (size_t i = 0; i < N; i++) {
+        data[i] = dist(gen);
+    }
+
+    // --------- 2. Compaction -------------
+    std::cout << "2. Stream compaction (keep x > 0.25)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<float> out_scalar(N + 8), out_simd(N + 8);
+    size_t n_scalar = compact_greater_scalar(data.data(), N, 0.25f, out_scalar.data());
+    size_t n_simd = compact_greater_simd(data.data(), N, 0.25f, out_simd.data());
+    bool compact_ok = n_scalar == n_simd &&
+                      std::equal(out_scalar.begin(), out_scalar.begin() + n_scalar, out_simd.begin());
+    all_ok = all_ok && compact_ok;
+    std::cout << "Kept " << n_simd << " of " << N << " values: " << (compact_ok ? "OK" : "MISMATCH") << std::endl;
+
+    benchmark_comparison("Compaction",
+        [&]() { compact_greater_scalar(data.data(), N, 0.25f, out_scalar.data()); },
+        [&]() { compact_greater_simd(data.data(), N, 0.25f, out_simd.data()); },
+        100);
+    std::cout << std::endl;
+
+    // --------- 3. Partition -------------
+    std::cout << "3. Partition around pivot 0.0" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<float> lo_scalar(N + 8), hi_scalar(N + 8), lo_simd(N + 8), hi_simd(N + 8);
+    size_t lo_n1, hi_n1, lo_n2, hi_n2;
+    partition_scalar(data.data(), N, 0.0f, lo_scalar.data(), lo_n1, hi_scalar.data(), hi_n1);
+    partition_simd(data.data(), N, 0.0f, lo_simd.data(), lo_n2, hi_simd.data(), hi_n2);
+    bool partition_ok = lo_n1 == lo_n2 && hi_n1 == hi_n2 &&
+                        std::equal(lo_scalar.begin(), lo_scalar.begin() + lo_n1, lo_simd.begin()) &&
+                        std::equal(hi_scalar.begin(), hi_scalar.begin() + hi_n1, hi_simd.begin());
+    all_ok = all_ok && partition_ok;
+    std::cout << "Low: " << lo_n2 << ", high: " << hi_n2 << ": " << (partition_ok ? "OK" : "MISMATCH") << std::endl;
+
+    benchmark_comparison("Partition",
+        [&]() { partition_scalar(data.data(), N, 0.0f, lo_scalar.data(), lo_n1, hi_scalar.data(), hi_n1); },
+        [&]() { partition_simd(data.data(), N, 0.0f, lo_simd.data(), lo_n2, hi_simd.data(), hi_n2); },
+        100);
+    std::cout << std::endl;
+
+    // --------- 4. Whitespace removal -------------
+    std::cout << "4. Whitespace removal" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    const std::string sample = "  SIMD\tlookup tables\r\nare built   at compile time.  ";
+    std::string compacted(sample.size() + 8, '\0');
+    compacted.resize(remove_whitespace_simd(sample.data(), sample.size(), &compacted[0]));
+    std::cout << "Input:  \"" << "  SIMD\\tlookup tables\\r\\nare built   at compile time.  " << "\"" << std::endl;
+    std::cout << "Output: \"" << compacted << "\"" << std::endl;
+
+    std::string text(N, ' ');
+    const char alphabet[] = "abcdefgh ijklmnop\tqrstuvwx\nyz";
+    for (size_t i = 0; i < N; i++) {
+        text[i] = alphabet[gen() % (sizeof(alphabet) - 1)];
+    }
+    std::vector<char> text_scalar(N + 8), text_simd(N + 8);
+    size_t t1 = remove_whitespace_scalar(text.data(), N, text_scalar.data());
+    size_t t2 = remove_whitespace_simd(text.data(), N, text_simd.data());
+    bool text_ok = t1 == t2 && std::equal(text_scalar.begin(), text_scalar.begin() + t1, text_simd.begin());
+    all_ok = all_ok && text_ok;
+    std::cout << "Random text: " << N << " -> " << t2 << " bytes: " << (text_ok ? "OK" : "MISMATCH") << std::endl;
+
+    benchmark_comparison("Whitespace Removal",
+        [&]() { remove_whitespace_scalar(text.data(), N, text_scalar.data()); },
+        [&]() { remove_whitespace_simd(text.data(), N, text_simd.data()); },
+        100);
+    std::cout << std::endl;
+
+    // --------- 5. Base64 -------------
+    std::cout << "5. Base64 validation and decoding" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::string encoded = base64_encode("Hello, SIMD lookup tables!");
+    std::cout << "Encoded: " << encoded << std::endl;
+    std::cout << "Decoded: " << base64_decode(encoded) << std::endl;
+
+    std::string b64(N, 'A');
+    for (size_t i = 0; i < N; i++) {
+        b64[i] = base64_encode_table[gen() & 0x3F];
+    }
+    std::string b64_bad = b64;
+    b64_bad[N - 100] = '-';
+    bool b64_ok = is_base64_simd(b64.data(), N) && !is_base64_simd(b64_bad.data(), N) &&
+                  is_base64_scalar(b64.data(), N) && !is_base64_scalar(b64_bad.data(), N);
+    all_ok = all_ok && b64_ok;
+    std::cout << "Valid / corrupted input detected: " << (b64_ok ? "OK" : "MISMATCH") << std::endl;
+
+    benchmark_comparison("Base64 Validation",
+        [&]() { volatile bool r = is_base64_scalar(b64.data(), N); (void)r; },
+        [&]() { volatile bool r = is_base64_simd(b64.data(), N); (void)r; },
+        100);
+    std::cout << std::endl;
+
+    // --------- 6. UTF-8 -------------
+    std::cout << "6. UTF-8 validation" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    // Mostly ASCII text with occasional 2-, 3- and 4-byte sequences
+    const char* pieces[] = {"plain ascii text, ", "caf\xC3\xA9 ", "\xE2\x82\xAC""5 ", "\xF0\x9F\x98\x80 "};
+    std::string utf8;
+    while (utf8.size() < N) {
+        uint32_t r = gen() % 16;
+        utf8 += pieces[r < 13 ? 0 : r - 12];
+    }
+    std::string utf8_bad = utf8;
+    utf8_bad[utf8.size() / 2] = static_cast<char>(0xC0);  // never valid
+    const uint8_t* u = reinterpret_cast<const uint8_t*>(utf8.data());
+    const uint8_t* ub = reinterpret_cast<const uint8_t*>(utf8_bad.data());
+    bool utf8_ok = is_utf8_simd(u, utf8.size()) && is_utf8_scalar(u, utf8.size()) &&
+                   !is_utf8_simd(ub, utf8_bad.size()) && !is_utf8_scalar(ub, utf8_bad.size());
+    all_ok = all_ok && utf8_ok;
+    std::cout << "Valid / corrupted input detected: " << (utf8_ok ? "OK" : "MISMATCH") << std::endl;
+
+    benchmark_comparison("UTF-8 Validation",
+        [&]() { volatile bool r = is_utf8_scalar(u, utf8.size()); (void)r; },
+        [&]() { volatile bool r = is_utf8_simd(u, utf8.size()); (void)r; },
+        100);
+
+    return all_ok ? 0 : 1;
+}
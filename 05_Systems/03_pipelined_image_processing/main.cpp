@@ -0,0 +1,319 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_ring.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+/**
+ * 05_Systems/03_pipelined_image_processing - Pipeline stages connected by lock-free rings
+ *
+ * 04_image_processing runs each kernel over one frame at a time on one core. A video
+ * pipeline processes a sequence of frames, and its stages can run on separate cores:
+ *
+ *   decode (PPM) -> brightness -> grayscale -> encode (PGM)
+ *
+ * Frames live in a fixed pool; stages pass 32-bit frame handles through the ring
+ * buffers from simd_ring.h, in batches. The grayscale stage is the slowest, so it can
+ * run on several workers fed by an MPMC ring.
+ *
+ * We'll:
+ * 1. Measure the ring buffers themselves (single vs batched, SPSC vs MPMC)
+ * 2. Time each stage, then compare serial vs pipelined frames/s
+ */
+
+const int WIDTH = 1024;
+const int HEIGHT = 768;
+const int FRAME_BYTES = WIDTH * HEIGHT * RGB_CHANNELS;
+const int GRAY_BYTES = WIDTH * HEIGHT;
+const int FRAME_COUNT = 200;
+const int POOL_SIZE = 8;
+const size_t BATCH = 4;
+const uint32_t END_OF_STREAM = 0xFFFFFFFFu;
+
+struct Frame {
+    uint8_t* rgb;
+    uint8_t* gray;
+    int id;
+};
+
+// Sum of all bytes, used to check that every frame was processed once
+uint64_t byte_sum(const uint8_t* data, size_t size) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < size; i++) sum += data[i];
+    return sum;
+}
+
+// Encoded input frames (binary PPM)
+std::vector<std::string> make_source_frames(int count) {
+    std::vector<std::string> frames;
+    std::vector<uint8_t> image(FRAME_BYTES);
+    for (int f = 0; f < count; f++) {
+        initialize_test_image(image.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+        for (int i = 0; i < FRAME_BYTES; i += 7) {
+            image[i] = static_cast<uint8_t>(image[i] + f * 13);
+        }
+        std::string ppm = "P6\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n255\n";
+        ppm.append(reinterpret_cast<const char*>(image.data()), FRAME_BYTES);
+        frames.push_back(ppm);
+    }
+    return frames;
+}
+
+// Stage 1: decode a PPM into the frame's RGB buffer
+void decode_stage(const std::string& ppm, Frame& frame) {
+    // Header is "P6\n<w> <h>\n255\n"; skip three newlines
+    size_t pos = 0;
+    for (int lines = 0; lines < 3; lines++) {
+        pos = ppm.find('\n', pos) + 1;
+    }
+    std::memcpy(frame.rgb, ppm.data() + pos, FRAME_BYTES);
+}
+
+// Stage 2 and 3: the SIMD kernels from simd_image.h
+void brightness_stage(Frame& frame) {
+    adjust_brightness_simd(frame.rgb, FRAME_BYTES, 30);
+}
+
+void grayscale_stage(Frame& frame) {
+    convert_to_grayscale_simd(frame.rgb, frame.gray, WIDTH, HEIGHT);
+}
+
+// Stage 4: encode the grayscale frame as PGM; returns its checksum
+uint64_t encode_stage(const Frame& frame, std::string& out) {
+    out = "P5\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n255\n";
+    out.append(reinterpret_cast<const char*>(frame.gray), GRAY_BYTES);
+    return byte_sum(frame.gray, GRAY_BYTES);
+}
+
+// All four stages per frame on the calling thread
+uint64_t run_serial(std::vector<Frame>& pool, const std::vector<std::string>& sources) {
+    uint64_t checksum = 0;
+    std::string encoded;
+    for (int f = 0; f < FRAME_COUNT; f++) {
+        Frame& frame = pool[f % POOL_SIZE];
+        frame.id = f;
+        decode_stage(sources[f % sources.size()], frame);
+        brightness_stage(frame);
+        grayscale_stage(frame);
+        checksum += encode_stage(frame, encoded);
+    }
+    return checksum;
+}
+
+// One thread per stage, `gray_workers` threads for grayscale
+uint64_t run_pipelined(std::vector<Frame>& pool, const std::vector<std::string>& sources, int gray_workers) {
+    SpscRing<uint32_t> free_frames(POOL_SIZE);  // encoder -> decoder
+    SpscRing<uint32_t> decoded(POOL_SIZE);      // decoder -> brightness
+    MpmcRing<uint32_t> brightened(POOL_SIZE);   // brightness -> grayscale workers
+    MpmcRing<uint32_t> converted(POOL_SIZE);    // grayscale workers -> encoder
+
+    for (uint32_t i = 0; i < POOL_SIZE; i++) {
+        free_frames.push(i);
+    }
+
+    std::thread decoder([&]() {
+        for (int f = 0; f < FRAME_COUNT; f++) {
+            uint32_t handle = free_frames.pop();
+            pool[handle].id = f;
+            decode_stage(sources[f % sources.size()], pool[handle]);
+            decoded.push(handle);
+        }
+        decoded.push(END_OF_STREAM);
+    });
+
+    std::thread brightness([&]() {
+        uint32_t batch[BATCH];
+        Backoff backoff;
+        for (;;) {
+            size_t n = decoded.pop_batch(batch, BATCH);
+            if (n == 0) {
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+            for (size_t i = 0; i < n; i++) {
+                if (batch[i] == END_OF_STREAM) {
+                    for (int w = 0; w < gray_workers; w++) brightened.push(END_OF_STREAM);
+                    return;
+                }
+                brightness_stage(pool[batch[i]]);
+                brightened.push(batch[i]);
+            }
+        }
+    });
+
+    std::vector<std::thread> grayscale;
+    for (int w = 0; w < gray_workers; w++) {
+        grayscale.emplace_back([&]() {
+            for (;;) {
+                uint32_t handle = brightened.pop();
+                if (handle == END_OF_STREAM) {
+                    converted.push(END_OF_STREAM);
+                    return;
+                }
+                grayscale_stage(pool[handle]);
+                converted.push(handle);
+            }
+        });
+    }
+
+    // Encoder runs on the calling thread
+    uint64_t checksum = 0;
+    std::string encoded;
+    uint32_t batch[BATCH];
+    int finished_workers = 0;
+    Backoff backoff;
+    while (finished_workers < gray_workers) {
+        size_t n = converted.pop_batch(batch, BATCH);
+        if (n == 0) {
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i] == END_OF_STREAM) {
+                finished_workers++;
+                continue;
+            }
+            checksum += encode_stage(pool[batch[i]], encoded);
+            free_frames.push(batch[i]);
+        }
+    }
+
+    decoder.join();
+    brightness.join();
+    for (std::thread& t : grayscale) t.join();
+    return checksum;
+}
+
+// Moves `count` integers from one thread to another through the ring; clears
+// `ok` if the values that arrived do not add up
+template<typename Ring>
+double ring_throughput(size_t count, size_t batch_size, bool& ok) {
+    Ring ring(1024);
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&]() {
+        std::vector<uint32_t> values(batch_size);
+        Backoff backoff;
+        for (size_t sent = 0; sent < count;) {
+            size_t n = std::min(batch_size, count - sent);
+            for (size_t i = 0; i < n; i++) values[i] = static_cast<uint32_t>(sent + i);
+            size_t pushed = ring.push_batch(values.data(), n);
+            if (pushed == 0) {
+                backoff.pause();
+            } else {
+                backoff.reset();
+            }
+            sent += pushed;
+            // values not pushed are regenerated from `sent` on the next iteration
+        }
+    });
+
+    std::vector<uint32_t> values(batch_size);
+    uint64_t sum = 0;
+    Backoff backoff;
+    for (size_t received = 0; received < count;) {
+        size_t n = ring.pop_batch(values.data(), batch_size);
+        if (n == 0) {
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+        for (size_t i = 0; i < n; i++) sum += values[i];
+        received += n;
+    }
+    producer.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t expected = static_cast<uint64_t>(count) * (count - 1) / 2;
+    if (sum != expected) {
+        std::cout << "ring transfer MISMATCH" << std::endl;
+        ok = false;
+    }
+    return count / seconds / 1e6;
+}
+
+int main() {
+    std::cout << "=== Pipelined Image Processing with Lock-free Rings ===" << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+
+    // --------- 1. Ring buffers -------------
+    std::cout << "1. Ring buffer throughput (2 threads, 4M handles)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    const size_t TRANSFERS = 4 << 20;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "SPSC, single push/pop: " << ring_throughput<SpscRing<uint32_t>>(TRANSFERS, 1, all_ok) << " M/s" << std::endl;
+    std::cout << "SPSC, batches of 32:   " << ring_throughput<SpscRing<uint32_t>>(TRANSFERS, 32, all_ok) << " M/s" << std::endl;
+    std::cout << "MPMC, single push/pop: " << ring_throughput<MpmcRing<uint32_t>>(TRANSFERS, 1, all_ok) << " M/s" << std::endl;
+    std::cout << "MPMC, batches of 32:   " << ring_throughput<MpmcRing<uint32_t>>(TRANSFERS, 32, all_ok) << " M/s" << std::endl;
+    std::cout << std::endl;
+
+    // Frame pool
+    std::vector<Frame> pool(POOL_SIZE);
+    for (Frame& frame : pool) {
+        frame.rgb = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+        frame.gray = aligned_alloc<uint8_t>(GRAY_BYTES, 64);
+    }
+    std::vector<std::string> sources = make_source_frames(4);
+
+    // --------- 2. Stage costs -------------
+    std::cout << "2. Per-frame stage cost (" << WIDTH << "x" << HEIGHT << " RGB)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::string encoded;
+    double decode_us = measure_microseconds([&]() { decode_stage(sources[0], pool[0]); }, 20);
+    double brightness_us = measure_microseconds([&]() { brightness_stage(pool[0]); }, 20);
+    double grayscale_us = measure_microseconds([&]() { grayscale_stage(pool[0]); }, 20);
+    double encode_us = measure_microseconds([&]() { encode_stage(pool[0], encoded); }, 20);
+    std::cout << std::setprecision(0);
+    std::cout << "decode:     " << std::setw(7) << decode_us << " us" << std::endl;
+    std::cout << "brightness: " << std::setw(7) << brightness_us << " us" << std::endl;
+    std::cout << "grayscale:  " << std::setw(7) << grayscale_us << " us" << std::endl;
+    std::cout << "encode:     " << std::setw(7) << encode_us << " us" << std::endl;
+    std::cout << std::endl;
+
+    // --------- 3. Serial vs pipelined -------------
+    std::cout << "3. Serial vs pipelined (" << FRAME_COUNT << " frames)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    uint64_t serial_checksum = 0;
+    auto serial_start = std::chrono::steady_clock::now();
+    serial_checksum = run_serial(pool, sources);
+    double serial_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - serial_start).count();
+    std::cout << std::setprecision(1);
+    std::cout << "Serial:                   " << std::setw(8) << FRAME_COUNT / serial_s << " frames/s" << std::endl;
+
+    const int worker_counts[] = {1, 2, 3};
+    for (int workers : worker_counts) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t checksum = run_pipelined(pool, sources, workers);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool ok = checksum == serial_checksum;
+        all_ok = all_ok && ok;
+        std::cout << "Pipelined, " << workers << " gray worker(s): " << std::setw(8) << FRAME_COUNT / seconds
+                  << " frames/s  (" << std::setprecision(2) << serial_s / seconds << "x, "
+                  << (ok ? "OK" : "MISMATCH") << ")" << std::setprecision(1) << std::endl;
+    }
+
+    for (Frame& frame : pool) {
+        free(frame.rgb);
+        free(frame.gray);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,605 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * 05_Systems/04_image_server - Image processing service on a Unix domain socket
+ *
+ * Runs the 04_image_processing kernels as a long-lived daemon. Frames are never
+ * copied through the socket:
+ * - A client creates a memfd, maps it, and passes the descriptor to the server once
+ *   (SCM_RIGHTS over a SOCK_SEQPACKET socket). Both processes map the same pages.
+ *   The memfd must be sealed against shrinking (F_SEAL_SHRINK) and the server
+ *   checks its size itself, so a client cannot make the server's accesses run
+ *   past the end of the file (SIGBUS).
+ * - For each frame the client writes RGB pixels into the shared buffer and sends a
+ *   small request naming an op chain (brightness, contrast, grayscale).
+ * - The server runs the SIMD kernels in place and replies with the offset and size
+ *   of the result inside the same buffer, which the client reads directly.
+ *
+ * Usage:
+ *   ./simd_program                           demo: starts a server, runs the load generator
+ *   ./simd_program server [socket]           run the daemon
+ *   ./simd_program client [socket] [connections] [frames] [width] [height]
+ *   ./simd_program stop [socket]             ask the daemon to exit
+ */
+
+const char* DEFAULT_SOCKET = "/tmp/simd_image_server.sock";
+
+enum MessageType : uint32_t {
+    MSG_ATTACH = 1,    // carries the memfd; width/height/buffer_size describe it
+    MSG_PROCESS = 2,   // run ops[0..op_count) on the attached buffer
+    MSG_SHUTDOWN = 3,  // stop the server
+};
+
+enum OpCode : uint32_t {
+    OP_BRIGHTNESS = 1,  // param: brightness offset (0..255)
+    OP_CONTRAST = 2,    // param: contrast factor (finite, >= 0)
+    OP_GRAYSCALE = 3,   // RGB -> gray; later ops work on the gray plane
+};
+
+struct Op {
+    uint32_t code;
+    float param;
+};
+
+const int MAX_OPS = 8;
+// Largest accepted frame side; keeps every size below 2^31 for the int-sized kernels
+const int MAX_FRAME_SIDE = 16384;
+
+struct Request {
+    uint32_t type;
+    uint32_t seq;
+    int32_t width;
+    int32_t height;
+    uint64_t buffer_size;
+    uint32_t op_count;
+    Op ops[MAX_OPS];
+};
+
+struct Response {
+    uint32_t seq;
+    int32_t status;  // 0 or an errno value
+    uint64_t offset;
+    uint64_t size;
+    int32_t channels;
+};
+
+// Shared buffer layout: RGB frame, then the gray plane on the next cache line
+size_t gray_offset(int width, int height) {
+    return (static_cast<size_t>(width) * height * RGB_CHANNELS + 63) & ~size_t(63);
+}
+
+size_t shared_buffer_size(int width, int height) {
+    return gray_offset(width, height) + static_cast<size_t>(width) * height;
+}
+
+bool frame_size_valid(int width, int height) {
+    return width > 0 && height > 0 && width <= MAX_FRAME_SIDE && height <= MAX_FRAME_SIDE;
+}
+
+// ---------------------------------------------------------------------------
+// Socket helpers
+// ---------------------------------------------------------------------------
+
+sockaddr_un make_address(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+// Sends one message, optionally passing a file descriptor with it
+bool send_message(int sock, const void* data, size_t size, int fd = -1) {
+    iovec iov;
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = size;
+
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    if (fd >= 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    ssize_t n;
+    do {
+        n = sendmsg(sock, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return n == static_cast<ssize_t>(size);
+}
+
+// Receives one message; returns its size (0 on disconnect, -1 on error).
+// A passed descriptor is stored in *fd, otherwise *fd is -1.
+// Returns the message length, 0 when the peer closed, or -1 with errno set;
+// a record larger than `size`, or with truncated control data, fails with EMSGSIZE
+ssize_t receive_message(int sock, void* data, size_t size, int* fd = nullptr) {
+    iovec iov;
+    iov.iov_base = data;
+    iov.iov_len = size;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+
+    int received_fd = -1;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); n > 0 && cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            std::memcpy(&received_fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    if (n > 0 && (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+        if (received_fd >= 0) close(received_fd);
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (fd) {
+        *fd = received_fd;
+    } else if (received_fd >= 0) {
+        close(received_fd);
+    }
+    return n;
+}
+
+int connect_to(const std::string& path) {
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (sock < 0) return -1;
+    sockaddr_un addr = make_address(path);
+    if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// ---------------------------------------------------------------------------
+// Server
+// ---------------------------------------------------------------------------
+
+// Applies the op chain in place; returns 0 or an errno value. The frame size
+// must pass frame_size_valid, so the byte counts fit the kernels' int sizes.
+int apply_ops(uint8_t* buffer, int width, int height, const Op* ops, uint32_t op_count,
+              uint64_t& out_offset, uint64_t& out_size, int& out_channels) {
+    if (!frame_size_valid(width, height)) return EINVAL;
+    uint8_t* rgb = buffer;
+    uint8_t* gray = buffer + gray_offset(width, height);
+    uint8_t* current = rgb;
+    int channels = RGB_CHANNELS;
+    const int pixels = width * height;
+
+    // Parameters come from the client: reject the whole chain before touching the frame
+    for (uint32_t i = 0; i < op_count; i++) {
+        float param = ops[i].param;
+        if (ops[i].code == OP_BRIGHTNESS && !(param >= 0.0f && param <= 255.0f)) return EINVAL;
+        if (ops[i].code == OP_CONTRAST && !(std::isfinite(param) && param >= 0.0f)) return EINVAL;
+    }
+
+    for (uint32_t i = 0; i < op_count; i++) {
+        switch (ops[i].code) {
+            case OP_BRIGHTNESS:
+                adjust_brightness_simd(current, pixels * channels, static_cast<int>(ops[i].param));
+                break;
+            case OP_CONTRAST:
+                enhance_contrast_simd(current, pixels * channels, ops[i].param);
+                break;
+            case OP_GRAYSCALE:
+                if (channels != RGB_CHANNELS) return EINVAL;
+                convert_to_grayscale_simd(rgb, gray, width, height);
+                current = gray;
+                channels = 1;
+                break;
+            default:
+                return EINVAL;
+        }
+    }
+
+    out_offset = static_cast<uint64_t>(current - buffer);
+    out_size = static_cast<uint64_t>(pixels) * channels;
+    out_channels = channels;
+    return 0;
+}
+
+class ImageServer {
+public:
+    explicit ImageServer(const std::string& path) : path(path), listen_fd(-1), stopping(false) {}
+
+    // Accepts clients until a MSG_SHUTDOWN arrives; returns 0 on clean exit
+    int run() {
+        unlink(path.c_str());
+        listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        sockaddr_un addr = make_address(path);
+        if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listen_fd, 64) != 0) {
+            std::cerr << "server: cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+
+        // Sessions run detached and remove themselves from `live` when they end
+        while (!stopping.load()) {
+            int client = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                if (errno == EINTR) continue;
+                break;  // listen socket shut down
+            }
+            {
+                std::lock_guard<std::mutex> lock(sessions_mutex);
+                live.insert(client);
+            }
+            std::thread(&ImageServer::serve, this, client).detach();
+        }
+
+        // Wake sessions blocked in recvmsg for idle clients, then wait for all
+        // of them to finish before the server object goes away
+        {
+            std::unique_lock<std::mutex> lock(sessions_mutex);
+            for (int sock : live) shutdown(sock, SHUT_RDWR);
+            sessions_done.wait(lock, [this]() { return live.empty(); });
+        }
+        close(listen_fd);
+        unlink(path.c_str());
+        return 0;
+    }
+
+private:
+    // One thread per connection: requests on a connection are sequential
+    void serve(int sock) {
+        uint8_t* buffer = nullptr;
+        size_t buffer_size = 0;
+        int width = 0, height = 0;
+
+        Request request;
+        for (;;) {
+            int fd = -1;
+            std::memset(&request, 0, sizeof(request));
+            ssize_t n = receive_message(sock, &request, sizeof(request), &fd);
+            bool truncated = n < 0 && errno == EMSGSIZE;
+            if (n <= 0 && !truncated) break;
+
+            if (truncated || n != static_cast<ssize_t>(sizeof(request))) {
+                // Short or oversized (truncated) message: nothing in it can be trusted
+                if (fd >= 0) close(fd);
+                Response response = {request.seq, EINVAL, 0, 0, 0};
+                send_message(sock, &response, sizeof(response));
+            } else if (request.type == MSG_ATTACH) {
+                if (buffer) munmap(buffer, buffer_size);
+                buffer = nullptr;
+                if (fd >= 0 && frame_size_valid(request.width, request.height) && memfd_usable(fd,
+                        shared_buffer_size(request.width, request.height))) {
+                    // Map only what the frame needs, whatever size the client claims
+                    size_t needed = shared_buffer_size(request.width, request.height);
+                    void* ptr = mmap(nullptr, needed, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                    if (ptr != MAP_FAILED) {
+                        buffer = static_cast<uint8_t*>(ptr);
+                        buffer_size = needed;
+                        width = request.width;
+                        height = request.height;
+                    }
+                }
+                if (fd >= 0) close(fd);  // the mapping keeps the memory alive
+
+                Response response = {request.seq, buffer ? 0 : EINVAL, 0, 0, 0};
+                send_message(sock, &response, sizeof(response));
+            } else if (request.type == MSG_PROCESS) {
+                if (fd >= 0) close(fd);
+                Response response = {request.seq, 0, 0, 0, 0};
+                if (!buffer || request.op_count > MAX_OPS) {
+                    response.status = EINVAL;
+                } else {
+                    response.status = apply_ops(buffer, width, height, request.ops, request.op_count,
+                                                response.offset, response.size, response.channels);
+                }
+                send_message(sock, &response, sizeof(response));
+            } else if (request.type == MSG_SHUTDOWN) {
+                if (fd >= 0) close(fd);
+                stopping.store(true);
+                shutdown(listen_fd, SHUT_RDWR);  // wakes up accept()
+                break;
+            } else {
+                if (fd >= 0) close(fd);
+                Response response = {request.seq, EINVAL, 0, 0, 0};
+                send_message(sock, &response, sizeof(response));
+            }
+        }
+
+        if (buffer) munmap(buffer, buffer_size);
+        // Closed under the lock, so run() never shuts down a reused descriptor
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        close(sock);
+        live.erase(sock);
+        sessions_done.notify_all();
+    }
+
+    // The shared file must be at least `needed` bytes and unable to shrink, or
+    // the server could fault on pages the client truncated away
+    static bool memfd_usable(int fd, size_t needed) {
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 0 || static_cast<uint64_t>(st.st_size) < needed) return false;
+        int seals = fcntl(fd, F_GET_SEALS);
+        return seals >= 0 && (seals & F_SEAL_SHRINK);
+    }
+
+    std::string path;
+    int listen_fd;
+    std::atomic<bool> stopping;
+    std::mutex sessions_mutex;
+    std::condition_variable sessions_done;
+    std::set<int> live;  // sockets of running sessions
+};
+
+// ---------------------------------------------------------------------------
+// Client / load generator
+// ---------------------------------------------------------------------------
+
+// One connection with its own shared frame buffer
+class ImageClient {
+public:
+    // The destructor does not run for a half-built client, so every failure
+    // path releases what was set up so far before throwing
+    ImageClient(const std::string& path, int width, int height)
+        : sock(-1), buffer(nullptr), size(0), width(width), height(height), seq(0) {
+        if (!frame_size_valid(width, height)) {
+            throw std::invalid_argument("frame size out of range");
+        }
+        size = shared_buffer_size(width, height);
+        sock = connect_to(path);
+        if (sock < 0) {
+            throw std::runtime_error("cannot connect to " + path + ": " + std::strerror(errno));
+        }
+
+        // Sealed against shrinking: the server refuses buffers that could be truncated
+        int fd = memfd_create("simd_frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0 || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) != 0) {
+            int err = errno;
+            if (fd >= 0) close(fd);
+            release();
+            throw std::runtime_error(std::string("memfd setup failed: ") + std::strerror(err));
+        }
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            release();
+            throw std::runtime_error(std::string("mmap failed: ") + std::strerror(err));
+        }
+        buffer = static_cast<uint8_t*>(ptr);
+
+        Request request;
+        std::memset(&request, 0, sizeof(request));
+        request.type = MSG_ATTACH;
+        request.seq = seq++;
+        request.width = width;
+        request.height = height;
+        request.buffer_size = size;
+        Response response;
+        bool ok = send_message(sock, &request, sizeof(request), fd) &&
+                  receive_message(sock, &response, sizeof(response)) == sizeof(response) && response.status == 0;
+        close(fd);
+        if (!ok) {
+            release();
+            throw std::runtime_error("server rejected the frame buffer");
+        }
+    }
+
+    ~ImageClient() { release(); }
+
+    ImageClient(const ImageClient&) = delete;
+    ImageClient& operator=(const ImageClient&) = delete;
+
+    // Where the client writes the next RGB frame
+    uint8_t* frame() { return buffer; }
+
+    // Runs the op chain on the current frame; returns a pointer to the result
+    // inside the shared buffer (valid until the next call), or nullptr
+    const uint8_t* process(const std::vector<Op>& ops, size_t* result_size = nullptr) {
+        Request request;
+        std::memset(&request, 0, sizeof(request));
+        request.type = MSG_PROCESS;
+        request.seq = seq++;
+        request.op_count = static_cast<uint32_t>(std::min<size_t>(ops.size(), MAX_OPS));
+        std::copy(ops.begin(), ops.begin() + request.op_count, request.ops);
+
+        Response response;
+        if (!send_message(sock, &request, sizeof(request)) ||
+            receive_message(sock, &response, sizeof(response)) != sizeof(response) ||
+            response.status != 0 || response.seq != request.seq ||
+            response.offset + response.size > size) {
+            return nullptr;
+        }
+        if (result_size) *result_size = response.size;
+        return buffer + response.offset;
+    }
+
+private:
+    void release() {
+        if (buffer) munmap(buffer, size);
+        if (sock >= 0) close(sock);
+        buffer = nullptr;
+        sock = -1;
+    }
+
+    int sock;
+    uint8_t* buffer;
+    size_t size;
+    int width, height;
+    uint32_t seq;
+};
+
+bool send_shutdown(const std::string& path) {
+    int sock = connect_to(path);
+    if (sock < 0) return false;
+    Request request;
+    std::memset(&request, 0, sizeof(request));
+    request.type = MSG_SHUTDOWN;
+    bool ok = send_message(sock, &request, sizeof(request));
+    close(sock);
+    return ok;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Runs `connections` clients in parallel, each sending `frames` frames
+int run_load_generator(const std::string& path, int connections, int frames, int width, int height) {
+    const std::vector<Op> chain = {{OP_BRIGHTNESS, 30.0f}, {OP_CONTRAST, 1.2f}, {OP_GRAYSCALE, 0.0f}};
+    const size_t rgb_size = static_cast<size_t>(width) * height * RGB_CHANNELS;
+
+    // Source frame ("capture") and the expected result computed locally
+    std::vector<uint8_t> source(rgb_size);
+    initialize_test_image(source.data(), width, height, RGB_CHANNELS);
+    std::vector<uint8_t> local(source);
+    std::vector<uint8_t> expected(static_cast<size_t>(width) * height);
+    adjust_brightness_simd(local.data(), static_cast<int>(rgb_size), 30);
+    enhance_contrast_simd(local.data(), static_cast<int>(rgb_size), 1.2f);
+    convert_to_grayscale_simd(local.data(), expected.data(), width, height);
+
+    double local_us = measure_microseconds([&]() {
+        std::copy(source.begin(), source.end(), local.begin());
+        adjust_brightness_simd(local.data(), static_cast<int>(rgb_size), 30);
+        enhance_contrast_simd(local.data(), static_cast<int>(rgb_size), 1.2f);
+        convert_to_grayscale_simd(local.data(), expected.data(), width, height);
+    }, 20);
+
+    std::mutex mutex;
+    std::vector<double> latencies;
+    std::atomic<int> failures(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < connections; c++) {
+        threads.emplace_back([&]() {
+            std::vector<double> own;
+            try {
+                ImageClient client(path, width, height);
+                for (int f = 0; f < frames; f++) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    std::memcpy(client.frame(), source.data(), rgb_size);  // "capture" into shared memory
+                    size_t result_size = 0;
+                    const uint8_t* result = client.process(chain, &result_size);
+                    auto t1 = std::chrono::steady_clock::now();
+
+                    if (!result || result_size != expected.size() ||
+                        (f == 0 && !std::equal(expected.begin(), expected.end(), result))) {
+                        failures++;
+                    }
+                    own.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "client: " << e.what() << std::endl;
+                failures++;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            latencies.insert(latencies.end(), own.begin(), own.end());
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << connections << " connection(s), " << latencies.size() << " frames of " << width << "x" << height
+              << ": " << latencies.size() / seconds << " frames/s" << std::endl;
+    std::cout << "  latency us: p50 " << percentile(latencies, 50) << ", p90 " << percentile(latencies, 90)
+              << ", p99 " << percentile(latencies, 99) << ", max " << (latencies.empty() ? 0.0 : latencies.back())
+              << "  (in-process chain: " << local_us << " us)" << std::endl;
+    std::cout << "  results: " << (failures.load() == 0 ? "OK" : "MISMATCH") << std::endl;
+    return failures.load() == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "demo";
+    std::string path = argc > 2 ? argv[2] : DEFAULT_SOCKET;
+
+    if (mode == "server") {
+        signal(SIGPIPE, SIG_IGN);
+        std::cout << "Serving on " << path << std::endl;
+        return ImageServer(path).run();
+    }
+    if (mode == "client") {
+        int connections = argc > 3 ? std::atoi(argv[3]) : 1;
+        int frames = argc > 4 ? std::atoi(argv[4]) : 500;
+        int width = argc > 5 ? std::atoi(argv[5]) : 1024;
+        int height = argc > 6 ? std::atoi(argv[6]) : 768;
+        return run_load_generator(path, connections, frames, width, height);
+    }
+    if (mode == "stop") {
+        return send_shutdown(path) ? 0 : 1;
+    }
+
+    // Demo: server in a child process, load generator in this one
+    std::cout << "=== SIMD Image Server (Unix socket + memfd) ===" << std::endl;
+    std::cout << std::endl;
+
+    path = "/tmp/simd_image_server_" + std::to_string(getpid()) + ".sock";
+    pid_t child = fork();
+    if (child == 0) {
+        signal(SIGPIPE, SIG_IGN);
+        _exit(ImageServer(path).run());
+    }
+
+    // Wait for the server socket to come up
+    for (int attempt = 0; attempt < 200; attempt++) {
+        int sock = connect_to(path);
+        if (sock >= 0) {
+            close(sock);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    int status = 0;
+    std::cout << "Op chain: brightness(30) -> contrast(1.2) -> grayscale" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    status |= run_load_generator(path, 1, 300, 1024, 768);
+    status |= run_load_generator(path, 4, 100, 1024, 768);
+    status |= run_load_generator(path, 4, 2000, 64, 64);
+
+    send_shutdown(path);
+    int child_status = 0;
+    waitpid(child, &child_status, 0);
+    std::cout << "Server exited with status " << WEXITSTATUS(child_status) << std::endl;
+    return status | WEXITSTATUS(child_status);
+}
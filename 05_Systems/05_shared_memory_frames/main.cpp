@@ -0,0 +1,254 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_shm.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * 05_Systems/05_shared_memory_frames - Zero-copy frame exchange between processes
+ *
+ * A capture process and a processing process usually exchange frames through a
+ * pipe or socket, which copies every frame twice (into the kernel and out again).
+ * For a 1080p RGB frame those copies cost more than adjust_brightness_simd itself.
+ * SharedFramePool (simd_shm.h) puts the frames in shared memory instead: the
+ * producer writes a frame once into a free slot, publishes the slot index, and the
+ * consumer process runs the kernel on the slot in place.
+ *
+ * We'll:
+ * 1. Measure the cost of copying a frame against the cost of the brightness kernel
+ * 2. Send frames to a child process through a pipe (copy baseline)
+ * 3. Send the same frames through the shared-memory pool (zero copy)
+ * 4. Compare frames/s and check that both consumers computed the same checksum
+ */
+
+const int WIDTH = 1920;
+const int HEIGHT = 1080;
+const size_t FRAME_BYTES = static_cast<size_t>(WIDTH) * HEIGHT * RGB_CHANNELS;
+const int FRAME_COUNT = 300;
+const int BRIGHTNESS = 20;
+const uint32_t POOL_SLOTS = 4;
+
+// Sum of all bytes (stands in for whatever the consumer does with the result)
+uint64_t checksum_simd(const uint8_t* data, size_t size) {
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(data + i));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+    uint64_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < size; i++) total += data[i];
+    return total;
+}
+
+// "Capture": copy the base frame and stamp the frame number into it
+void capture_frame(uint8_t* dst, const uint8_t* base, uint64_t frame) {
+    std::memcpy(dst, base, FRAME_BYTES);
+    std::memcpy(dst, &frame, sizeof(frame));
+}
+
+// The consumer work for one frame, identical in both transports
+uint64_t consume_frame(uint8_t* frame, size_t size) {
+    adjust_brightness_simd(frame, static_cast<int>(size), BRIGHTNESS);
+    return checksum_simd(frame, size);
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, void* data, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+struct RunResult {
+    double seconds;
+    uint64_t checksum;
+};
+
+// Forks a consumer running `child_main`, which reports its checksum on the
+// result pipe; `produce` runs in the parent
+template<typename ChildMain, typename Produce>
+RunResult run_with_child(ChildMain child_main, Produce produce) {
+    int result_pipe[2];
+    if (pipe(result_pipe) != 0) {
+        throw std::runtime_error("pipe failed");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t child = fork();
+    if (child < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (child == 0) {
+        close(result_pipe[0]);
+        uint64_t checksum = child_main();
+        _exit(write_all(result_pipe[1], &checksum, sizeof(checksum)) ? 0 : 1);
+    }
+
+    close(result_pipe[1]);
+    produce();
+    RunResult result = {0.0, 0};
+    bool ok = read_all(result_pipe[0], &result.checksum, sizeof(result.checksum));
+    close(result_pipe[0]);
+    int status = 0;
+    waitpid(child, &status, 0);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("consumer process failed");
+    }
+    return result;
+}
+
+// 2. Copy baseline: frames go through a pipe into the consumer's own buffer
+RunResult run_pipe(const uint8_t* base) {
+    int frames_pipe[2];
+    if (pipe(frames_pipe) != 0) {
+        throw std::runtime_error("pipe failed");
+    }
+    fcntl(frames_pipe[1], F_SETPIPE_SZ, 1 << 20);
+
+    RunResult result = run_with_child(
+        [&]() -> uint64_t {
+            close(frames_pipe[1]);
+            uint8_t* frame = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+            uint64_t checksum = 0;
+            while (read_all(frames_pipe[0], frame, FRAME_BYTES)) {
+                checksum += consume_frame(frame, FRAME_BYTES);
+            }
+            free(frame);
+            return checksum;
+        },
+        [&]() {
+            close(frames_pipe[0]);
+            uint8_t* frame = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+            for (int f = 0; f < FRAME_COUNT; f++) {
+                capture_frame(frame, base, static_cast<uint64_t>(f));
+                if (!write_all(frames_pipe[1], frame, FRAME_BYTES)) break;
+            }
+            free(frame);
+            close(frames_pipe[1]);
+        });
+    return result;
+}
+
+// 3. Zero copy: frames are captured straight into pool slots
+RunResult run_shared(const uint8_t* base, std::string& backing) {
+    std::string name = "/simd_frames_" + std::to_string(getpid());
+    SharedFramePool pool(name, POOL_SLOTS, FRAME_BYTES);
+    backing = pool.backing_name();
+
+    return run_with_child(
+        [&]() -> uint64_t {
+            // The consumer opens the pool by name, as an unrelated process would
+            SharedFramePool consumer(name);
+            uint64_t checksum = 0;
+            uint32_t index;
+            while (consumer.receive(index)) {
+                checksum += consume_frame(consumer.slot(index), consumer.info(index).bytes);
+                consumer.release(index);
+            }
+            return checksum;
+        },
+        [&]() {
+            for (int f = 0; f < FRAME_COUNT; f++) {
+                uint32_t index = pool.acquire();
+                capture_frame(pool.slot(index), base, static_cast<uint64_t>(f));
+                FrameInfo& info = pool.info(index);
+                info.sequence = static_cast<uint64_t>(f);
+                info.width = WIDTH;
+                info.height = HEIGHT;
+                info.channels = RGB_CHANNELS;
+                info.bytes = FRAME_BYTES;
+                pool.publish(index);
+            }
+            pool.close_pool();
+        });
+}
+
+void print_run(const std::string& label, const RunResult& result, uint64_t expected) {
+    std::cout << std::left << std::setw(26) << label << std::right << std::fixed
+              << std::setw(8) << std::setprecision(1) << FRAME_COUNT / result.seconds << " frames/s"
+              << std::setw(8) << std::setprecision(2) << FRAME_COUNT * FRAME_BYTES / result.seconds / 1e9 << " GB/s"
+              << "   " << (result.checksum == expected ? "OK" : "MISMATCH") << std::endl;
+}
+
+int main() {
+    std::cout << "=== Shared-Memory Frame Exchange ===" << std::endl;
+    std::cout << std::endl;
+
+    uint8_t* base = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    uint8_t* scratch = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    uint8_t* copy = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    initialize_test_image(base, WIDTH, HEIGHT, RGB_CHANNELS);
+
+    // Expected consumer checksum over all frames
+    uint64_t expected = 0;
+    for (int f = 0; f < FRAME_COUNT; f++) {
+        capture_frame(scratch, base, static_cast<uint64_t>(f));
+        expected += consume_frame(scratch, FRAME_BYTES);
+    }
+
+    // 1. Per-frame costs
+    std::cout << "1. Per-frame costs (" << WIDTH << "x" << HEIGHT << " RGB, "
+              << FRAME_BYTES / 1024 << " KB)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    double copy_us = measure_microseconds([&]() { std::memcpy(copy, base, FRAME_BYTES); }, 50);
+    double kernel_us = measure_microseconds([&]() {
+        adjust_brightness_simd(scratch, static_cast<int>(FRAME_BYTES), BRIGHTNESS);
+    }, 50);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "memcpy of one frame:      " << std::setw(8) << copy_us << " us" << std::endl;
+    std::cout << "adjust_brightness_simd:   " << std::setw(8) << kernel_us << " us" << std::endl;
+    std::cout << "(a pipe transfer copies each frame twice)" << std::endl;
+    std::cout << std::endl;
+
+    // 2-4. Transports
+    std::cout << "2-3. " << FRAME_COUNT << " frames, producer -> consumer process" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    bool all_ok = true;
+    RunResult piped = run_pipe(base);
+    print_run("pipe (copy)", piped, expected);
+    all_ok = all_ok && piped.checksum == expected;
+
+    std::string backing;
+    RunResult shared = run_shared(base, backing);
+    print_run("shared pool (zero copy)", shared, expected);
+    all_ok = all_ok && shared.checksum == expected;
+
+    std::cout << std::endl;
+    std::cout << "4. Summary" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << "Pool backing: " << backing << ", " << POOL_SLOTS << " slots" << std::endl;
+    std::cout << "Speedup over pipe: " << std::setprecision(2) << piped.seconds / shared.seconds << "x" << std::endl;
+
+    free(base);
+    free(scratch);
+    free(copy);
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+/**
+ * 06_Image_Processing/01_video_benchmark - Frame sequences and temporal tile reuse
+ *
+ * The image example processes one synthetic frame over and over. Video is a sequence
+ * of frames that mostly repeat their predecessor: a static background with a few
+ * moving objects. Since brightness, contrast and grayscale are per-pixel operations,
+ * an output tile only has to be recomputed when its input tile changed.
+ *
+ * We'll:
+ * 1. Generate a 1280x720 RGB sequence with two moving objects and a lighting
+ *    change (every tile changes) every 50 frames
+ * 2. Run brightness -> contrast -> grayscale on every full frame
+ * 3. Run it in temporal mode, recomputing only changed 64x16 tiles, detected either
+ *    by comparing against the previous frame (exact, keeps a frame copy) or by a
+ *    per-tile SIMD hash (keeps 8 bytes per tile)
+ * 4. Report frames/s and the skipped-tile ratio, and check every output frame
+ *    against the full pipeline
+ */
+
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+const int FRAME_COUNT = 150;
+const int SCENE_CHANGE_INTERVAL = 50;
+
+const int TILE_W = 64;
+const int TILE_H = 16;
+const int TILES_X = WIDTH / TILE_W;
+const int TILES_Y = HEIGHT / TILE_H;
+const int TILE_ROW_BYTES = TILE_W * RGB_CHANNELS;  // 192 = 6 AVX2 vectors
+const size_t FRAME_BYTES = static_cast<size_t>(WIDTH) * HEIGHT * RGB_CHANNELS;
+
+static_assert(WIDTH % TILE_W == 0 && HEIGHT % TILE_H == 0, "frame must be a whole number of tiles");
+static_assert(TILE_ROW_BYTES % 32 == 0, "tile rows must be a whole number of vectors");
+
+const int BRIGHTNESS = 25;
+const float CONTRAST = 1.3f;
+
+// ---------------------------------------------------------------------------
+// Synthetic video
+// ---------------------------------------------------------------------------
+
+void fill_rect(uint8_t* frame, int x0, int y0, int w, int h, uint8_t r, uint8_t g, uint8_t b) {
+    for (int y = std::max(0, y0); y < std::min(HEIGHT, y0 + h); y++) {
+        for (int x = std::max(0, x0); x < std::min(WIDTH, x0 + w); x++) {
+            uint8_t* p = frame + (static_cast<size_t>(y) * WIDTH + x) * RGB_CHANNELS;
+            p[0] = r;
+            p[1] = g;
+            p[2] = b;
+        }
+    }
+}
+
+// Background gradient, a square moving right and a smaller one bouncing diagonally
+void render_frame(uint8_t* frame, const uint8_t* background, int index) {
+    std::memcpy(frame, background, FRAME_BYTES);
+    int scene = index / SCENE_CHANGE_INTERVAL;
+    if (scene > 0) {
+        adjust_brightness_simd(frame, static_cast<int>(FRAME_BYTES), 10 * scene);  // lighting change
+    }
+
+    int x = 40 + (index * 7) % (WIDTH - 200);
+    fill_rect(frame, x, 200, 120, 120, 220, 40, 40);
+
+    int period_x = 2 * (WIDTH - 60), period_y = 2 * (HEIGHT - 60);
+    int bx = (index * 11) % period_x, by = (index * 5) % period_y;
+    if (bx > WIDTH - 60) bx = period_x - bx;
+    if (by > HEIGHT - 60) by = period_y - by;
+    fill_rect(frame, bx, by, 60, 60, 30, 200, 90);
+}
+
+// ---------------------------------------------------------------------------
+// Pipeline
+// ---------------------------------------------------------------------------
+
+class Pipeline {
+public:
+    Pipeline()
+        : work(aligned_alloc<uint8_t>(FRAME_BYTES, 64)),
+          tile_rgb(aligned_alloc<uint8_t>(TILE_W * TILE_H * RGB_CHANNELS, 64)),
+          tile_gray(aligned_alloc<uint8_t>(TILE_W * TILE_H, 64)) {}
+
+    ~Pipeline() {
+        free(work);
+        free(tile_rgb);
+        free(tile_gray);
+    }
+
+    // The whole frame
+    void run_frame(const uint8_t* rgb, uint8_t* gray) {
+        std::memcpy(work, rgb, FRAME_BYTES);
+        process(work, gray, WIDTH, HEIGHT);
+    }
+
+    // One tile: gather it into a contiguous buffer, process, scatter the gray rows
+    void run_tile(const uint8_t* rgb, uint8_t* gray, int tx, int ty) {
+        for (int r = 0; r < TILE_H; r++) {
+            std::memcpy(tile_rgb + r * TILE_ROW_BYTES, rgb + tile_offset(tx, ty, r) * RGB_CHANNELS, TILE_ROW_BYTES);
+        }
+        process(tile_rgb, tile_gray, TILE_W, TILE_H);
+        for (int r = 0; r < TILE_H; r++) {
+            std::memcpy(gray + tile_offset(tx, ty, r), tile_gray + r * TILE_W, TILE_W);
+        }
+    }
+
+    // Pixel index of row r of tile (tx, ty)
+    static size_t tile_offset(int tx, int ty, int r) {
+        return static_cast<size_t>(ty * TILE_H + r) * WIDTH + tx * TILE_W;
+    }
+
+private:
+    static void process(uint8_t* rgb, uint8_t* gray, int width, int height) {
+        int size = width * height * RGB_CHANNELS;
+        adjust_brightness_simd(rgb, size, BRIGHTNESS);
+        enhance_contrast_simd(rgb, size, CONTRAST);
+        convert_to_grayscale_simd(rgb, gray, width, height);
+    }
+
+    uint8_t* work;
+    uint8_t* tile_rgb;
+    uint8_t* tile_gray;
+};
+
+// ---------------------------------------------------------------------------
+// Change detection
+// ---------------------------------------------------------------------------
+
+// Exact: OR of XORs against the previous frame, stopping at the first changed row
+bool tile_differs(const uint8_t* a, const uint8_t* b, int tx, int ty) {
+    for (int r = 0; r < TILE_H; r++) {
+        size_t offset = Pipeline::tile_offset(tx, ty, r) * RGB_CHANNELS;
+        __m256i diff = _mm256_setzero_si256();
+        for (int i = 0; i < TILE_ROW_BYTES; i += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + offset + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + offset + i));
+            diff = _mm256_or_si256(diff, _mm256_xor_si256(va, vb));
+        }
+        if (!_mm256_testz_si256(diff, diff)) return true;
+    }
+    return false;
+}
+
+// Per-tile hash: eight 32-bit multiply-xorshift lanes folded to 64 bits.
+// A collision would reuse a stale tile, so this trades exactness for memory.
+uint64_t tile_hash(const uint8_t* rgb, int tx, int ty) {
+    const __m256i prime = _mm256_set1_epi32(static_cast<int>(0x9E3779B1u));
+    __m256i h = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8);
+    for (int r = 0; r < TILE_H; r++) {
+        size_t offset = Pipeline::tile_offset(tx, ty, r) * RGB_CHANNELS;
+        for (int i = 0; i < TILE_ROW_BYTES; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgb + offset + i));
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, v), prime);
+            h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+        }
+    }
+    uint32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), h);
+    uint64_t result = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 8; i++) {
+        result = (result ^ lanes[i]) * 0x100000001b3ULL;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+enum Mode { FULL, TEMPORAL_DIFF, TEMPORAL_HASH };
+
+struct RunStats {
+    double seconds = 0.0;
+    long tiles_processed = 0;
+    long tiles_total = 0;
+    std::vector<uint64_t> frame_checksums;
+};
+
+uint64_t checksum(const uint8_t* data, size_t size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i++) sum = sum * 31 + data[i];
+    return sum;
+}
+
+RunStats run_sequence(Mode mode, const uint8_t* background) {
+    const size_t gray_bytes = static_cast<size_t>(WIDTH) * HEIGHT;
+    uint8_t* frame = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    uint8_t* previous = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    uint8_t* gray = aligned_alloc<uint8_t>(gray_bytes, 64);
+    std::vector<uint64_t> hashes(TILES_X * TILES_Y);
+    std::vector<uint8_t> changed(TILES_X * TILES_Y);
+    Pipeline pipeline;
+    RunStats stats;
+
+    for (int f = 0; f < FRAME_COUNT; f++) {
+        render_frame(frame, background, f);  // capture is not timed
+
+        auto start = std::chrono::steady_clock::now();
+        if (mode == FULL || f == 0) {
+            pipeline.run_frame(frame, gray);
+            stats.tiles_processed += TILES_X * TILES_Y;
+            if (mode == TEMPORAL_DIFF) std::memcpy(previous, frame, FRAME_BYTES);
+            if (mode == TEMPORAL_HASH) {
+                for (int ty = 0; ty < TILES_Y; ty++) {
+                    for (int tx = 0; tx < TILES_X; tx++) hashes[ty * TILES_X + tx] = tile_hash(frame, tx, ty);
+                }
+            }
+        } else {
+            for (int ty = 0; ty < TILES_Y; ty++) {
+                for (int tx = 0; tx < TILES_X; tx++) {
+                    int t = ty * TILES_X + tx;
+                    if (mode == TEMPORAL_DIFF) {
+                        changed[t] = tile_differs(frame, previous, tx, ty);
+                    } else {
+                        uint64_t h = tile_hash(frame, tx, ty);
+                        changed[t] = h != hashes[t];
+                        hashes[t] = h;
+                    }
+                    if (changed[t]) {
+                        pipeline.run_tile(frame, gray, tx, ty);
+                        stats.tiles_processed++;
+                        if (mode == TEMPORAL_DIFF) {
+                            // Only changed tiles need to be copied into the reference
+                            for (int r = 0; r < TILE_H; r++) {
+                                size_t offset = Pipeline::tile_offset(tx, ty, r) * RGB_CHANNELS;
+                                std::memcpy(previous + offset, frame + offset, TILE_ROW_BYTES);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.tiles_total += TILES_X * TILES_Y;
+        stats.frame_checksums.push_back(checksum(gray, gray_bytes));
+    }
+
+    free(frame);
+    free(previous);
+    free(gray);
+    return stats;
+}
+
+int main() {
+    std::cout << "=== Video Benchmark with Temporal Tile Reuse ===" << std::endl;
+    std::cout << std::endl;
+    std::cout << FRAME_COUNT << " frames of " << WIDTH << "x" << HEIGHT << " RGB, "
+              << TILES_X << "x" << TILES_Y << " tiles of " << TILE_W << "x" << TILE_H
+              << ", lighting change every " << SCENE_CHANGE_INTERVAL << " frames" << std::endl;
+    std::cout << "Pipeline: brightness(" << BRIGHTNESS << ") -> contrast(" << CONTRAST << ") -> grayscale" << std::endl;
+    std::cout << std::endl;
+
+    uint8_t* background = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    initialize_test_image(background, WIDTH, HEIGHT, RGB_CHANNELS);
+
+    struct Config {
+        Mode mode;
+        const char* label;
+    };
+    const Config configs[] = {
+        {FULL, "Full frame"},
+        {TEMPORAL_DIFF, "Temporal (tile diff)"},
+        {TEMPORAL_HASH, "Temporal (tile hash)"},
+    };
+
+    std::cout << std::left << std::setw(24) << "Mode" << std::right << std::setw(12) << "Frames/s"
+              << std::setw(12) << "ms/frame" << std::setw(12) << "Skipped" << "   Check" << std::endl;
+    std::cout << "---------------------------------------------------------------------" << std::endl;
+
+    bool all_ok = true;
+    RunStats reference;
+    for (const Config& config : configs) {
+        RunStats stats = run_sequence(config.mode, background);
+        if (config.mode == FULL) reference = stats;
+
+        // Every output frame must match the full pipeline
+        bool ok = stats.frame_checksums == reference.frame_checksums;
+        all_ok = all_ok && ok;
+        double skipped = 1.0 - static_cast<double>(stats.tiles_processed) / stats.tiles_total;
+        std::cout << std::left << std::setw(24) << config.label << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(1) << FRAME_COUNT / stats.seconds
+                  << std::setw(12) << std::setprecision(2) << stats.seconds * 1e3 / FRAME_COUNT
+                  << std::setw(11) << std::setprecision(1) << skipped * 100.0 << "%"
+                  << "   " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+
+    // Cost of detection alone on an unchanged frame
+    uint8_t* frame = aligned_alloc<uint8_t>(FRAME_BYTES, 64);
+    render_frame(frame, background, 0);
+    volatile uint64_t sink = 0;
+    double diff_us = measure_microseconds([&]() {
+        int n = 0;
+        for (int ty = 0; ty < TILES_Y; ty++) {
+            for (int tx = 0; tx < TILES_X; tx++) n += tile_differs(frame, frame, tx, ty);
+        }
+        sink = sink + n;
+    }, 50);
+    double hash_us = measure_microseconds([&]() {
+        uint64_t h = 0;
+        for (int ty = 0; ty < TILES_Y; ty++) {
+            for (int tx = 0; tx < TILES_X; tx++) h ^= tile_hash(frame, tx, ty);
+        }
+        sink = sink + h;
+    }, 50);
+    std::cout << std::endl;
+    std::cout << "Change detection on a whole frame: diff " << std::setprecision(1) << diff_us
+              << " us, hash " << hash_us << " us" << std::endl;
+
+    free(frame);
+    free(background);
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_motion.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cstring>
+
+/**
+ * 06_Image_Processing/02_frame_differencing - Frame differencing and motion masks
+ *
+ * The first stage of motion detection compares consecutive grayscale frames.
+ * Unsigned bytes have no absolute-difference instruction, but saturating
+ * subtraction in both directions gives max(a - b, 0) and max(b - a, 0), and OR-ing
+ * them yields |a - b|. _mm256_sad_epu8 goes one step further and sums |a - b|
+ * over groups of 8 bytes, which is exactly what SAD summaries need.
+ *
+ * We'll:
+ * 1. Compute the absolute difference image
+ * 2. Threshold it into a motion mask (255 = moving)
+ * 3. Compute the whole-frame SAD
+ * 4. Compute per-tile SAD summaries and print the map of moving tiles
+ *
+ * The frames are rendered in RGB and converted with convert_to_grayscale_simd.
+ */
+
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+const int GRAY_SIZE = WIDTH * HEIGHT;
+const int TILE_H = 32;
+const uint8_t MOTION_THRESHOLD = 20;
+
+// Gradient background with a square and a smaller block that move between frames
+void render_gray_frame(uint8_t* gray, int frame) {
+    std::vector<uint8_t> rgb(static_cast<size_t>(GRAY_SIZE) * RGB_CHANNELS);
+    initialize_test_image(rgb.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+
+    auto fill_rect = [&](int x0, int y0, int w, int h, uint8_t r, uint8_t g, uint8_t b) {
+        for (int y = y0; y < y0 + h; y++) {
+            for (int x = x0; x < x0 + w; x++) {
+                uint8_t* p = &rgb[(static_cast<size_t>(y) * WIDTH + x) * RGB_CHANNELS];
+                p[0] = r;
+                p[1] = g;
+                p[2] = b;
+            }
+        }
+    };
+    fill_rect(300 + 12 * frame, 200, 160, 160, 250, 250, 250);
+    fill_rect(900, 450 + 8 * frame, 64, 64, 0, 0, 0);
+
+    convert_to_grayscale_simd(rgb.data(), gray, WIDTH, HEIGHT);
+}
+
+int main() {
+    std::cout << "=== SIMD Frame Differencing ===" << std::endl;
+    std::cout << std::endl;
+
+    uint8_t* previous = aligned_alloc<uint8_t>(GRAY_SIZE, 64);
+    uint8_t* current = aligned_alloc<uint8_t>(GRAY_SIZE, 64);
+    uint8_t* out_scalar = aligned_alloc<uint8_t>(GRAY_SIZE, 64);
+    uint8_t* out_simd = aligned_alloc<uint8_t>(GRAY_SIZE, 64);
+    render_gray_frame(previous, 0);
+    render_gray_frame(current, 1);
+
+    const int tiles_x = motion_tiles_x(WIDTH);
+    const int tiles_y = motion_tiles_y(HEIGHT, TILE_H);
+    std::vector<uint32_t> tiles_scalar(tiles_x * tiles_y);
+    std::vector<uint32_t> tiles_simd(tiles_x * tiles_y);
+
+    bool all_ok = true;
+    const int iterations = 200;
+
+    // 1. Absolute difference
+    std::cout << "1. Absolute Difference" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    benchmark_comparison("Absolute difference",
+        [&]() { absolute_difference_scalar(previous, current, out_scalar, GRAY_SIZE); },
+        [&]() { absolute_difference_simd(previous, current, out_simd, GRAY_SIZE); },
+        iterations);
+    bool diff_ok = std::memcmp(out_scalar, out_simd, GRAY_SIZE) == 0;
+    std::cout << "Results: " << (diff_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && diff_ok;
+
+    // 2. Motion mask
+    std::cout << "2. Motion Mask (|a - b| > " << static_cast<int>(MOTION_THRESHOLD) << ")" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    benchmark_comparison("Motion mask",
+        [&]() { motion_mask_scalar(previous, current, out_scalar, GRAY_SIZE, MOTION_THRESHOLD); },
+        [&]() { motion_mask_simd(previous, current, out_simd, GRAY_SIZE, MOTION_THRESHOLD); },
+        iterations);
+    bool mask_ok = std::memcmp(out_scalar, out_simd, GRAY_SIZE) == 0;
+    int moving = 0;
+    for (int i = 0; i < GRAY_SIZE; i++) moving += out_simd[i] != 0;
+    std::cout << "Moving pixels: " << moving << " (" << std::fixed << std::setprecision(2)
+              << 100.0 * moving / GRAY_SIZE << "%)" << std::endl;
+    std::cout << "Results: " << (mask_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && mask_ok;
+
+    // 3. Frame SAD
+    std::cout << "3. Frame SAD" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    uint64_t sad_scalar = 0, sad_simd = 0;
+    benchmark_comparison("Frame SAD",
+        [&]() { sad_scalar = frame_sad_scalar(previous, current, GRAY_SIZE); },
+        [&]() { sad_simd = frame_sad_simd(previous, current, GRAY_SIZE); },
+        iterations);
+    std::cout << "SAD: " << sad_simd << std::endl;
+    std::cout << "Results: " << (sad_scalar == sad_simd ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && sad_scalar == sad_simd;
+
+    // 4. Per-tile SAD
+    std::cout << "4. Per-Tile SAD (" << MOTION_TILE_W << "x" << TILE_H << " tiles)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    benchmark_comparison("Tile SAD",
+        [&]() { tile_sad_scalar(previous, current, WIDTH, HEIGHT, TILE_H, tiles_scalar.data()); },
+        [&]() { tile_sad_simd(previous, current, WIDTH, HEIGHT, TILE_H, tiles_simd.data()); },
+        iterations);
+    bool tiles_ok = tiles_scalar == tiles_simd;
+    std::cout << "Results: " << (tiles_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && tiles_ok;
+
+    // Tiles where about 1/16 of the pixels moved by the threshold
+    const uint32_t tile_threshold = static_cast<uint32_t>(MOTION_THRESHOLD) * MOTION_TILE_W * TILE_H / 16;
+    std::cout << "Moving tiles (#):" << std::endl;
+    for (int ty = 0; ty < tiles_y; ty++) {
+        for (int tx = 0; tx < tiles_x; tx++) {
+            std::cout << (tiles_simd[ty * tiles_x + tx] > tile_threshold ? '#' : '.');
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Edge handling: sizes that are not multiples of the vector or tile width
+    const int odd_width = 203, odd_height = 51, odd_size = odd_width * odd_height;
+    std::vector<uint8_t> a(odd_size), b(odd_size), m1(odd_size), m2(odd_size);
+    std::mt19937 gen(7);
+    for (int i = 0; i < odd_size; i++) {
+        a[i] = static_cast<uint8_t>(gen());
+        b[i] = static_cast<uint8_t>(gen());
+    }
+    std::vector<uint32_t> t1(motion_tiles_x(odd_width) * motion_tiles_y(odd_height, 16));
+    std::vector<uint32_t> t2(t1.size());
+    absolute_difference_scalar(a.data(), b.data(), m1.data(), odd_size);
+    absolute_difference_simd(a.data(), b.data(), m2.data(), odd_size);
+    bool odd_ok = m1 == m2;
+    motion_mask_scalar(a.data(), b.data(), m1.data(), odd_size, 100);
+    motion_mask_simd(a.data(), b.data(), m2.data(), odd_size, 100);
+    odd_ok = odd_ok && m1 == m2;
+    odd_ok = odd_ok && frame_sad_scalar(a.data(), b.data(), odd_size) == frame_sad_simd(a.data(), b.data(), odd_size);
+    tile_sad_scalar(a.data(), b.data(), odd_width, odd_height, 16, t1.data());
+    tile_sad_simd(a.data(), b.data(), odd_width, odd_height, 16, t2.data());
+    odd_ok = odd_ok && t1 == t2;
+    std::cout << "Odd-sized frames (" << odd_width << "x" << odd_height << "): "
+              << (odd_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && odd_ok;
+
+    free(previous);
+    free(current);
+    free(out_scalar);
+    free(out_simd);
+    return all_ok ? 0 : 1;
+}
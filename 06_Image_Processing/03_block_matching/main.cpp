@@ -0,0 +1,416 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_motion.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
+
+/**
+ * 06_Image_Processing/03_block_matching - Template matching and block motion search
+ *
+ * Both problems slide a small block over a search area and keep the position with
+ * the lowest difference score:
+ * - Template matching compares one template against every position of an image,
+ *   scored by SAD or SSD (block_sad_simd / block_ssd_simd from simd_motion.h)
+ * - Block motion search splits the current frame into 8x8 or 16x16 blocks and
+ *   finds, for each one, the best match within +/-SEARCH_RANGE pixels in the
+ *   previous frame
+ *
+ * Exhaustive motion search is dominated by SADs at neighbouring offsets.
+ * _mm256_mpsadbw_epu8 produces eight of them at once (block_sad_x8_simd), and
+ * _mm_minpos_epu16 picks the best of the eight. Diamond search instead walks
+ * downhill from (0, 0) and evaluates a few dozen candidates with _mm256_sad_epu8.
+ *
+ * We'll:
+ * 1. Match a 32x32 template with SAD and SSD, scalar vs SIMD, 1 vs N threads
+ * 2. Run exhaustive scalar, exhaustive mpsadbw and diamond search for 8x8 and
+ *    16x16 blocks, reporting blocks/s and how often the true motion was found
+ */
+
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+const int SEARCH_RANGE = 16;
+const int FRAME_SLACK = 32;  // block_sad_x8_simd may read a few bytes past the last row
+
+const int TEMPLATE_IMAGE_W = 640;
+const int TEMPLATE_IMAGE_H = 360;
+const int TEMPLATE_SIZE = 32;
+const int TEMPLATE_X = 371;
+const int TEMPLATE_Y = 143;
+
+// Global camera motion and the motion of one object, as "block in current frame
+// at (x, y) matches the previous frame at (x + dx, y + dy)"
+const int GLOBAL_DX = 5, GLOBAL_DY = -3;
+const int OBJECT_DX = -9, OBJECT_DY = 6;
+const int OBJECT_X = 600, OBJECT_Y = 300, OBJECT_SIZE = 160;
+
+// Smooth texture with some noise, so SAD surfaces have a slope to follow
+std::vector<uint8_t> make_texture(int width, int height, unsigned seed) {
+    std::vector<uint8_t> image(static_cast<size_t>(width) * height + FRAME_SLACK);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> noise(-2, 2);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double v = 128.0 + 50.0 * std::sin(0.045 * x + 0.3 * std::sin(0.02 * y)) + 40.0 * std::cos(0.06 * y + 0.01 * x);
+            image[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, v + noise(gen))));
+        }
+    }
+    return image;
+}
+
+// Runs fn(row) for rows [0, rows) on `threads` threads
+void parallel_rows(int rows, int threads, const std::function<void(int)>& fn) {
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int row = next++; row < rows; row = next++) fn(row);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+}
+
+double elapsed_seconds(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ---------------------------------------------------------------------------
+// 1. Template matching
+// ---------------------------------------------------------------------------
+
+enum Metric { SAD, SSD };
+
+struct Match {
+    int x = 0, y = 0;
+    uint64_t score = UINT64_MAX;
+};
+
+Match match_template(const uint8_t* image, int width, int height, const uint8_t* templ, int size,
+                     Metric metric, bool simd, int threads) {
+    int rows = height - size + 1, cols = width - size + 1;
+    std::vector<Match> row_best(rows);
+    parallel_rows(rows, threads, [&](int y) {
+        Match best;
+        for (int x = 0; x < cols; x++) {
+            const uint8_t* window = image + y * width + x;
+            uint64_t score;
+            if (metric == SAD) {
+                score = simd ? block_sad_simd(templ, size, window, width, size, size)
+                             : block_sad_scalar(templ, size, window, width, size, size);
+            } else {
+                score = simd ? block_ssd_simd(templ, size, window, width, size, size)
+                             : block_ssd_scalar(templ, size, window, width, size, size);
+            }
+            if (score < best.score) {
+                best.x = x;
+                best.y = y;
+                best.score = score;
+            }
+        }
+        row_best[y] = best;
+    });
+
+    Match best;
+    for (const Match& m : row_best) {
+        if (m.score < best.score) best = m;
+    }
+    return best;
+}
+
+// ---------------------------------------------------------------------------
+// 2. Block motion search
+// ---------------------------------------------------------------------------
+
+struct MotionVector {
+    int dx = 0, dy = 0;
+    uint32_t sad = UINT32_MAX;
+};
+
+enum SearchMode { EXHAUSTIVE_SCALAR, EXHAUSTIVE_SIMD, DIAMOND };
+
+struct SearchWindow {
+    int dx_min, dx_max, dy_min, dy_max;
+
+    SearchWindow(int bx, int by, int size)
+        : dx_min(std::max(-SEARCH_RANGE, -bx)), dx_max(std::min(SEARCH_RANGE, WIDTH - size - bx)),
+          dy_min(std::max(-SEARCH_RANGE, -by)), dy_max(std::min(SEARCH_RANGE, HEIGHT - size - by)) {}
+
+    bool contains(int dx, int dy) const {
+        return dx >= dx_min && dx <= dx_max && dy >= dy_min && dy <= dy_max;
+    }
+};
+
+// Candidates in raster order (dy, then dx); ties keep the first one
+MotionVector search_exhaustive_scalar(const uint8_t* cur, const uint8_t* ref, int bx, int by, int size) {
+    SearchWindow w(bx, by, size);
+    const uint8_t* block = cur + by * WIDTH + bx;
+    MotionVector best;
+    for (int dy = w.dy_min; dy <= w.dy_max; dy++) {
+        for (int dx = w.dx_min; dx <= w.dx_max; dx++) {
+            uint32_t sad = block_sad_scalar(block, WIDTH, ref + (by + dy) * WIDTH + bx + dx, WIDTH, size, size);
+            if (sad < best.sad) {
+                best.dx = dx;
+                best.dy = dy;
+                best.sad = sad;
+            }
+        }
+    }
+    return best;
+}
+
+// Same order and tie-breaking, eight dx candidates per mpsadbw step
+MotionVector search_exhaustive_simd(const uint8_t* cur, const uint8_t* ref, int bx, int by, int size) {
+    SearchWindow w(bx, by, size);
+    const uint8_t* block = cur + by * WIDTH + bx;
+    const __m128i lane_index = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    MotionVector best;
+    for (int dy = w.dy_min; dy <= w.dy_max; dy++) {
+        const uint8_t* ref_row = ref + (by + dy) * WIDTH + bx;
+        for (int dx0 = w.dx_min; dx0 <= w.dx_max; dx0 += 8) {
+            __m128i sads = block_sad_x8_simd(block, WIDTH, ref_row + dx0, WIDTH, size);
+            int valid = w.dx_max - dx0 + 1;
+            if (valid < 8) {
+                // Offsets past the window become 0xFFFF (above any real SAD)
+                sads = _mm_or_si128(sads, _mm_cmpgt_epi16(lane_index, _mm_set1_epi16(static_cast<short>(valid - 1))));
+            }
+            // Lane 0: minimum, lane 1: its index (lowest index on ties)
+            __m128i min_pos = _mm_minpos_epu16(sads);
+            uint32_t sad = static_cast<uint32_t>(_mm_extract_epi16(min_pos, 0));
+            if (sad < best.sad) {
+                best.dx = dx0 + _mm_extract_epi16(min_pos, 1);
+                best.dy = dy;
+                best.sad = sad;
+            }
+        }
+    }
+    return best;
+}
+
+// Large diamond until the centre wins, then one small diamond step
+MotionVector search_diamond(const uint8_t* cur, const uint8_t* ref, int bx, int by, int size) {
+    static const int large[8][2] = {{0, -2}, {-1, -1}, {1, -1}, {-2, 0}, {2, 0}, {-1, 1}, {1, 1}, {0, 2}};
+    static const int small[4][2] = {{0, -1}, {-1, 0}, {1, 0}, {0, 1}};
+
+    SearchWindow w(bx, by, size);
+    const uint8_t* block = cur + by * WIDTH + bx;
+    auto sad_at = [&](int dx, int dy) {
+        return block_sad_simd(block, WIDTH, ref + (by + dy) * WIDTH + bx + dx, WIDTH, size, size);
+    };
+
+    MotionVector best;
+    best.sad = sad_at(0, 0);
+    for (int step = 0; step < 2 * SEARCH_RANGE; step++) {
+        MotionVector center = best;
+        for (const auto& d : large) {
+            int dx = center.dx + d[0], dy = center.dy + d[1];
+            if (!w.contains(dx, dy)) continue;
+            uint32_t sad = sad_at(dx, dy);
+            if (sad < best.sad) {
+                best.dx = dx;
+                best.dy = dy;
+                best.sad = sad;
+            }
+        }
+        if (best.dx == center.dx && best.dy == center.dy) break;
+    }
+    MotionVector center = best;
+    for (const auto& d : small) {
+        int dx = center.dx + d[0], dy = center.dy + d[1];
+        if (!w.contains(dx, dy)) continue;
+        uint32_t sad = sad_at(dx, dy);
+        if (sad < best.sad) {
+            best.dx = dx;
+            best.dy = dy;
+            best.sad = sad;
+        }
+    }
+    return best;
+}
+
+std::vector<MotionVector> motion_search(const uint8_t* cur, const uint8_t* ref, int size, SearchMode mode, int threads) {
+    int blocks_x = WIDTH / size, blocks_y = HEIGHT / size;
+    std::vector<MotionVector> vectors(blocks_x * blocks_y);
+    parallel_rows(blocks_y, threads, [&](int row) {
+        for (int col = 0; col < blocks_x; col++) {
+            int bx = col * size, by = row * size;
+            MotionVector& mv = vectors[row * blocks_x + col];
+            switch (mode) {
+                case EXHAUSTIVE_SCALAR: mv = search_exhaustive_scalar(cur, ref, bx, by, size); break;
+                case EXHAUSTIVE_SIMD: mv = search_exhaustive_simd(cur, ref, bx, by, size); break;
+                case DIAMOND: mv = search_diamond(cur, ref, bx, by, size); break;
+            }
+        }
+    });
+    return vectors;
+}
+
+// Fraction of blocks (fully inside one motion region) whose vector is the true one
+double true_motion_ratio(const std::vector<MotionVector>& vectors, int size) {
+    int blocks_x = WIDTH / size, hits = 0, total = 0;
+    for (size_t i = 0; i < vectors.size(); i++) {
+        int bx = static_cast<int>(i) % blocks_x * size, by = static_cast<int>(i) / blocks_x * size;
+        bool inside = bx >= OBJECT_X && bx + size <= OBJECT_X + OBJECT_SIZE &&
+                      by >= OBJECT_Y && by + size <= OBJECT_Y + OBJECT_SIZE;
+        bool outside = bx + size <= OBJECT_X || bx >= OBJECT_X + OBJECT_SIZE ||
+                       by + size <= OBJECT_Y || by >= OBJECT_Y + OBJECT_SIZE;
+        SearchWindow w(bx, by, size);
+        if (inside && w.contains(OBJECT_DX, OBJECT_DY)) {
+            total++;
+            hits += vectors[i].dx == OBJECT_DX && vectors[i].dy == OBJECT_DY;
+        } else if (outside && w.contains(GLOBAL_DX, GLOBAL_DY)) {
+            total++;
+            hits += vectors[i].dx == GLOBAL_DX && vectors[i].dy == GLOBAL_DY;
+        }
+    }
+    return total ? static_cast<double>(hits) / total : 0.0;
+}
+
+bool same_vectors(const std::vector<MotionVector>& a, const std::vector<MotionVector>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].dx != b[i].dx || a[i].dy != b[i].dy || a[i].sad != b[i].sad) return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== SIMD Template Matching and Block Motion Search ===" << std::endl;
+    std::cout << std::endl;
+
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool all_ok = true;
+
+    // 1. Template matching
+    std::cout << "1. Template Matching (" << TEMPLATE_SIZE << "x" << TEMPLATE_SIZE << " in "
+              << TEMPLATE_IMAGE_W << "x" << TEMPLATE_IMAGE_H << ", template from ("
+              << TEMPLATE_X << "," << TEMPLATE_Y << ") plus noise)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint8_t> image = make_texture(TEMPLATE_IMAGE_W, TEMPLATE_IMAGE_H, 1);
+    std::vector<uint8_t> templ(TEMPLATE_SIZE * TEMPLATE_SIZE);
+    std::mt19937 gen(2);
+    for (int y = 0; y < TEMPLATE_SIZE; y++) {
+        for (int x = 0; x < TEMPLATE_SIZE; x++) {
+            int v = image[(TEMPLATE_Y + y) * TEMPLATE_IMAGE_W + TEMPLATE_X + x] + static_cast<int>(gen() % 7) - 3;
+            templ[y * TEMPLATE_SIZE + x] = static_cast<uint8_t>(std::min(255, std::max(0, v)));
+        }
+    }
+
+    struct TemplateConfig {
+        const char* label;
+        Metric metric;
+        bool simd;
+        int threads;
+    };
+    const TemplateConfig template_configs[] = {
+        {"SAD scalar, 1 thread", SAD, false, 1},
+        {"SAD sad_epu8, 1 thread", SAD, true, 1},
+        {"SAD sad_epu8, N threads", SAD, true, threads},
+        {"SSD scalar, 1 thread", SSD, false, 1},
+        {"SSD madd_epi16, 1 thread", SSD, true, 1},
+        {"SSD madd_epi16, N threads", SSD, true, threads},
+    };
+    const double positions = static_cast<double>(TEMPLATE_IMAGE_W - TEMPLATE_SIZE + 1) *
+                             (TEMPLATE_IMAGE_H - TEMPLATE_SIZE + 1);
+    Match reference[2];
+    for (const TemplateConfig& config : template_configs) {
+        Match match;
+        double seconds = elapsed_seconds([&]() {
+            match = match_template(image.data(), TEMPLATE_IMAGE_W, TEMPLATE_IMAGE_H, templ.data(), TEMPLATE_SIZE,
+                                   config.metric, config.simd, config.threads);
+        });
+        if (!config.simd) reference[config.metric] = match;
+        bool ok = match.x == TEMPLATE_X && match.y == TEMPLATE_Y && match.score == reference[config.metric].score;
+        all_ok = all_ok && ok;
+        std::cout << std::left << std::setw(28) << config.label << std::right << std::fixed
+                  << std::setw(9) << std::setprecision(1) << seconds * 1e3 << " ms"
+                  << std::setw(9) << std::setprecision(2) << positions / seconds / 1e6 << " Mpos/s"
+                  << "   (" << match.x << "," << match.y << ") " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+    std::cout << std::endl;
+
+    // 2. Block motion search
+    std::vector<uint8_t> ref = make_texture(WIDTH, HEIGHT, 3);
+    std::vector<uint8_t> cur(ref.size());
+    std::uniform_int_distribution<int> noise(-2, 2);
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            bool object = x >= OBJECT_X && x < OBJECT_X + OBJECT_SIZE && y >= OBJECT_Y && y < OBJECT_Y + OBJECT_SIZE;
+            int sx = x + (object ? OBJECT_DX : GLOBAL_DX), sy = y + (object ? OBJECT_DY : GLOBAL_DY);
+            sx = std::min(WIDTH - 1, std::max(0, sx));
+            sy = std::min(HEIGHT - 1, std::max(0, sy));
+            int v = ref[sy * WIDTH + sx] + noise(gen);
+            cur[y * WIDTH + x] = static_cast<uint8_t>(std::min(255, std::max(0, v)));
+        }
+    }
+
+    for (int size : {8, 16}) {
+        int blocks = (WIDTH / size) * (HEIGHT / size);
+        std::cout << "2. Block Motion Search (" << size << "x" << size << ", +/-" << SEARCH_RANGE
+                  << ", " << blocks << " blocks, N = " << threads << ")" << std::endl;
+        std::cout << "---------------------------------------------------" << std::endl;
+
+        struct SearchConfig {
+            const char* label;
+            SearchMode mode;
+            int threads;
+        };
+        const SearchConfig search_configs[] = {
+            {"Exhaustive scalar, 1 thread", EXHAUSTIVE_SCALAR, 1},
+            {"Exhaustive mpsadbw, 1 thread", EXHAUSTIVE_SIMD, 1},
+            {"Exhaustive mpsadbw, N threads", EXHAUSTIVE_SIMD, threads},
+            {"Diamond sad_epu8, 1 thread", DIAMOND, 1},
+            {"Diamond sad_epu8, N threads", DIAMOND, threads},
+        };
+
+        std::vector<MotionVector> exhaustive;
+        for (const SearchConfig& config : search_configs) {
+            std::vector<MotionVector> vectors;
+            double seconds = elapsed_seconds([&]() {
+                vectors = motion_search(cur.data(), ref.data(), size, config.mode, config.threads);
+            });
+            if (config.mode == EXHAUSTIVE_SCALAR) exhaustive = vectors;
+
+            std::cout << std::left << std::setw(31) << config.label << std::right << std::fixed
+                      << std::setw(12) << std::setprecision(0) << blocks / seconds << " blocks/s"
+                      << std::setw(8) << std::setprecision(1) << true_motion_ratio(vectors, size) * 100.0 << "% true MV";
+            if (config.mode == EXHAUSTIVE_SIMD) {
+                bool ok = same_vectors(vectors, exhaustive);
+                all_ok = all_ok && ok;
+                std::cout << "   " << (ok ? "OK" : "MISMATCH");
+            } else if (config.mode == DIAMOND) {
+                int agree = 0;
+                for (size_t i = 0; i < vectors.size(); i++) {
+                    agree += vectors[i].dx == exhaustive[i].dx && vectors[i].dy == exhaustive[i].dy;
+                }
+                std::cout << "   " << std::setprecision(1) << 100.0 * agree / vectors.size() << "% = exhaustive";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    // The mpsadbw kernel against its scalar reference at every offset
+    bool x8_ok = true;
+    for (int size : {8, 16}) {
+        for (int offset = 0; offset < 64; offset += 7) {
+            uint16_t expected[8], actual[8];
+            block_sad_x8_scalar(cur.data() + offset, WIDTH, ref.data() + 3 * offset, WIDTH, size, expected);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(actual),
+                             block_sad_x8_simd(cur.data() + offset, WIDTH, ref.data() + 3 * offset, WIDTH, size));
+            x8_ok = x8_ok && std::equal(expected, expected + 8, actual);
+        }
+    }
+    std::cout << "block_sad_x8_simd vs scalar: " << (x8_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && x8_ok;
+
+    return all_ok ? 0 : 1;
+}
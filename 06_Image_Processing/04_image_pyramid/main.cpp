@@ -0,0 +1,180 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_pyramid.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <cstring>
+
+/**
+ * 06_Image_Processing/04_image_pyramid - Gaussian and Laplacian pyramids
+ *
+ * Multiscale detection runs the same detector on successively halved copies of
+ * the image. Each level is a 5-tap Gaussian blur of the previous one followed by
+ * dropping every other row and column. Done naively, that writes a full-size
+ * blurred image and then reads it again to decimate; simd_pyramid.h fuses the two,
+ * filtering only the rows that survive and decimating each one while it is still
+ * in cache.
+ *
+ * We'll:
+ * 1. Compare the scalar and fused SIMD downsample for grayscale and RGB
+ * 2. Compare fused against blur-then-decimate (both SIMD)
+ * 3. Build whole pyramids into one reused arena vs fresh per-level buffers
+ * 4. Build a Laplacian pyramid and check that it reconstructs the image exactly
+ */
+
+const int WIDTH = 1920;
+const int HEIGHT = 1080;
+
+// Gradient test image with some texture so the blur has something to do
+std::vector<uint8_t> make_image(int channels) {
+    std::vector<uint8_t> image(static_cast<size_t>(WIDTH) * HEIGHT * channels);
+    if (channels == RGB_CHANNELS) {
+        initialize_test_image(image.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+    } else {
+        std::vector<uint8_t> rgb(static_cast<size_t>(WIDTH) * HEIGHT * RGB_CHANNELS);
+        initialize_test_image(rgb.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+        convert_to_grayscale_simd(rgb.data(), image.data(), WIDTH, HEIGHT);
+    }
+    std::mt19937 gen(5);
+    for (uint8_t& v : image) {
+        v = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(v) + static_cast<int>(gen() % 31) - 15)));
+    }
+    return image;
+}
+
+// 2. Blur the whole image at full resolution, then decimate in a second pass
+void pyr_down_unfused(const uint8_t* src, int width, int height, int channels, uint8_t* blurred, uint8_t* dst) {
+    std::vector<uint16_t> vrow(static_cast<size_t>(width + 4) * channels);
+    std::vector<uint8_t> row(static_cast<size_t>(width) * channels + 32);
+    const size_t row_bytes = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height; y++) {
+        pyr_filter_row_simd(src, width, height, channels, y, vrow.data(), row.data());
+        std::memcpy(blurred + y * row_bytes, row.data(), row_bytes);
+    }
+    int out_w = (width + 1) / 2, out_h = (height + 1) / 2;
+    for (int y = 0; y < out_h; y++) {
+        std::memcpy(row.data(), blurred + 2 * y * row_bytes, row_bytes);
+        pyr_decimate_row_simd(row.data(), out_w, channels, dst + static_cast<size_t>(y) * out_w * channels);
+    }
+}
+
+// 3. The same pyramid with a fresh buffer per level, as a per-frame allocation would
+std::vector<std::vector<uint8_t>> build_separate(const uint8_t* image, int channels) {
+    std::vector<std::vector<uint8_t>> levels;
+    levels.emplace_back(image, image + static_cast<size_t>(WIDTH) * HEIGHT * channels);
+    int w = WIDTH, h = HEIGHT;
+    while ((w + 1) / 2 >= 8 && (h + 1) / 2 >= 8) {
+        int nw = (w + 1) / 2, nh = (h + 1) / 2;
+        levels.emplace_back(static_cast<size_t>(nw) * nh * channels);
+        pyr_down_simd(levels[levels.size() - 2].data(), w, h, channels, levels.back().data());
+        w = nw;
+        h = nh;
+    }
+    return levels;
+}
+
+int main() {
+    std::cout << "=== SIMD Image Pyramids ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    const int out_w = (WIDTH + 1) / 2, out_h = (HEIGHT + 1) / 2;
+
+    for (int channels : {1, RGB_CHANNELS}) {
+        const char* name = channels == 1 ? "grayscale" : "RGB";
+        std::vector<uint8_t> image = make_image(channels);
+        std::vector<uint8_t> down_scalar(static_cast<size_t>(out_w) * out_h * channels);
+        std::vector<uint8_t> down_simd(down_scalar.size());
+        std::vector<uint8_t> down_unfused(down_scalar.size());
+        std::vector<uint8_t> blurred(image.size());
+
+        // 1. Scalar vs fused SIMD
+        std::cout << "1. Downsample " << WIDTH << "x" << HEIGHT << " " << name << " -> "
+                  << out_w << "x" << out_h << std::endl;
+        std::cout << "---------------------------------------------------" << std::endl;
+        benchmark_comparison(std::string("pyr_down ") + name,
+            [&]() { pyr_down_scalar(image.data(), WIDTH, HEIGHT, channels, down_scalar.data()); },
+            [&]() { pyr_down_simd(image.data(), WIDTH, HEIGHT, channels, down_simd.data()); },
+            20);
+        bool down_ok = down_scalar == down_simd;
+        std::cout << "Results: " << (down_ok ? "OK" : "MISMATCH") << std::endl;
+        std::cout << std::endl;
+        all_ok = all_ok && down_ok;
+
+        // 2. Fused vs blur-then-decimate
+        std::cout << "2. Fused vs Blur-then-Decimate (" << name << ")" << std::endl;
+        std::cout << "---------------------------------------------------" << std::endl;
+        double unfused_us = measure_microseconds([&]() {
+            pyr_down_unfused(image.data(), WIDTH, HEIGHT, channels, blurred.data(), down_unfused.data());
+        }, 50);
+        double fused_us = measure_microseconds([&]() {
+            pyr_down_simd(image.data(), WIDTH, HEIGHT, channels, down_simd.data());
+        }, 50);
+        bool fused_ok = down_unfused == down_simd;
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Blur, then decimate: " << std::setw(8) << unfused_us << " us" << std::endl;
+        std::cout << "Fused:               " << std::setw(8) << fused_us << " us  ("
+                  << std::setprecision(2) << unfused_us / fused_us << "x)" << std::endl;
+        std::cout << "Results: " << (fused_ok ? "OK" : "MISMATCH") << std::endl;
+        std::cout << std::endl;
+        all_ok = all_ok && fused_ok;
+
+        // 3. Whole pyramid
+        std::cout << "3. Pyramid Build (" << name << ")" << std::endl;
+        std::cout << "---------------------------------------------------" << std::endl;
+        GaussianPyramid pyramid(WIDTH, HEIGHT, channels);
+        double arena_us = measure_microseconds([&]() { pyramid.build(image.data()); }, 50);
+        std::vector<std::vector<uint8_t>> separate;
+        double separate_us = measure_microseconds([&]() { separate = build_separate(image.data(), channels); }, 50);
+
+        bool pyramid_ok = static_cast<int>(separate.size()) == pyramid.levels();
+        for (int i = 0; pyramid_ok && i < pyramid.levels(); i++) {
+            const PyramidLevel& l = pyramid.level_info(i);
+            pyramid_ok = std::memcmp(pyramid.level(i), separate[i].data(), l.size()) == 0;
+            if (channels == 1) {
+                std::cout << "  level " << i << ": " << std::setw(4) << l.width << "x" << std::left
+                          << std::setw(5) << l.height << std::right << " at offset " << l.offset << std::endl;
+            }
+        }
+        std::cout << pyramid.levels() << " levels, arena " << pyramid.arena_size() / 1024 << " KB" << std::endl;
+        std::cout << std::setprecision(1);
+        std::cout << "Fresh buffers per level: " << std::setw(8) << separate_us << " us" << std::endl;
+        std::cout << "Reused arena:            " << std::setw(8) << arena_us << " us" << std::endl;
+        std::cout << "Results: " << (pyramid_ok ? "OK" : "MISMATCH") << std::endl;
+        std::cout << std::endl;
+        all_ok = all_ok && pyramid_ok;
+
+        // 4. Laplacian pyramid
+        std::cout << "4. Laplacian Pyramid (" << name << ")" << std::endl;
+        std::cout << "---------------------------------------------------" << std::endl;
+        std::vector<uint8_t> restored(image.size());
+        double laplacian_us = measure_microseconds([&]() { LaplacianPyramid laplacian(pyramid); }, 5);
+        LaplacianPyramid laplacian(pyramid);
+        double reconstruct_us = measure_microseconds([&]() { laplacian.reconstruct(restored.data()); }, 5);
+        bool lap_ok = restored == image;
+        std::cout << "Build:       " << std::setw(8) << laplacian_us << " us" << std::endl;
+        std::cout << "Reconstruct: " << std::setw(8) << reconstruct_us << " us" << std::endl;
+        std::cout << "Exact reconstruction: " << (lap_ok ? "OK" : "MISMATCH") << std::endl;
+        std::cout << std::endl;
+        all_ok = all_ok && lap_ok;
+    }
+
+    // Odd sizes exercise the border replication and the scalar tails
+    bool odd_ok = true;
+    for (int channels : {1, 3, 4}) {
+        const int w = 37, h = 23;
+        std::vector<uint8_t> src(static_cast<size_t>(w) * h * channels);
+        std::mt19937 gen(channels);
+        for (uint8_t& v : src) v = static_cast<uint8_t>(gen());
+        std::vector<uint8_t> a(static_cast<size_t>((w + 1) / 2) * ((h + 1) / 2) * channels), b(a.size());
+        pyr_down_scalar(src.data(), w, h, channels, a.data());
+        pyr_down_simd(src.data(), w, h, channels, b.data());
+        odd_ok = odd_ok && a == b;
+    }
+    std::cout << "Odd sizes (37x23, 1/3/4 channels): " << (odd_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && odd_ok;
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_color.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+
+/**
+ * 06_Image_Processing/07_color_matrix - 3x4 color matrix / channel mixer
+ *
+ * Grayscale conversion is one case of a general per-pixel transform: each output
+ * channel is a weighted sum of R, G and B plus an offset. simd_color.h evaluates
+ * an arbitrary 3x4 matrix in 16-bit fixed point over deinterleaved RGB, 32 pixels
+ * per iteration, so saturation, hue rotation, sepia, white balance and
+ * contrast/brightness are all the same kernel.
+ *
+ * We'll:
+ * 1. Benchmark scalar vs SIMD and check every preset against a float reference
+ * 2. Compare the grayscale matrix with convert_to_grayscale_simd
+ * 3. Apply a chain of three adjustments as three passes and as one composed matrix
+ */
+
+const int WIDTH = 1920;
+const int HEIGHT = 1080;
+const size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+const size_t BYTES = PIXELS * RGB_CHANNELS;
+
+// Largest difference from the matrix evaluated in double precision
+int max_error_vs_float(const uint8_t* src, const uint8_t* dst, size_t pixels, const ColorMatrix& c) {
+    int worst = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            double v = c.m[ch][3];
+            for (int k = 0; k < 3; k++) v += static_cast<double>(c.m[ch][k]) * src[i * 3 + k];
+            int expected = static_cast<int>(std::lround(std::min(255.0, std::max(0.0, v))));
+            worst = std::max(worst, std::abs(expected - dst[i * 3 + ch]));
+        }
+    }
+    return worst;
+}
+
+int max_difference(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    int worst = 0;
+    for (size_t i = 0; i < a.size(); i++) worst = std::max(worst, std::abs(a[i] - b[i]));
+    return worst;
+}
+
+int main() {
+    std::cout << "=== SIMD Color Matrix ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    std::vector<uint8_t> image(BYTES);
+    initialize_test_image(image.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+    std::vector<uint8_t> out_scalar(BYTES), out_simd(BYTES);
+
+    // 1. Presets
+    std::cout << "1. Presets (" << WIDTH << "x" << HEIGHT << " RGB)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    FixedColorMatrix sepia(ColorMatrix::sepia());
+    benchmark_comparison("Sepia",
+        [&]() { apply_color_matrix_scalar(image.data(), out_scalar.data(), PIXELS, sepia); },
+        [&]() { apply_color_matrix_simd(image.data(), out_simd.data(), PIXELS, sepia); },
+        20);
+
+    struct Preset {
+        const char* name;
+        ColorMatrix matrix;
+    };
+    const Preset presets[] = {
+        {"grayscale", ColorMatrix::grayscale()},
+        {"saturation 1.6", ColorMatrix::saturation(1.6f)},
+        {"hue +90", ColorMatrix::hue_rotate(90.0f)},
+        {"sepia", ColorMatrix::sepia()},
+        {"white balance", ColorMatrix::white_balance(1.12f, 1.0f, 0.86f)},
+        {"contrast+bright", ColorMatrix::contrast_brightness(1.3f, 25.0f)},
+        {"swap R/B", {{{0, 0, 1, 0}, {0, 1, 0, 0}, {1, 0, 0, 0}}}},
+    };
+    std::cout << std::left << std::setw(17) << "Preset" << std::right << std::setw(11) << "Scalar us"
+              << std::setw(10) << "SIMD us" << std::setw(10) << "Max err" << std::endl;
+    for (const Preset& p : presets) {
+        FixedColorMatrix fm(p.matrix);
+        double scalar_us = measure_microseconds([&]() {
+            apply_color_matrix_scalar(image.data(), out_scalar.data(), PIXELS, fm);
+        }, 10);
+        double simd_us = measure_microseconds([&]() {
+            apply_color_matrix_simd(image.data(), out_simd.data(), PIXELS, fm);
+        }, 10);
+        int error = max_error_vs_float(image.data(), out_simd.data(), PIXELS, p.matrix);
+        bool ok = out_scalar == out_simd && error <= 1;
+        all_ok = all_ok && ok;
+        std::cout << std::left << std::setw(17) << p.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(11) << scalar_us << std::setw(10) << simd_us << std::setw(10) << error
+                  << "  " << (ok ? "OK" : "MISMATCH") << std::endl;
+    }
+    std::cout << std::endl;
+
+    // 2. Grayscale as a matrix
+    std::cout << "2. Grayscale Matrix vs convert_to_grayscale_simd" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint8_t> gray(PIXELS), gray_ref(PIXELS);
+    FixedColorMatrix gray_matrix(ColorMatrix::grayscale());
+    double convert_us = measure_microseconds([&]() {
+        convert_to_grayscale_simd(image.data(), gray.data(), WIDTH, HEIGHT);
+    }, 20);
+    double matrix_us = measure_microseconds([&]() {
+        apply_color_matrix_simd(image.data(), out_simd.data(), PIXELS, gray_matrix);
+    }, 20);
+    convert_to_grayscale_scalar(image.data(), gray_ref.data(), WIDTH, HEIGHT);
+    int gray_diff = 0;
+    for (size_t i = 0; i < PIXELS; i++) gray_diff = std::max(gray_diff, std::abs(out_simd[i * 3] - gray_ref[i]));
+    std::cout << "convert_to_grayscale_simd (1 channel out): " << std::setw(8) << convert_us << " us" << std::endl;
+    std::cout << "Grayscale matrix (3 channels out):         " << std::setw(8) << matrix_us << " us" << std::endl;
+    // convert_to_grayscale truncates, the matrix rounds
+    bool gray_ok = gray_diff <= 1;
+    std::cout << "Max difference " << gray_diff << ": " << (gray_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && gray_ok;
+
+    // 3. Composition
+    std::cout << "3. White Balance -> Saturation -> Hue: Passes vs Composed" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    const ColorMatrix steps[] = {ColorMatrix::white_balance(1.08f, 1.0f, 0.9f), ColorMatrix::saturation(1.3f),
+                                 ColorMatrix::hue_rotate(-20.0f)};
+    const FixedColorMatrix fixed_steps[] = {FixedColorMatrix(steps[0]), FixedColorMatrix(steps[1]),
+                                            FixedColorMatrix(steps[2])};
+    ColorMatrix chain = steps[0].then(steps[1]).then(steps[2]);
+    FixedColorMatrix fixed_chain(chain);
+    double passes_us = measure_microseconds([&]() {
+        apply_color_matrix_simd(image.data(), out_scalar.data(), PIXELS, fixed_steps[0]);
+        apply_color_matrix_simd(out_scalar.data(), out_scalar.data(), PIXELS, fixed_steps[1]);
+        apply_color_matrix_simd(out_scalar.data(), out_scalar.data(), PIXELS, fixed_steps[2]);
+    }, 20);
+    double composed_us = measure_microseconds([&]() {
+        apply_color_matrix_simd(image.data(), out_simd.data(), PIXELS, fixed_chain);
+    }, 20);
+    int chain_error = max_error_vs_float(image.data(), out_simd.data(), PIXELS, chain);
+    std::cout << "Three passes (in place): " << std::setw(8) << passes_us << " us" << std::endl;
+    std::cout << "One composed matrix:     " << std::setw(8) << composed_us << " us  (" << std::setprecision(2)
+              << passes_us / composed_us << "x)" << std::endl;
+    std::cout << "Passes differ from composed by up to " << max_difference(out_scalar, out_simd)
+              << " (intermediate rounding and clipping)" << std::endl;
+    bool chain_ok = chain_error <= 1;
+    std::cout << "Composed vs float reference, max error " << chain_error << ": "
+              << (chain_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && chain_ok;
+
+    // Odd pixel counts exercise the scalar tail
+    bool odd_ok = true;
+    std::mt19937 gen(3);
+    for (size_t pixels : {1, 31, 33, 95}) {
+        std::vector<uint8_t> src(pixels * 3), a(src.size()), b(src.size());
+        for (uint8_t& v : src) v = static_cast<uint8_t>(gen());
+        FixedColorMatrix fm(ColorMatrix::hue_rotate(static_cast<float>(pixels)));
+        apply_color_matrix_scalar(src.data(), a.data(), pixels, fm);
+        apply_color_matrix_simd(src.data(), b.data(), pixels, fm);
+        odd_ok = odd_ok && a == b;
+    }
+    std::cout << "Odd pixel counts (1, 31, 33, 95): " << (odd_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && odd_ok;
+
+    return all_ok ? 0 : 1;
+}
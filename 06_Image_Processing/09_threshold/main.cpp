@@ -0,0 +1,187 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_threshold.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+
+/**
+ * 06_Image_Processing/09_threshold - Binarizing scanned documents
+ *
+ * The document-scanning path turns a photographed page into a black/white mask
+ * before anything else. A global threshold works on an evenly lit page; a phone
+ * photo darkens toward one corner, and there the paper ends up darker than the ink
+ * on the bright side. An adaptive threshold compares each pixel with the mean of
+ * its neighbourhood instead.
+ *
+ * We'll:
+ * 1. Render a 2048x1536 page with text-like strokes and a strong lighting falloff,
+ *    and convert it with convert_to_grayscale_simd
+ * 2. Build the histogram (scalar vs SIMD) and pick Otsu's threshold
+ * 3. Apply it as a byte mask and as a packed 1-bit mask
+ * 4. Build the integral image and apply the adaptive threshold
+ * 5. Compare both masks with the known ink positions
+ */
+
+const int WIDTH = 2048;
+const int HEIGHT = 1536;
+const size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+
+const int RADIUS = 12;
+const int OFFSET = 12;
+
+// Page with lines of glyph-like strokes; truth marks the ink pixels
+void render_page(std::vector<uint8_t>& rgb, std::vector<uint8_t>& truth) {
+    std::mt19937 gen(21);
+    truth.assign(PIXELS, 0);
+    for (int line_y = 60; line_y + 24 < HEIGHT - 40; line_y += 44) {
+        for (int x = 80; x + 14 < WIDTH - 80; x += 16) {
+            if (gen() % 9 == 0) continue;  // word gap
+            int strokes = 2 + gen() % 3;
+            for (int s = 0; s < strokes; s++) {
+                bool vertical = gen() % 2;
+                int sx = x + gen() % 10, sy = line_y + gen() % 16;
+                int w = vertical ? 3 : 6 + gen() % 6, h = vertical ? 10 + gen() % 12 : 3;
+                for (int yy = sy; yy < std::min(HEIGHT, sy + h); yy++) {
+                    for (int xx = sx; xx < std::min(WIDTH, sx + w); xx++) truth[static_cast<size_t>(yy) * WIDTH + xx] = 1;
+                }
+            }
+        }
+    }
+    // Light falls off toward the bottom-right corner; ink reflects a third of it
+    rgb.resize(PIXELS * RGB_CHANNELS);
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float fx = static_cast<float>(x) / WIDTH, fy = static_cast<float>(y) / HEIGHT;
+            float light = 240.0f - 150.0f * fx * fy - 30.0f * fy;
+            size_t i = static_cast<size_t>(y) * WIDTH + x;
+            float level = truth[i] ? light * 0.35f : light;
+            int noise = static_cast<int>(gen() % 13) - 6;
+            uint8_t* p = rgb.data() + i * RGB_CHANNELS;
+            p[0] = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(level) + noise)));
+            p[1] = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(level * 0.97f) + noise)));
+            p[2] = static_cast<uint8_t>(std::min(255, std::max(0, static_cast<int>(level * 0.9f) + noise)));
+        }
+    }
+}
+
+// Share of pixels where the ink mask disagrees with the truth
+double error_rate(const std::vector<uint8_t>& ink, const std::vector<uint8_t>& truth) {
+    size_t wrong = 0;
+    for (size_t i = 0; i < PIXELS; i++) wrong += (ink[i] != 0) != (truth[i] != 0);
+    return 100.0 * wrong / PIXELS;
+}
+
+int main() {
+    std::cout << "=== SIMD Thresholding ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+
+    // 1. Page
+    std::vector<uint8_t> rgb, truth;
+    render_page(rgb, truth);
+    std::vector<uint8_t> gray(PIXELS);
+    convert_to_grayscale_simd(rgb.data(), gray.data(), WIDTH, HEIGHT);
+
+    // 2. Histogram and Otsu
+    std::cout << "1. Histogram + Otsu (" << WIDTH << "x" << HEIGHT << ")" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    uint32_t hist_scalar[256], hist_simd[256];
+    benchmark_comparison("Histogram",
+        [&]() { histogram_scalar(gray.data(), PIXELS, hist_scalar); },
+        [&]() { histogram_simd(gray.data(), PIXELS, hist_simd); },
+        20);
+    uint8_t t = otsu_threshold(hist_simd);
+    bool hist_ok = std::equal(hist_scalar, hist_scalar + 256, hist_simd);
+    std::cout << "Otsu threshold: " << int(t) << std::endl;
+    std::cout << "Results: " << (hist_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && hist_ok;
+
+    // 3. Global threshold, ink selected with invert
+    std::cout << "2. Global Threshold" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint8_t> global_scalar(PIXELS), global_simd(PIXELS);
+    benchmark_comparison("Byte mask",
+        [&]() { threshold_scalar(gray.data(), global_scalar.data(), PIXELS, t, true); },
+        [&]() { threshold_simd(gray.data(), global_simd.data(), PIXELS, t, true); },
+        50);
+    const size_t bits_size = bit_mask_stride(WIDTH) * HEIGHT;
+    std::vector<uint8_t> bits_scalar(bits_size), bits_simd(bits_size), bits_from_mask(bits_size);
+    benchmark_comparison("Packed bits",
+        [&]() { threshold_bits_scalar(gray.data(), bits_scalar.data(), WIDTH, HEIGHT, t, true); },
+        [&]() { threshold_bits_simd(gray.data(), bits_simd.data(), WIDTH, HEIGHT, t, true); },
+        50);
+    mask_to_bits_simd(global_simd.data(), bits_from_mask.data(), WIDTH, HEIGHT);
+    std::cout << "Packed mask: " << bits_size / 1024 << " KB vs " << PIXELS / 1024 << " KB as bytes" << std::endl;
+    bool global_ok = global_scalar == global_simd && bits_scalar == bits_simd && bits_from_mask == bits_simd;
+    std::cout << "Results: " << (global_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && global_ok;
+
+    // 4. Adaptive threshold
+    std::cout << "3. Adaptive Threshold (" << 2 * RADIUS + 1 << "x" << 2 * RADIUS + 1 << " window)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint32_t> sums_scalar((WIDTH + 1) * (HEIGHT + 1)), sums_simd(sums_scalar.size());
+    benchmark_comparison("Integral image",
+        [&]() { integral_image_scalar(gray.data(), sums_scalar.data(), WIDTH, HEIGHT); },
+        [&]() { integral_image_simd(gray.data(), sums_simd.data(), WIDTH, HEIGHT); },
+        20);
+    std::vector<uint8_t> adaptive_scalar(PIXELS), adaptive_simd(PIXELS);
+    benchmark_comparison("Adaptive threshold",
+        [&]() { adaptive_threshold_scalar(gray.data(), sums_simd.data(), adaptive_scalar.data(), WIDTH, HEIGHT, RADIUS, OFFSET, true); },
+        [&]() { adaptive_threshold_simd(gray.data(), sums_simd.data(), adaptive_simd.data(), WIDTH, HEIGHT, RADIUS, OFFSET, true); },
+        20);
+    double global_us = measure_microseconds([&]() {
+        histogram_simd(gray.data(), PIXELS, hist_simd);
+        threshold_simd(gray.data(), global_simd.data(), PIXELS, otsu_threshold(hist_simd), true);
+    }, 20);
+    double adaptive_us = measure_microseconds([&]() {
+        integral_image_simd(gray.data(), sums_simd.data(), WIDTH, HEIGHT);
+        adaptive_threshold_simd(gray.data(), sums_simd.data(), adaptive_simd.data(), WIDTH, HEIGHT, RADIUS, OFFSET, true);
+    }, 20);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Otsu + global total:       " << std::setw(8) << global_us << " us" << std::endl;
+    std::cout << "Integral + adaptive total: " << std::setw(8) << adaptive_us << " us" << std::endl;
+    bool adaptive_ok = sums_scalar == sums_simd && adaptive_scalar == adaptive_simd;
+    std::cout << "Results: " << (adaptive_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && adaptive_ok;
+
+    // 5. Quality
+    std::cout << "4. Misclassified Pixels vs Known Ink" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    double global_error = error_rate(global_simd, truth);
+    double adaptive_error = error_rate(adaptive_simd, truth);
+    std::cout << std::setprecision(2);
+    std::cout << "Global (Otsu t=" << int(t) << "): " << std::setw(6) << global_error << "%" << std::endl;
+    std::cout << "Adaptive:           " << std::setw(6) << adaptive_error << "%" << std::endl;
+    bool quality_ok = adaptive_error < global_error;
+    std::cout << "Adaptive beats global under uneven lighting: " << (quality_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && quality_ok;
+
+    // Odd sizes exercise the scalar tails and clipped windows
+    bool odd_ok = true;
+    std::mt19937 gen(4);
+    for (int w : {1, 7, 33, 70}) {
+        const int h = 9;
+        std::vector<uint8_t> g(static_cast<size_t>(w) * h);
+        for (uint8_t& v : g) v = static_cast<uint8_t>(gen());
+        std::vector<uint8_t> a(bit_mask_stride(w) * h), b(a.size()), m1(g.size()), m2(g.size());
+        std::vector<uint32_t> s1((w + 1) * (h + 1)), s2(s1.size());
+        threshold_bits_scalar(g.data(), a.data(), w, h, 100);
+        threshold_bits_simd(g.data(), b.data(), w, h, 100);
+        integral_image_scalar(g.data(), s1.data(), w, h);
+        integral_image_simd(g.data(), s2.data(), w, h);
+        adaptive_threshold_scalar(g.data(), s1.data(), m1.data(), w, h, 3, -5);
+        adaptive_threshold_simd(g.data(), s2.data(), m2.data(), w, h, 3, -5);
+        odd_ok = odd_ok && a == b && s1 == s2 && m1 == m2;
+    }
+    std::cout << "Odd sizes (1, 7, 33, 70 wide): " << (odd_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && odd_ok;
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_threshold.h"
+#include "../../include/simd_ccl.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+
+/**
+ * 06_Image_Processing/10_connected_components - Blob extraction from masks
+ *
+ * After thresholding, the document path needs the blobs: characters, marks,
+ * stamps, each with its area and bounding box. The textbook labeler visits every
+ * pixel and its already-labeled neighbours. simd_ccl.h works on the packed 1-bit
+ * mask instead: tzcnt turns each 64-pixel word into runs, and union-find merges
+ * runs that touch runs in the row above, so the work scales with the number of
+ * runs. Threads label row bands on their own and a short merge step joins them.
+ *
+ * We'll:
+ * 1. Threshold a 2048x1536 page (glyph strokes plus a few large blobs) to bits
+ * 2. Compare scalar run extraction from bytes with tzcnt extraction from bits
+ * 3. Label with the pixel-based two-pass labeler, and run-based with 1 and N
+ *    threads, checking that all three find the same components
+ * 4. Compare 4- and 8-connectivity
+ * 5. Check random masks of awkward widths against the pixel-based labeler
+ */
+
+const int WIDTH = 2048;
+const int HEIGHT = 1536;
+const size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+
+// Gray page: dark strokes and discs on a light background
+std::vector<uint8_t> render_page() {
+    std::vector<uint8_t> gray(PIXELS, 220);
+    std::mt19937 gen(8);
+    for (int line_y = 40; line_y + 24 < HEIGHT; line_y += 40) {
+        for (int x = 40; x + 14 < WIDTH - 40; x += 15) {
+            if (gen() % 7 == 0) continue;
+            for (int s = 0, strokes = 1 + gen() % 3; s < strokes; s++) {
+                bool vertical = gen() % 2;
+                int sx = x + gen() % 9, sy = line_y + gen() % 14;
+                int w = vertical ? 2 : 5 + gen() % 6, h = vertical ? 8 + gen() % 12 : 2;
+                for (int yy = sy; yy < std::min(HEIGHT, sy + h); yy++) {
+                    std::fill(gray.begin() + yy * WIDTH + sx, gray.begin() + yy * WIDTH + std::min(WIDTH, sx + w), 30);
+                }
+            }
+        }
+    }
+    for (int d = 0; d < 6; d++) {
+        int cx = 200 + gen() % (WIDTH - 400), cy = 200 + gen() % (HEIGHT - 400), r = 40 + gen() % 80;
+        for (int y = cy - r; y <= cy + r; y++) {
+            for (int x = cx - r; x <= cx + r; x++) {
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) gray[static_cast<size_t>(y) * WIDTH + x] = 20;
+            }
+        }
+    }
+    return gray;
+}
+
+// Textbook two-pass labeling over a byte mask, for comparison
+std::vector<Component> label_pixels(const uint8_t* mask, int width, int height, std::vector<int32_t>& labels,
+                                    bool eight_connected = true) {
+    labels.assign(static_cast<size_t>(width) * height, -1);
+    std::vector<int32_t> parent;
+    auto find = [&](int32_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            if (!mask[i]) continue;
+            int32_t best = -1;
+            // Left, up, then the diagonals for 8-connectivity
+            const int nx[4] = {-1, 0, -1, 1}, ny[4] = {0, -1, -1, -1};
+            for (int k = 0; k < (eight_connected ? 4 : 2); k++) {
+                int xx = x + nx[k], yy = y + ny[k];
+                if (xx < 0 || xx >= width || yy < 0) continue;
+                int32_t l = labels[static_cast<size_t>(yy) * width + xx];
+                if (l < 0) continue;
+                l = find(l);
+                if (best < 0) {
+                    best = l;
+                } else if (l != best) {
+                    parent[std::max(l, best)] = std::min(l, best);
+                    best = std::min(l, best);
+                }
+            }
+            if (best < 0) {
+                best = static_cast<int32_t>(parent.size());
+                parent.push_back(best);
+            }
+            labels[i] = best;
+        }
+    }
+    // Provisional labels were created in raster order, so roots come first
+    std::vector<int32_t> final_label(parent.size());
+    std::vector<Component> components;
+    for (size_t l = 0; l < parent.size(); l++) {
+        int32_t root = find(static_cast<int32_t>(l));
+        if (root == static_cast<int32_t>(l)) {
+            final_label[l] = static_cast<int32_t>(components.size());
+            components.push_back({0, width, height, -1, -1});
+        } else {
+            final_label[l] = final_label[root];
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int32_t& l = labels[static_cast<size_t>(y) * width + x];
+            if (l < 0) continue;
+            l = final_label[l];
+            Component& c = components[l];
+            c.area++;
+            c.x0 = std::min(c.x0, x);
+            c.y0 = std::min(c.y0, y);
+            c.x1 = std::max(c.x1, x);
+            c.y1 = std::max(c.y1, y);
+        }
+    }
+    return components;
+}
+
+bool same_components(const std::vector<Component>& a, const std::vector<Component>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].area != b[i].area || a[i].x0 != b[i].x0 || a[i].y0 != b[i].y0 || a[i].x1 != b[i].x1 ||
+            a[i].y1 != b[i].y1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Connected-Component Labeling ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    const int threads = std::max(4u, std::thread::hardware_concurrency());
+
+    // 1. Mask
+    std::vector<uint8_t> gray = render_page();
+    std::vector<uint8_t> mask(PIXELS), bits(bit_mask_stride(WIDTH) * HEIGHT);
+    threshold_simd(gray.data(), mask.data(), PIXELS, 128, true);
+    threshold_bits_simd(gray.data(), bits.data(), WIDTH, HEIGHT, 128, true);
+
+    // 2. Runs
+    std::cout << "1. Run Extraction (" << WIDTH << "x" << HEIGHT << ")" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<Run> runs_scalar, runs_bits;
+    const size_t stride_words = bit_mask_stride(WIDTH) / 8;
+    benchmark_comparison("Runs",
+        [&]() {
+            runs_scalar.clear();
+            for (int y = 0; y < HEIGHT; y++) extract_runs_scalar(mask.data() + y * WIDTH, WIDTH, y, runs_scalar);
+        },
+        [&]() {
+            runs_bits.clear();
+            const uint64_t* words = reinterpret_cast<const uint64_t*>(bits.data());
+            for (int y = 0; y < HEIGHT; y++) extract_runs_bits(words + y * stride_words, WIDTH, y, runs_bits);
+        },
+        20);
+    bool runs_ok = runs_scalar.size() == runs_bits.size();
+    for (size_t i = 0; runs_ok && i < runs_bits.size(); i++) {
+        runs_ok = runs_scalar[i].x0 == runs_bits[i].x0 && runs_scalar[i].x1 == runs_bits[i].x1 &&
+                  runs_scalar[i].y == runs_bits[i].y;
+    }
+    std::cout << runs_bits.size() << " runs" << std::endl;
+    std::cout << "Results: " << (runs_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && runs_ok;
+
+    // 3. Labeling
+    std::cout << "2. Labeling" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<int32_t> pixel_labels, run_labels(PIXELS);
+    std::vector<Component> reference;
+    double pixel_us = measure_microseconds([&]() {
+        reference = label_pixels(mask.data(), WIDTH, HEIGHT, pixel_labels);
+    }, 5);
+    ComponentLabeler labeler(WIDTH, HEIGHT);
+    std::vector<Component> single, banded;
+    double single_us = measure_microseconds([&]() { single = labeler.label(bits.data(), 1); }, 20);
+    double banded_us = measure_microseconds([&]() { banded = labeler.label(bits.data(), threads); }, 20);
+    labeler.paint(run_labels.data());
+    bool paint_ok = true;
+    for (size_t i = 0; i < PIXELS; i++) paint_ok = paint_ok && run_labels[i] == pixel_labels[i] + 1;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Pixel two-pass:          " << std::setw(9) << pixel_us << " us" << std::endl;
+    std::cout << "Runs + union-find:       " << std::setw(9) << single_us << " us  (" << std::setprecision(2)
+              << pixel_us / single_us << "x)" << std::endl;
+    std::cout << std::setprecision(1) << "Runs, " << threads << " bands:" << std::string(threads < 10 ? 11 : 10, ' ')
+              << std::setw(9) << banded_us << " us" << std::endl;
+    std::cout << reference.size() << " components" << std::endl;
+    std::vector<Component> largest = banded;
+    std::sort(largest.begin(), largest.end(), [](const Component& a, const Component& b) { return a.area > b.area; });
+    for (size_t i = 0; i < std::min<size_t>(3, largest.size()); i++) {
+        const Component& c = largest[i];
+        std::cout << "  area " << std::setw(6) << c.area << "  box (" << c.x0 << ", " << c.y0 << ") - (" << c.x1
+                  << ", " << c.y1 << ")" << std::endl;
+    }
+    bool label_ok = same_components(reference, single) && same_components(reference, banded) && paint_ok;
+    std::cout << "Results: " << (label_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && label_ok;
+
+    // 4. Connectivity: diagonal contacts no longer join under 4-connectivity
+    std::cout << "3. 4- vs 8-Connectivity" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<int32_t> unused;
+    std::vector<Component> reference4 = label_pixels(mask.data(), WIDTH, HEIGHT, unused, false);
+    ComponentLabeler labeler4(WIDTH, HEIGHT, false);
+    bool conn_ok = same_components(reference4, labeler4.label(bits.data(), threads)) &&
+                   reference4.size() >= reference.size();
+    std::cout << "8-connected: " << reference.size() << " components" << std::endl;
+    std::cout << "4-connected: " << reference4.size() << " components" << std::endl;
+    std::cout << "Results: " << (conn_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && conn_ok;
+
+    // 5. Random masks, awkward widths, several band counts
+    bool odd_ok = true;
+    std::mt19937 gen(6);
+    for (int w : {1, 63, 64, 65, 130, 200}) {
+        const int h = 47;
+        std::vector<uint8_t> g(static_cast<size_t>(w) * h), m(g.size()), b(bit_mask_stride(w) * h);
+        for (uint8_t& v : g) v = static_cast<uint8_t>(gen() % 100 < 45 ? 0 : 255);
+        threshold_simd(g.data(), m.data(), g.size(), 128, true);
+        threshold_bits_simd(g.data(), b.data(), w, h, 128, true);
+        for (bool eight : {true, false}) {
+            std::vector<Component> expected = label_pixels(m.data(), w, h, unused, eight);
+            ComponentLabeler small(w, h, eight);
+            for (int t : {1, 2, 3, 7, 47}) odd_ok = odd_ok && same_components(expected, small.label(b.data(), t));
+        }
+    }
+    std::cout << "Random masks (widths 1-200, 1-47 bands, 4/8-connected): " << (odd_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && odd_ok;
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_color.h"
+#include "../../include/simd_gamma.h"
+#include "../../include/simd_orientation.h"
+#include "../../include/simd_threshold.h"
+#include "../../include/simd_motion.h"
+#include "../../include/simd_pyramid.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+
+/**
+ * 06_Image_Processing/11_image_views - Regions of interest and padded rows
+ *
+ * Until now every kernel assumed rows stored back to back. Processing a region
+ * of interest meant copying it out, running the kernel and copying it back, and
+ * buffers with rows padded to 64 bytes could not be used at all. With the image
+ * views of simd_view.h each kernel also takes width, height, stride and channel
+ * count, and runs directly on the region.
+ *
+ * We'll:
+ * 1. Run every kernel family on an odd-sized region of a buffer with 64-byte
+ *    padded rows, writing into a region of another padded buffer, and compare
+ *    with the pointer kernels on tight copies; bytes outside the target region
+ *    must stay untouched
+ * 2. Brighten a region of a 1920x1080 frame in place vs copy out / process /
+ *    copy back
+ * 3. Compare whole-frame kernels on tight and padded rows
+ */
+
+const int WIDTH = 1920;
+const int HEIGHT = 1080;
+const uint8_t SENTINEL = 0xA5;
+
+// Rows padded to a multiple of 64 bytes, filled with SENTINEL or random samples
+template <typename T>
+struct PaddedImage {
+    std::vector<T> samples;
+    ImageViewT<T> view;
+
+    PaddedImage(int width, int height, int channels, unsigned seed = 0) {
+        size_t stride = (static_cast<size_t>(width) * channels * sizeof(T) + 63) / 64 * 64;
+        samples.assign(stride / sizeof(T) * height, static_cast<T>(SENTINEL));
+        std::mt19937 gen(seed);
+        if (seed) {
+            for (T& v : samples) v = static_cast<T>(gen() % 256);
+        }
+        view = ImageViewT<T>(samples.data(), width, height, channels, stride);
+    }
+};
+
+// Tight copy of a view
+template <typename T>
+std::vector<typename std::remove_const<T>::type> crop(const ImageViewT<T>& v) {
+    std::vector<typename std::remove_const<T>::type> out(v.row_elements() * v.height);
+    for (int y = 0; y < v.height; y++) std::copy(v.row(y), v.row(y) + v.row_elements(), out.begin() + y * v.row_elements());
+    return out;
+}
+
+template <typename T, typename U>
+bool same(const ImageViewT<T>& v, const std::vector<U>& tight) {
+    return crop(v) == tight;
+}
+
+// Every sample of `image` outside `roi` still holds SENTINEL
+template <typename T>
+bool untouched_outside(const PaddedImage<T>& image, const ImageViewT<T>& roi) {
+    const T* first = roi.row(0);
+    const T* last = roi.row(roi.height - 1) + roi.row_elements();
+    for (int y = 0; y < image.view.height; y++) {
+        const T* row = image.view.row(y);
+        size_t row_samples = image.view.stride / sizeof(T);
+        for (size_t i = 0; i < row_samples; i++) {
+            const T* p = row + i;
+            bool inside = p >= first && p < last && static_cast<size_t>(p - first) % row_samples < roi.row_elements();
+            if (!inside && *p != static_cast<T>(SENTINEL)) return false;
+        }
+    }
+    return true;
+}
+
+void report(const std::string& name, bool ok, bool& all_ok) {
+    std::cout << std::left << std::setw(24) << name << std::right << (ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && ok;
+}
+
+int main() {
+    std::cout << "=== Image Views ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+
+    // 1. Every kernel on a region of a padded buffer
+    std::cout << "1. Region (613x411 at 37,21) of Padded 1000x600 Buffers" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    const int RX = 37, RY = 21, RW = 613, RH = 411;
+    PaddedImage<uint8_t> rgb_src(1000, 600, 3, 1), gray_src(1000, 600, 1, 2), gray_prev(1000, 600, 1, 3);
+    ConstImageView rgb = rgb_src.view.sub(RX, RY, RW, RH);
+    ConstImageView gray = gray_src.view.sub(RX, RY, RW, RH);
+    ConstImageView prev = gray_prev.view.sub(RX, RY, RW, RH);
+    std::vector<uint8_t> rgb_tight = crop(rgb), gray_tight = crop(gray), prev_tight = crop(prev);
+
+    {
+        // In-place point operations: the region is modified, its surroundings are not
+        for (bool simd : {false, true}) {
+            PaddedImage<uint8_t> image(1000, 600, 3);
+            ImageView roi = image.view.sub(RX, RY, RW, RH);
+            for (int y = 0; y < RH; y++) std::copy(rgb.row(y), rgb.row(y) + RW * 3, roi.row(y));
+            std::vector<uint8_t> expected = rgb_tight;
+            if (simd) {
+                adjust_brightness_simd(roi, 40);
+                enhance_contrast_simd(roi, 1.3f);
+                apply_color_matrix_simd(roi, roi, FixedColorMatrix(ColorMatrix::sepia()));
+            } else {
+                adjust_brightness_scalar(roi, 40);
+                enhance_contrast_scalar(roi, 1.3f);
+                apply_color_matrix_scalar(roi, roi, FixedColorMatrix(ColorMatrix::sepia()));
+            }
+            // enhance_contrast rounds in the SIMD version and truncates in the scalar one
+            if (simd) {
+                adjust_brightness_simd(expected.data(), static_cast<int>(expected.size()), 40);
+                enhance_contrast_simd(expected.data(), static_cast<int>(expected.size()), 1.3f);
+            } else {
+                adjust_brightness_scalar(expected.data(), static_cast<int>(expected.size()), 40);
+                enhance_contrast_scalar(expected.data(), static_cast<int>(expected.size()), 1.3f);
+            }
+            apply_color_matrix_scalar(expected.data(), expected.data(), RW * RH, FixedColorMatrix(ColorMatrix::sepia()));
+            report(simd ? "Point ops (SIMD)" : "Point ops (scalar)", same(roi, expected) &&
+                   untouched_outside(image, roi), all_ok);
+        }
+    }
+    {
+        PaddedImage<uint8_t> out(700, 500, 1);
+        ImageView dst = out.view.sub(50, 40, RW, RH);
+        std::vector<uint8_t> expected(RW * RH);
+        convert_to_grayscale_simd(rgb_tight.data(), expected.data(), RW, RH);
+        convert_to_grayscale_simd(rgb, dst);
+        bool ok = same(dst, expected);
+        grayscale_linear_simd(rgb_tight.data(), expected.data(), RW, RH);
+        grayscale_linear_simd(rgb, dst);
+        report("Grayscale", ok && same(dst, expected) && untouched_outside(out, dst), all_ok);
+    }
+    {
+        PaddedImage<uint16_t> linear(700, 500, 3), blurred(700, 500, 3), half(400, 300, 3);
+        ImageView16 lin = linear.view.sub(10, 10, RW, RH);
+        ImageView16 blur = blurred.view.sub(20, 30, RW, RH);
+        ImageView16 small = half.view.sub(5, 7, RW / 2, RH / 2);
+        srgb_to_linear_simd(rgb, lin);
+        blur3_u16_simd(lin, blur);
+        resize_half_u16_simd(blur, small);
+        std::vector<uint16_t> e_lin(rgb_tight.size()), e_blur(e_lin.size()), e_small((RW / 2) * (RH / 2) * 3);
+        srgb_to_linear_simd(rgb_tight.data(), e_lin.data(), e_lin.size());
+        blur3_u16_simd(e_lin.data(), e_blur.data(), RW, RH, 3);
+        resize_half_u16_simd(e_blur.data(), e_small.data(), RW, RH, 3);
+        bool ok = same(lin, e_lin) && same(blur, e_blur) && same(small, e_small);
+        // Scalar view versions agree with the SIMD ones
+        std::vector<uint16_t> s_blur(e_blur.size()), s_small(e_small.size());
+        blur3_u16_scalar(lin, ImageView16(s_blur.data(), RW, RH, 3));
+        resize_half_u16_scalar(blur, ImageView16(s_small.data(), RW / 2, RH / 2, 3));
+        ok = ok && s_blur == e_blur && s_small == e_small;
+        report("Linear light", ok && untouched_outside(linear, lin) && untouched_outside(blurred, blur) &&
+               untouched_outside(half, small), all_ok);
+    }
+    {
+        PaddedImage<uint8_t> out(700, 700, 3);
+        std::vector<uint8_t> expected(rgb_tight.size());
+        bool ok = true;
+        ImageView dst = out.view.sub(3, 5, RW, RH);
+        flip_horizontal_simd(rgb, dst);
+        flip_horizontal_scalar(rgb_tight.data(), expected.data(), RW, RH, 3);
+        ok = ok && same(dst, expected);
+        flip_vertical_simd(dst, dst);  // in place
+        flip_vertical_scalar(expected.data(), expected.data(), RW, RH, 3);
+        ok = ok && same(dst, expected) && untouched_outside(out, dst);
+        for (Rotation r : {Rotation::CW90, Rotation::R180, Rotation::CCW270}) {
+            PaddedImage<uint8_t> turned(700, 700, 3);
+            ImageView target = r == Rotation::R180 ? turned.view.sub(9, 2, RW, RH) : turned.view.sub(9, 2, RH, RW);
+            rotate_simd(rgb, target, r);
+            rotate_scalar(rgb_tight.data(), expected.data(), RW, RH, 3, r);
+            std::vector<uint8_t> from_scalar_view(expected.size());
+            rotate_scalar(rgb, ImageView(from_scalar_view.data(), target.width, target.height, 3), r);
+            ok = ok && same(target, expected) && from_scalar_view == expected &&
+                 untouched_outside(turned, target);
+        }
+        report("Flips and rotations", ok, all_ok);
+    }
+    {
+        bool ok = true;
+        PaddedImage<uint8_t> out(700, 500, 1);
+        ImageView dst = out.view.sub(1, 1, RW, RH);
+        std::vector<uint8_t> expected(RW * RH);
+        threshold_simd(gray, dst, 100, true);
+        threshold_simd(gray_tight.data(), expected.data(), expected.size(), 100, true);
+        ok = ok && same(dst, expected);
+
+        std::vector<uint8_t> bits(bit_mask_stride(RW) * RH), e_bits(bits.size()), m_bits(bits.size());
+        threshold_bits_simd(gray, bits.data(), 100);
+        threshold_bits_scalar(gray_tight.data(), e_bits.data(), RW, RH, 100);
+        mask_to_bits_simd(dst, m_bits.data());
+        std::vector<uint8_t> inverted(bits.size());
+        threshold_bits_scalar(gray, inverted.data(), 100, true);
+        ok = ok && bits == e_bits && m_bits == inverted;
+
+        uint32_t hist[256], e_hist[256], s_hist[256];
+        histogram_simd(gray, hist);
+        histogram_scalar(gray, s_hist);
+        histogram_scalar(gray_tight.data(), gray_tight.size(), e_hist);
+        ok = ok && std::equal(hist, hist + 256, e_hist) && std::equal(s_hist, s_hist + 256, e_hist);
+
+        std::vector<uint32_t> sums((RW + 1) * (RH + 1)), e_sums(sums.size()), s_sums(sums.size());
+        integral_image_simd(gray, sums.data());
+        integral_image_scalar(gray, s_sums.data());
+        integral_image_scalar(gray_tight.data(), e_sums.data(), RW, RH);
+        ok = ok && sums == e_sums && s_sums == e_sums;
+        adaptive_threshold_simd(gray, sums.data(), dst, 7, 5);
+        adaptive_threshold_scalar(gray_tight.data(), e_sums.data(), expected.data(), RW, RH, 7, 5);
+        ok = ok && same(dst, expected) && untouched_outside(out, dst);
+        report("Thresholds", ok, all_ok);
+    }
+    {
+        bool ok = true;
+        PaddedImage<uint8_t> out(700, 500, 1);
+        ImageView dst = out.view.sub(60, 2, RW, RH);
+        std::vector<uint8_t> expected(RW * RH);
+        absolute_difference_simd(gray, prev, dst);
+        absolute_difference_scalar(gray_tight.data(), prev_tight.data(), expected.data(), RW * RH);
+        ok = ok && same(dst, expected);
+        motion_mask_simd(gray, prev, dst, 60);
+        motion_mask_scalar(gray_tight.data(), prev_tight.data(), expected.data(), RW * RH, 60);
+        ok = ok && same(dst, expected) && untouched_outside(out, dst);
+        ok = ok && frame_sad_simd(gray, prev) == frame_sad_scalar(gray_tight.data(), prev_tight.data(), RW * RH) &&
+             frame_sad_scalar(gray, prev) == frame_sad_simd(gray_tight.data(), prev_tight.data(), RW * RH);
+        const int tile_h = 16;
+        std::vector<uint32_t> tiles(motion_tiles_x(RW) * motion_tiles_y(RH, tile_h)), e_tiles(tiles.size());
+        tile_sad_simd(gray, prev, tile_h, tiles.data());
+        tile_sad_scalar(gray_tight.data(), prev_tight.data(), RW, RH, tile_h, e_tiles.data());
+        ok = ok && tiles == e_tiles;
+        report("Motion", ok, all_ok);
+    }
+    {
+        PaddedImage<uint8_t> out(400, 300, 3);
+        ImageView dst = out.view.sub(11, 13, (RW + 1) / 2, (RH + 1) / 2);
+        std::vector<uint8_t> expected(dst.row_elements() * dst.height), from_scalar(expected.size());
+        pyr_down_simd(rgb, dst);
+        pyr_down_scalar(rgb_tight.data(), RW, RH, 3, expected.data());
+        pyr_down_scalar(rgb, ImageView(from_scalar.data(), dst.width, dst.height, 3));
+        GaussianPyramid from_view(RW, RH, 3), from_tight(RW, RH, 3);
+        from_view.build(rgb);
+        from_tight.build(rgb_tight.data());
+        bool ok = same(dst, expected) && from_scalar == expected && untouched_outside(out, dst);
+        for (int i = 0; i < from_view.levels(); i++) {
+            const uint8_t* level = from_view.level(i);
+            ok = ok && std::equal(level, level + from_view.level_info(i).size(), from_tight.level(i));
+        }
+        report("Pyramid", ok, all_ok);
+    }
+    std::cout << std::endl;
+
+    // 2. Region of a frame: in place vs copy round trip
+    std::cout << "2. Brighten a 960x540 Region of a " << WIDTH << "x" << HEIGHT << " Frame" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint8_t> frame(static_cast<size_t>(WIDTH) * HEIGHT * RGB_CHANNELS), copy_frame;
+    initialize_test_image(frame.data(), WIDTH, HEIGHT, RGB_CHANNELS);
+    copy_frame = frame;
+    ImageView frame_roi = ImageView(frame.data(), WIDTH, HEIGHT, RGB_CHANNELS).sub(480, 270, 960, 540);
+    ImageView copy_roi = ImageView(copy_frame.data(), WIDTH, HEIGHT, RGB_CHANNELS).sub(480, 270, 960, 540);
+    std::vector<uint8_t> scratch(copy_roi.row_elements() * copy_roi.height);
+    double copy_us = measure_microseconds([&]() {
+        const size_t row = copy_roi.row_bytes();
+        for (int y = 0; y < copy_roi.height; y++) std::memcpy(scratch.data() + y * row, copy_roi.row(y), row);
+        adjust_brightness_simd(scratch.data(), static_cast<int>(scratch.size()), 1);
+        for (int y = 0; y < copy_roi.height; y++) std::memcpy(copy_roi.row(y), scratch.data() + y * row, row);
+    }, 200);
+    double view_us = measure_microseconds([&]() { adjust_brightness_simd(frame_roi, 1); }, 200);
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Copy out, process, copy back: " << std::setw(8) << copy_us << " us" << std::endl;
+    std::cout << "In place through a view:      " << std::setw(8) << view_us << " us  (" << std::setprecision(2)
+              << copy_us / view_us << "x)" << std::endl;
+    bool roi_ok = frame == copy_frame;
+    std::cout << "Results: " << (roi_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && roi_ok;
+
+    // 3. Tight vs padded rows, whole frame
+    std::cout << "3. Whole Frame, Tight vs 64-Byte Padded Rows" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    PaddedImage<uint8_t> padded_rgb(WIDTH + 5, HEIGHT, 3), padded_gray(WIDTH + 5, HEIGHT, 1);
+    ImageView p_rgb = padded_rgb.view.sub(0, 0, WIDTH - 1, HEIGHT);
+    ImageView p_gray = padded_gray.view.sub(0, 0, WIDTH - 1, HEIGHT);
+    std::vector<uint8_t> t_rgb(static_cast<size_t>(WIDTH - 1) * HEIGHT * 3), t_gray(t_rgb.size() / 3);
+    initialize_test_image(t_rgb.data(), WIDTH - 1, HEIGHT, 3);
+    for (int y = 0; y < HEIGHT; y++) std::copy(t_rgb.begin() + y * p_rgb.row_elements(), t_rgb.begin() + (y + 1) * p_rgb.row_elements(), p_rgb.row(y));
+    std::cout << "Tight stride " << p_rgb.row_bytes() << " B, padded stride " << p_rgb.stride << " B" << std::endl;
+    double tight_us = measure_microseconds([&]() {
+        convert_to_grayscale_simd(t_rgb.data(), t_gray.data(), WIDTH - 1, HEIGHT);
+    }, 20);
+    double padded_us = measure_microseconds([&]() { convert_to_grayscale_simd(p_rgb, p_gray); }, 20);
+    std::cout << std::setprecision(1);
+    std::cout << "Grayscale, tight rows:  " << std::setw(9) << tight_us << " us" << std::endl;
+    std::cout << "Grayscale, padded rows: " << std::setw(9) << padded_us << " us" << std::endl;
+    bool padded_ok = same(p_gray, t_gray);
+    std::cout << "Results: " << (padded_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && padded_ok;
+
+    // Shape errors are reported, not silently clipped
+    bool errors_ok = false;
+    try {
+        convert_to_grayscale_simd(rgb, ImageView(t_gray.data(), RW + 1, RH, 1));
+    } catch (const std::invalid_argument&) {
+        errors_ok = true;
+    }
+    try {
+        errors_ok = false;
+        rgb.sub(RW - 10, 0, 11, 1);
+    } catch (const std::out_of_range&) {
+        errors_ok = true;
+    }
+    std::cout << "Size mismatch and out-of-range region rejected: " << (errors_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && errors_ok;
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_pyramid.h"
+#include "../../include/simd_batch.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+
+/**
+ * 06_Image_Processing/13_batch_thumbnails - One dispatch for many small images
+ *
+ * A 64x64 RGB thumbnail is 12 KB, so per-call costs (threads, scratch
+ * allocation, constants, tails) weigh as much as the pixels. simd_batch.h takes
+ * a list of image views and runs it as one work list: adjacent images are
+ * joined into long spans, scratch rows are kept per worker and threads are
+ * started once per batch.
+ *
+ * We'll:
+ * 1. Check every batch function against per-image kernel calls on thumbnails of
+ *    random sizes, tight and padded, adjacent and scattered, with 1 and 3 threads
+ * 2. Check that a bad view in a batch is rejected before any image is touched
+ * 3. Time 100,000 64x64 thumbnails stored back to back: per-image calls vs
+ *    batch on 1 and N threads, and threads started per image for comparison
+ */
+
+const int THUMB = 64;
+const int COUNT = 100000;
+
+// Views into one arena, back to back
+template <typename View>
+std::vector<View> arena_views(std::vector<uint8_t>& arena, int width, int height, int channels, int count) {
+    const size_t bytes = static_cast<size_t>(width) * height * channels;
+    arena.resize(bytes * count);
+    std::vector<View> views;
+    for (int i = 0; i < count; i++) views.push_back(View(arena.data() + i * bytes, width, height, channels));
+    return views;
+}
+
+std::vector<ConstImageView> as_const(const std::vector<ImageView>& views) {
+    return std::vector<ConstImageView>(views.begin(), views.end());
+}
+
+// Mixed thumbnails for the checks: random sizes, some padded, some adjacent
+struct MixedSet {
+    std::vector<uint8_t> arena;
+    std::vector<ImageView> rgb, gray, half;
+};
+
+MixedSet make_mixed(unsigned seed) {
+    std::mt19937 gen(seed);
+    struct Shape {
+        int w, h;
+        size_t rgb_stride, gray_stride, half_stride;
+        size_t rgb_at, gray_at, half_at;
+    };
+    std::vector<Shape> shapes;
+    size_t used = 0;
+    for (int i = 0; i < 400; i++) {
+        Shape s;
+        s.w = 1 + gen() % 80;
+        s.h = 1 + gen() % 80;
+        // A third padded, the rest tight; some with a gap after them
+        size_t pad = gen() % 3 == 0 ? 1 + gen() % 64 : 0;
+        s.rgb_stride = s.w * 3 + pad;
+        s.gray_stride = s.w + pad;
+        s.half_stride = (s.w + 1) / 2 * 3 + pad;
+        size_t gap = gen() % 4 == 0 ? gen() % 100 : 0;
+        s.rgb_at = used;
+        used += s.rgb_stride * s.h + gap;
+        s.gray_at = used;
+        used += s.gray_stride * s.h;
+        s.half_at = used;
+        used += s.half_stride * ((s.h + 1) / 2);
+        shapes.push_back(s);
+    }
+    MixedSet set;
+    set.arena.resize(used);
+    for (uint8_t& b : set.arena) b = static_cast<uint8_t>(gen());
+    for (const Shape& s : shapes) {
+        set.rgb.push_back(ImageView(set.arena.data() + s.rgb_at, s.w, s.h, 3, s.rgb_stride));
+        set.gray.push_back(ImageView(set.arena.data() + s.gray_at, s.w, s.h, 1, s.gray_stride));
+        set.half.push_back(ImageView(set.arena.data() + s.half_at, (s.w + 1) / 2, (s.h + 1) / 2, 3, s.half_stride));
+    }
+    return set;
+}
+
+// Brightness on one image with its rows split over threads started for the call
+void brightness_threaded(const ImageView& image, int brightness, int threads) {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            int y0 = image.height * t / threads, y1 = image.height * (t + 1) / threads;
+            adjust_brightness_simd(image.sub(0, y0, image.width, y1 - y0), brightness);
+        });
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+int main() {
+    std::cout << "=== Batch Processing of Thumbnails ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    const int threads = std::max(4u, std::thread::hardware_concurrency());
+
+    // 1. Batch vs per-image calls
+    std::cout << "1. Batch vs Per-Image Results" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    bool batch_ok = true;
+    for (int t : {1, 3}) {
+        MixedSet expected = make_mixed(4), batched = make_mixed(4);
+        for (size_t i = 0; i < expected.rgb.size(); i++) {
+            adjust_brightness_simd(expected.rgb[i], 25);
+            enhance_contrast_simd(expected.rgb[i], 1.3f);
+            convert_to_grayscale_simd(expected.rgb[i], expected.gray[i]);
+            pyr_down_simd(expected.rgb[i], expected.half[i]);
+        }
+        adjust_brightness_batch(batched.rgb, 25, t);
+        enhance_contrast_batch(batched.rgb, 1.3f, t);
+        convert_to_grayscale_batch(as_const(batched.rgb), batched.gray, t);
+        pyr_down_batch(as_const(batched.rgb), batched.half, t);
+        // The arenas include gaps and padding, which must be untouched as well
+        batch_ok = batch_ok && expected.arena == batched.arena;
+    }
+    std::cout << "400 thumbnails 1x1 to 80x80, 4 ops, 1 and 3 threads: " << (batch_ok ? "OK" : "MISMATCH")
+              << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && batch_ok;
+
+    // 2. Shapes are checked before any work starts
+    std::cout << "2. Shape Errors" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    MixedSet bad = make_mixed(5);
+    const std::vector<uint8_t> before = bad.arena;
+    bad.half.back() = bad.half.back().sub(0, 0, bad.half.back().width - 1, bad.half.back().height);
+    bool rejected = false;
+    try {
+        pyr_down_batch(as_const(bad.rgb), bad.half, threads);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    bool errors_ok = rejected && bad.arena == before;
+    std::cout << "Wrong target size in the last entry: " << (errors_ok ? "rejected, nothing written" : "MISMATCH")
+              << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && errors_ok;
+
+    // 3. 100,000 thumbnails back to back
+    std::cout << "3. " << COUNT << " Thumbnails (" << THUMB << "x" << THUMB << " RGB, " << threads << " threads)"
+              << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<uint8_t> rgb_arena, gray_arena, half_arena;
+    std::vector<ImageView> rgb = arena_views<ImageView>(rgb_arena, THUMB, THUMB, 3, COUNT);
+    std::vector<ImageView> gray = arena_views<ImageView>(gray_arena, THUMB, THUMB, 1, COUNT);
+    std::vector<ImageView> half = arena_views<ImageView>(half_arena, THUMB / 2, THUMB / 2, 3, COUNT);
+    std::vector<ConstImageView> rgb_const = as_const(rgb);
+    for (size_t i = 0; i < rgb_arena.size(); i++) rgb_arena[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+
+    auto report = [&](const char* name, double us) {
+        std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(10) << us / 1000.0
+                  << " ms  " << std::setw(7) << us / COUNT << " us/image" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::cout << "Brightness:" << std::endl;
+    report("per image", measure_microseconds([&]() {
+        for (const ImageView& v : rgb) adjust_brightness_simd(v, 1);
+    }, 1));
+    report("batch, 1 thread", measure_microseconds([&]() { adjust_brightness_batch(rgb, 1, 1); }, 1));
+    report("batch, N threads", measure_microseconds([&]() { adjust_brightness_batch(rgb, 1, threads); }, 1));
+    // Only a slice: starting threads for every image is slow enough
+    const int slice = COUNT / 20;
+    report("threads per image (x20)", 20 * measure_microseconds([&]() {
+        for (int i = 0; i < slice; i++) brightness_threaded(rgb[i], 1, threads);
+    }, 1));
+
+    std::cout << "Contrast:" << std::endl;
+    report("per image", measure_microseconds([&]() {
+        for (const ImageView& v : rgb) enhance_contrast_simd(v, 1.0f);
+    }, 1));
+    report("batch, 1 thread", measure_microseconds([&]() { enhance_contrast_batch(rgb, 1.0f, 1); }, 1));
+    report("batch, N threads", measure_microseconds([&]() { enhance_contrast_batch(rgb, 1.0f, threads); }, 1));
+
+    std::cout << "Grayscale:" << std::endl;
+    report("per image", measure_microseconds([&]() {
+        for (int i = 0; i < COUNT; i++) convert_to_grayscale_simd(rgb_const[i], gray[i]);
+    }, 1));
+    report("batch, 1 thread", measure_microseconds([&]() { convert_to_grayscale_batch(rgb_const, gray, 1); }, 1));
+    report("batch, N threads", measure_microseconds([&]() {
+        convert_to_grayscale_batch(rgb_const, gray, threads);
+    }, 1));
+
+    std::cout << "2x downscale (pyr_down):" << std::endl;
+    report("per image", measure_microseconds([&]() {
+        for (int i = 0; i < COUNT; i++) pyr_down_simd(rgb_const[i], half[i]);
+    }, 1));
+    report("batch, 1 thread", measure_microseconds([&]() { pyr_down_batch(rgb_const, half, 1); }, 1));
+    report("batch, N threads", measure_microseconds([&]() { pyr_down_batch(rgb_const, half, threads); }, 1));
+
+    return all_ok ? 0 : 1;
+}
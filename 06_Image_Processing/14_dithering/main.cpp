@@ -0,0 +1,203 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_dither.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+
+/**
+ * 06_Image_Processing/14_dithering - Images for e-ink and low-bit displays
+ *
+ * Our e-ink targets show 2 or 16 grays, or seven inks; small LCDs take 2-bit
+ * channels. Rounding every sample to the nearest level bands smooth gradients;
+ * dithering trades the bands for fine patterns whose local average matches the
+ * original. simd_dither.h has ordered (Bayer) dithering, Floyd-Steinberg error
+ * diffusion and nearest-color palette quantization, each scalar and SIMD with
+ * identical output.
+ *
+ * We'll:
+ * 1. Render a 1600x1200 photo-like RGB test image (gradients and soft shapes)
+ *    and its grayscale version
+ * 2. Bayer-dither gray to 2 and 16 levels and RGB to 4 levels per channel
+ * 3. Floyd-Steinberg the same images, with the row carry scalar vs vectorized
+ * 4. Map RGB to the 7-ink e-paper palette and to the 216-color web palette
+ * 5. Compare how well 8x8 tile averages survive: plain rounding, Bayer and
+ *    Floyd-Steinberg
+ */
+
+const int WIDTH = 1600;
+const int HEIGHT = 1200;
+const size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+
+// Diagonal color gradients with a few soft discs on top
+std::vector<uint8_t> render_photo() {
+    std::vector<uint8_t> rgb(PIXELS * 3);
+    const float discs[4][3] = {{400, 300, 180}, {1100, 500, 260}, {700, 900, 200}, {1350, 1000, 150}};
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float fx = static_cast<float>(x) / WIDTH, fy = static_cast<float>(y) / HEIGHT;
+            float c[3] = {255.0f * fx, 255.0f * fy, 255.0f * (1.0f - 0.5f * (fx + fy))};
+            for (const auto& d : discs) {
+                float r = std::sqrt((x - d[0]) * (x - d[0]) + (y - d[1]) * (y - d[1])) / d[2];
+                float w = r < 1.0f ? 1.0f - r * r : 0.0f;
+                c[0] = c[0] * (1 - w) + 230.0f * w;
+                c[1] = c[1] * (1 - w) + 190.0f * w;
+                c[2] = c[2] * (1 - w) + 60.0f * w;
+            }
+            for (int k = 0; k < 3; k++) rgb[(static_cast<size_t>(y) * WIDTH + x) * 3 + k] = static_cast<uint8_t>(c[k]);
+        }
+    }
+    return rgb;
+}
+
+// Mean absolute difference of 8x8 tile averages, in 0..255 units
+double tile_error(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int channels) {
+    double total = 0;
+    int tiles = 0;
+    for (int ty = 0; ty + 8 <= HEIGHT; ty += 8) {
+        for (int tx = 0; tx + 8 <= WIDTH; tx += 8) {
+            for (int c = 0; c < channels; c++) {
+                int sa = 0, sb = 0;
+                for (int y = ty; y < ty + 8; y++) {
+                    for (int x = tx; x < tx + 8; x++) {
+                        size_t i = (static_cast<size_t>(y) * WIDTH + x) * channels + c;
+                        sa += a[i];
+                        sb += b[i];
+                    }
+                }
+                total += std::abs(sa - sb) / 64.0;
+                tiles++;
+            }
+        }
+    }
+    return total / tiles;
+}
+
+// Every sample rounded to the nearest level, no dithering
+std::vector<uint8_t> round_to_levels(const std::vector<uint8_t>& src, int levels) {
+    const DiffusionLevels q(levels);
+    std::vector<uint8_t> out(src.size());
+    for (size_t i = 0; i < src.size(); i++) out[i] = q.nearest[src[i]];
+    return out;
+}
+
+int main() {
+    std::cout << "=== Dithering and Palette Quantization ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    std::vector<uint8_t> rgb = render_photo();
+    std::vector<uint8_t> gray(PIXELS);
+    convert_to_grayscale_simd(rgb.data(), gray.data(), WIDTH, HEIGHT);
+
+    struct Case {
+        const char* name;
+        const std::vector<uint8_t>* src;
+        int channels;
+        int levels;
+    };
+    const Case cases[] = {{"Gray, 2 levels", &gray, 1, 2}, {"Gray, 16 levels", &gray, 1, 16},
+                          {"RGB, 4 levels/channel", &rgb, 3, 4}};
+    std::vector<uint8_t> out_scalar(PIXELS * 3), out_simd(PIXELS * 3);
+
+    // 1. Ordered dithering
+    std::cout << "1. Bayer Dithering (" << WIDTH << "x" << HEIGHT << ")" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    bool bayer_ok = true;
+    for (const Case& c : cases) {
+        const size_t n = PIXELS * c.channels;
+        benchmark_comparison(c.name,
+            [&]() { bayer_dither_scalar(c.src->data(), out_scalar.data(), WIDTH, HEIGHT, c.channels, c.levels); },
+            [&]() { bayer_dither_simd(c.src->data(), out_simd.data(), WIDTH, HEIGHT, c.channels, c.levels); },
+            10);
+        bayer_ok = bayer_ok && std::equal(out_scalar.begin(), out_scalar.begin() + n, out_simd.begin());
+    }
+    // Odd widths exercise the scalar tail and the threshold table
+    for (int w : {1, 7, 33, 77}) {
+        std::vector<uint8_t> src(w * 9 * 3), a(src.size()), b(src.size());
+        for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 37);
+        for (int ch : {1, 3}) {
+            bayer_dither_scalar(src.data(), a.data(), w, 9, ch, 3);
+            bayer_dither_simd(src.data(), b.data(), w, 9, ch, 3);
+            bayer_ok = bayer_ok && a == b;
+        }
+    }
+    std::cout << "Results: " << (bayer_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && bayer_ok;
+
+    // 2. Error diffusion
+    std::cout << "2. Floyd-Steinberg" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    bool fs_ok = true;
+    for (const Case& c : cases) {
+        const size_t n = PIXELS * c.channels;
+        benchmark_comparison(c.name,
+            [&]() { floyd_steinberg_scalar(c.src->data(), out_scalar.data(), WIDTH, HEIGHT, c.channels, c.levels); },
+            [&]() { floyd_steinberg_simd(c.src->data(), out_simd.data(), WIDTH, HEIGHT, c.channels, c.levels); },
+            5);
+        fs_ok = fs_ok && std::equal(out_scalar.begin(), out_scalar.begin() + n, out_simd.begin());
+    }
+    for (int w : {1, 7, 33, 77}) {
+        std::vector<uint8_t> src(w * 9 * 3), a(src.size()), b(src.size());
+        for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i * 37);
+        for (int ch : {1, 3}) {
+            floyd_steinberg_scalar(src.data(), a.data(), w, 9, ch, 2);
+            floyd_steinberg_simd(src.data(), b.data(), w, 9, ch, 2);
+            fs_ok = fs_ok && a == b;
+        }
+    }
+    std::cout << "Results: " << (fs_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && fs_ok;
+
+    // 3. Palettes
+    std::cout << "3. Palette Quantization" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    bool palette_ok = true;
+    std::vector<uint8_t> index_scalar(PIXELS), index_simd(PIXELS);
+    const std::vector<PaletteColor> eink = palette_eink7(), web = palette_web_safe();
+    for (const std::vector<PaletteColor>* palette : {&eink, &web}) {
+        std::string name = std::to_string(palette->size()) + "-color palette";
+        benchmark_comparison(name,
+            [&]() { quantize_palette_scalar(rgb.data(), index_scalar.data(), PIXELS, *palette); },
+            [&]() { quantize_palette_simd(rgb.data(), index_simd.data(), PIXELS, *palette); },
+            palette->size() > 16 ? 1 : 5);
+        palette_ok = palette_ok && index_scalar == index_simd;
+    }
+    // Exact ties (two equally close inks) must pick the lower index in both
+    const std::vector<PaletteColor> tie = {{0, 0, 0}, {10, 0, 0}, {0, 10, 0}};
+    std::vector<uint8_t> tie_rgb(40 * 3, 0), tie_a(40), tie_b(40);
+    for (int p = 0; p < 40; p++) tie_rgb[p * 3] = tie_rgb[p * 3 + 1] = static_cast<uint8_t>(p % 12);
+    quantize_palette_scalar(tie_rgb.data(), tie_a.data(), 40, tie);
+    quantize_palette_simd(tie_rgb.data(), tie_b.data(), 40, tie);
+    palette_ok = palette_ok && tie_a == tie_b;
+    std::cout << "Results: " << (palette_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && palette_ok;
+
+    // 4. Local averages
+    std::cout << "4. 8x8 Tile Average Error (0..255 units)" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(24) << "" << std::right << std::setw(10) << "rounding" << std::setw(10)
+              << "Bayer" << std::setw(10) << "F-S" << std::endl;
+    bool quality_ok = true;
+    for (const Case& c : cases) {
+        std::vector<uint8_t> bayer(PIXELS * c.channels), fs(PIXELS * c.channels);
+        bayer_dither_simd(c.src->data(), bayer.data(), WIDTH, HEIGHT, c.channels, c.levels);
+        floyd_steinberg_simd(c.src->data(), fs.data(), WIDTH, HEIGHT, c.channels, c.levels);
+        double e_round = tile_error(*c.src, round_to_levels(*c.src, c.levels), c.channels);
+        double e_bayer = tile_error(*c.src, bayer, c.channels);
+        double e_fs = tile_error(*c.src, fs, c.channels);
+        std::cout << std::left << std::setw(24) << c.name << std::right << std::setw(10) << e_round << std::setw(10)
+                  << e_bayer << std::setw(10) << e_fs << std::endl;
+        quality_ok = quality_ok && e_bayer < e_round && e_fs < e_round;
+    }
+    std::cout << "Dithering beats rounding: " << (quality_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && quality_ok;
+
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+#include "../../include/simd_utils.h"
+#include "../../include/simd_image.h"
+#include "../../include/simd_tonemap.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+/**
+ * 06_Image_Processing/17_tone_mapping - Float HDR frames to 8-bit RGB
+ *
+ * A linear HDR frame spans many stops: deep shadows around 0.001, a sky around
+ * 5, the sun in the thousands. Clipping at 1.0 burns out everything bright;
+ * tone curves compress the highlights instead. simd_tonemap.h maps float RGB
+ * to bytes with exposure/gamma, Reinhard and the fitted ACES curve, using
+ * reciprocal estimates and a polynomial pow in the SIMD versions.
+ *
+ * We'll:
+ * 1. Render a 3840x2160 HDR scene (shadows, sky, sun, color patches)
+ * 2. Map it with each operator, scalar vs SIMD, in megapixels per second, and
+ *    count how many bytes differ from the reference
+ * 3. Check NaN, negative, infinite and huge samples, and tails of every length
+ * 4. Compare how much of the frame each operator clips to 255
+ * 5. Print a section of the ACES result and write it as a PPM
+ */
+
+const int WIDTH = 3840;
+const int HEIGHT = 2160;
+const size_t PIXELS = static_cast<size_t>(WIDTH) * HEIGHT;
+const size_t SAMPLES = PIXELS * 3;
+
+// Linear light: dim interior on the left, window with sky and sun on the right,
+// a row of saturated patches at the bottom
+std::vector<float> render_hdr() {
+    std::vector<float> hdr(SAMPLES);
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float fx = static_cast<float>(x) / WIDTH, fy = static_cast<float>(y) / HEIGHT;
+            float c[3];
+            if (fx < 0.5f) {
+                // Interior: 0.001 .. 0.25 falling off from a lamp
+                float d = std::hypot(fx - 0.25f, fy - 0.3f);
+                float l = 0.001f + 0.25f * std::exp(-d * d * 20.0f);
+                c[0] = l * 1.1f, c[1] = l, c[2] = l * 0.8f;
+            } else {
+                // Sky brightening towards the horizon, sun disc
+                float l = 1.0f + 6.0f * fy;
+                c[0] = l * 0.6f, c[1] = l * 0.8f, c[2] = l * 1.2f;
+                float d = std::hypot(fx - 0.8f, (fy - 0.2f) * HEIGHT / WIDTH);
+                if (d < 0.02f) c[0] = 3000.0f, c[1] = 2800.0f, c[2] = 2500.0f;
+                else if (d < 0.06f) {
+                    float glow = 40.0f * (0.06f - d) / 0.04f;
+                    for (float& v : c) v += glow;
+                }
+            }
+            if (fy > 0.85f) {
+                // Patches at 0.05 .. 2.0 in primaries and secondaries
+                int patch = static_cast<int>(fx * 12);
+                float level = 0.05f * std::pow(2.0f, static_cast<float>(patch % 6));
+                int hue = patch / 2 % 6 + 1;
+                for (int k = 0; k < 3; k++) c[k] = (hue >> k) & 1 ? level : level * 0.05f;
+            }
+            float* p = hdr.data() + (static_cast<size_t>(y) * WIDTH + x) * 3;
+            for (int k = 0; k < 3; k++) p[k] = c[k];
+        }
+    }
+    return hdr;
+}
+
+struct Operator {
+    const char* name;
+    void (*scalar)(const float*, uint8_t*, size_t);
+    void (*simd)(const float*, uint8_t*, size_t);
+};
+
+const float EXPOSURE = 1.5f;
+const float GAMMA = 2.2f;
+
+const Operator OPERATORS[] = {
+    {"exposure/gamma",
+     [](const float* s, uint8_t* d, size_t n) { tonemap_exposure_scalar(s, d, n, EXPOSURE, GAMMA); },
+     [](const float* s, uint8_t* d, size_t n) { tonemap_exposure_simd(s, d, n, EXPOSURE, GAMMA); }},
+    {"Reinhard",
+     [](const float* s, uint8_t* d, size_t n) { tonemap_reinhard_scalar(s, d, n, EXPOSURE, 0.0f, GAMMA); },
+     [](const float* s, uint8_t* d, size_t n) { tonemap_reinhard_simd(s, d, n, EXPOSURE, 0.0f, GAMMA); }},
+    {"Reinhard, white 12",
+     [](const float* s, uint8_t* d, size_t n) { tonemap_reinhard_scalar(s, d, n, EXPOSURE, 12.0f, GAMMA); },
+     [](const float* s, uint8_t* d, size_t n) { tonemap_reinhard_simd(s, d, n, EXPOSURE, 12.0f, GAMMA); }},
+    {"ACES fitted",
+     [](const float* s, uint8_t* d, size_t n) { tonemap_aces_scalar(s, d, n, EXPOSURE, GAMMA); },
+     [](const float* s, uint8_t* d, size_t n) { tonemap_aces_simd(s, d, n, EXPOSURE, GAMMA); }},
+};
+
+// Largest byte difference, and how many bytes differ at all
+int compare(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, size_t count, size_t& differing) {
+    int worst = 0;
+    differing = 0;
+    for (size_t i = 0; i < count; i++) {
+        int d = std::abs(a[i] - b[i]);
+        worst = std::max(worst, d);
+        differing += d != 0;
+    }
+    return worst;
+}
+
+int main() {
+    std::cout << "=== HDR Tone Mapping ===" << std::endl;
+    std::cout << std::endl;
+
+    bool all_ok = true;
+    const std::vector<float> hdr = render_hdr();
+    float lo = hdr[0], hi = hdr[0];
+    for (float v : hdr) lo = std::min(lo, v), hi = std::max(hi, v);
+    std::vector<uint8_t> out_scalar(SAMPLES), out_simd(SAMPLES);
+
+    // 1. Throughput and accuracy
+    std::cout << "1. Tone Mapping " << WIDTH << "x" << HEIGHT << " (" << std::fixed << std::setprecision(1)
+              << std::log2(hi / lo) << " stops, exposure " << EXPOSURE << ", gamma " << GAMMA << ")" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << std::left << std::setw(20) << "operator" << std::right << std::setw(12) << "scalar MP/s"
+              << std::setw(12) << "SIMD MP/s" << std::setw(9) << "speedup" << std::setw(10) << "max diff"
+              << std::setw(11) << "differing" << std::endl;
+    std::cout << "(differing: samples of " << SAMPLES << " not equal to the reference byte)" << std::endl;
+    bool accuracy_ok = true;
+    for (const Operator& op : OPERATORS) {
+        double us_scalar = measure_microseconds([&]() { op.scalar(hdr.data(), out_scalar.data(), SAMPLES); }, 1);
+        double us_simd = measure_microseconds([&]() { op.simd(hdr.data(), out_simd.data(), SAMPLES); }, 5);
+        size_t differing = 0;
+        int worst = compare(out_scalar, out_simd, SAMPLES, differing);
+        std::cout << std::left << std::setw(20) << op.name << std::right << std::setprecision(1) << std::setw(12)
+                  << PIXELS / us_scalar << std::setw(12) << PIXELS / us_simd << std::setw(8) << us_scalar / us_simd
+                  << "x" << std::setw(10) << worst << std::setw(11) << differing << std::endl;
+        accuracy_ok = accuracy_ok && worst <= 1;
+    }
+    std::cout << "SIMD within one level of the reference: " << (accuracy_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && accuracy_ok;
+
+    // 2. Special values and tails
+    std::cout << "2. Special Values and Tails" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    const float inf = std::numeric_limits<float>::infinity();
+    const std::vector<float> special = {std::numeric_limits<float>::quiet_NaN(), -1.0f, -inf, 0.0f, 1e-30f,
+                                        1e-6f, 0.18f, 1.0f, 65504.0f, 1e30f, inf, 1e-3f, 0.5f};
+    bool special_ok = true;
+    for (const Operator& op : OPERATORS) {
+        std::vector<uint8_t> a(special.size()), b(special.size());
+        op.scalar(special.data(), a.data(), special.size());
+        op.simd(special.data(), b.data(), special.size());
+        size_t differing = 0;
+        special_ok = special_ok && compare(a, b, a.size(), differing) <= 1 && a[0] == 0 && a[1] == 0 && b[0] == 0 &&
+                     b[1] == 0 && b[10] == a[10];
+    }
+    // A tail gives the same bytes as the same samples inside a long run
+    bool tail_ok = true;
+    for (size_t n = 1; n <= 100; n++) {
+        std::vector<uint8_t> part(n);
+        tonemap_aces_simd(hdr.data() + SAMPLES / 2, part.data(), n, EXPOSURE, GAMMA);
+        tonemap_aces_simd(hdr.data() + SAMPLES / 2, out_simd.data(), 128, EXPOSURE, GAMMA);
+        tail_ok = tail_ok && std::equal(part.begin(), part.end(), out_simd.begin());
+    }
+    std::cout << "NaN, negative, zero, tiny, huge, infinite: " << (special_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << "Counts 1..100 match the full-vector path: " << (tail_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && special_ok && tail_ok;
+
+    // 3. Highlights
+    std::cout << "3. Samples Clipped to 255" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::vector<size_t> clipped;
+    for (const Operator& op : OPERATORS) {
+        op.simd(hdr.data(), out_simd.data(), SAMPLES);
+        size_t count = 0;
+        for (uint8_t v : out_simd) count += v == 255;
+        clipped.push_back(count);
+        std::cout << std::left << std::setw(20) << op.name << std::right << std::setw(8) << std::setprecision(2)
+                  << 100.0 * count / SAMPLES << "%" << std::endl;
+    }
+    // The curves keep the sky; only clipping burns it out
+    bool clip_ok = clipped[1] < clipped[0] && clipped[3] < clipped[0];
+    std::cout << "Curves clip less than exposure/gamma: " << (clip_ok ? "OK" : "MISMATCH") << std::endl;
+    std::cout << std::endl;
+    all_ok = all_ok && clip_ok;
+
+    // 4. 8-bit output
+    std::cout << "4. ACES Output" << std::endl;
+    std::cout << "---------------------------------------------------" << std::endl;
+    tonemap_aces_simd(ConstImageViewF(hdr.data(), WIDTH, HEIGHT, 3), ImageView(out_simd.data(), WIDTH, HEIGHT, 3),
+                      EXPOSURE, GAMMA);
+    // Across the interior/window boundary
+    print_image_section(out_simd.data(), WIDTH, 3, WIDTH / 2 - 2, HEIGHT / 2, 4, 2);
+    const std::string path = "/var/tmp/tonemap_aces.ppm";
+    bool ppm_ok = write_ppm(path, out_simd.data(), WIDTH, HEIGHT);
+    if (FILE* file = std::fopen(path.c_str(), "rb")) {
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fclose(file);
+        const std::string header = "P6\n" + std::to_string(WIDTH) + " " + std::to_string(HEIGHT) + "\n255\n";
+        ppm_ok = ppm_ok && size == static_cast<long>(header.size() + SAMPLES);
+        std::cout << "Wrote " << path << " (" << size / (1024 * 1024) << " MB)" << std::endl;
+    } else {
+        ppm_ok = false;
+    }
+    std::remove(path.c_str());
+    std::cout << "PPM: " << (ppm_ok ? "OK" : "MISMATCH") << std::endl;
+    all_ok = all_ok && ppm_ok;
+
+    return all_ok ? 0 : 1;
+}
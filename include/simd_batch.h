@@ -0,0 +1,148 @@
+/**
+ * simd_batch.h - Batch processing of many small images with one dispatch
+ *
+ * For thumbnails (64x64 and smaller) the fixed cost of a kernel call is a large
+ * part of the work: starting threads, allocating scratch rows, setting up
+ * constants and running tail loops. The batch functions take a list of image
+ * views (simd_view.h) and process it as one work list:
+ * - Brightness and contrast work per byte, so the views are cut into spans
+ *   (whole images when rows are tight, else rows) and spans that follow each
+ *   other in memory are joined: thumbnails stored back to back become a few
+ *   long spans with one tail each. Long spans are cut into work items of
+ *   BATCH_SPAN_BYTES.
+ * - Grayscale and 2x downscaling (pyr_down_simd) run per image; each worker
+ *   reuses one set of pyr_down scratch rows for all its images.
+ * - Threads are started once per batch and claim BATCH_GRAIN work items at a
+ *   time from a shared counter, so uneven image sizes balance out.
+ *
+ * Shapes are checked on the calling thread before any work starts, so a bad
+ * view throws std::invalid_argument before any image is touched. The results
+ * match the per-image SIMD kernels byte for byte. Views in one batch must not
+ * overlap. Requires -pthread.
+ */
+
+#ifndef SIMD_BATCH_H
+#define SIMD_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "simd_view.h"
+#include "simd_image.h"
+#include "simd_pyramid.h"
+
+// Work items a worker claims at a time
+const size_t BATCH_GRAIN = 16;
+// Longest per-byte work item; a multiple of 32, so only the end of a span has a tail
+const size_t BATCH_SPAN_BYTES = 64 * 1024;
+
+// Runs fn(begin, end, worker) over [0, count) on up to `threads` threads
+// (worker 0 is the calling thread), `grain` items at a time
+template<typename Fn>
+inline void batch_for(size_t count, int threads, Fn fn, size_t grain = BATCH_GRAIN) {
+    if (count == 0) return;
+    const size_t chunks = (count + grain - 1) / grain;
+    threads = static_cast<int>(std::min<size_t>(std::max(1, threads), chunks));
+    std::atomic<size_t> next(0);
+    auto work = [&](int worker) {
+        for (;;) {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= count) break;
+            fn(begin, std::min(count, begin + grain), worker);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(work, t);
+    work(0);
+    for (std::thread& t : pool) t.join();
+}
+
+struct BatchSpan {
+    uint8_t* data;
+    size_t bytes;
+};
+
+// Byte spans of the views: adjacent spans joined, long ones cut into work items
+inline std::vector<BatchSpan> batch_spans(const std::vector<ImageView>& images) {
+    std::vector<BatchSpan> joined;
+    for (const ImageView& image : images) {
+        for_each_span(image, [&](uint8_t* p, size_t pixels) {
+            const size_t bytes = pixels * image.channels;
+            if (bytes == 0) return;
+            if (!joined.empty() && joined.back().data + joined.back().bytes == p) {
+                joined.back().bytes += bytes;
+            } else {
+                joined.push_back({p, bytes});
+            }
+        });
+    }
+    std::vector<BatchSpan> items;
+    for (const BatchSpan& span : joined) {
+        for (size_t offset = 0; offset < span.bytes; offset += BATCH_SPAN_BYTES) {
+            items.push_back({span.data + offset, std::min(BATCH_SPAN_BYTES, span.bytes - offset)});
+        }
+    }
+    return items;
+}
+
+template<typename A, typename B>
+inline void check_batch_lengths(const std::vector<A>& src, const std::vector<B>& dst) {
+    if (src.size() != dst.size()) {
+        throw std::invalid_argument("batch source and target lists differ in length");
+    }
+}
+
+// 1. Brightness adjustment - batch of views (brightness in [0, 255], as
+// adjust_brightness_simd)
+inline void adjust_brightness_batch(const std::vector<ImageView>& images, int brightness, int threads = 1) {
+    const std::vector<BatchSpan> spans = batch_spans(images);
+    batch_for(spans.size(), threads, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            adjust_brightness_simd(spans[i].data, static_cast<int>(spans[i].bytes), brightness);
+        }
+    });
+}
+
+// 2. Contrast enhancement - batch of views
+inline void enhance_contrast_batch(const std::vector<ImageView>& images, float contrast, int threads = 1) {
+    const std::vector<BatchSpan> spans = batch_spans(images);
+    batch_for(spans.size(), threads, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            enhance_contrast_simd(spans[i].data, static_cast<int>(spans[i].bytes), contrast);
+        }
+    });
+}
+
+// 3. Grayscale conversion - batch of views; src[i] RGB, dst[i] one channel
+inline void convert_to_grayscale_batch(const std::vector<ConstImageView>& src, const std::vector<ImageView>& dst,
+                                       int threads = 1) {
+    check_batch_lengths(src, dst);
+    for (size_t i = 0; i < src.size(); i++) {
+        check_same_size(src[i], dst[i]);
+        check_channels(src[i], RGB_CHANNELS);
+        check_channels(dst[i], 1);
+    }
+    batch_for(src.size(), threads, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) convert_to_grayscale_simd(src[i], dst[i]);
+    });
+}
+
+// 4. 2x downscale (blur + decimate) - batch of views; dst[i] is src[i] halved,
+// rounded up, as for pyr_down_simd
+inline void pyr_down_batch(const std::vector<ConstImageView>& src, const std::vector<ImageView>& dst,
+                           int threads = 1) {
+    check_batch_lengths(src, dst);
+    for (size_t i = 0; i < src.size(); i++) check_pyr_down_views(src[i], dst[i]);
+    // Scratch rows per worker
+    const size_t workers = static_cast<size_t>(std::max(1, threads));
+    std::vector<std::vector<uint16_t>> vrows(workers);
+    std::vector<std::vector<uint8_t>> filtered(workers);
+    batch_for(src.size(), threads, [&](size_t begin, size_t end, int worker) {
+        for (size_t i = begin; i < end; i++) pyr_down_simd(src[i], dst[i], vrows[worker], filtered[worker]);
+    });
+}
+
+#endif // SIMD_BATCH_H
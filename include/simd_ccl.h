@@ -0,0 +1,234 @@
+/**
+ * simd_ccl.h - Run-based connected-component labeling of binary masks
+ *
+ * Blob extraction after thresholding. Works on packed 1-bit masks in the layout
+ * of simd_threshold.h (rows in whole 64-bit words, bit x % 64 of word x / 64):
+ * - Runs: each row is turned into horizontal runs of set bits with tzcnt on the
+ *   64-bit words, alternating between searching the bits and their complement, so
+ *   the cost follows the number of runs, not pixels; all-zero words are skipped.
+ * - Union-find: a run is merged with every run it touches in the row above (4- or
+ *   8-connected). Roots are always the lower run index, so one pass in run order
+ *   hands out compact labels in raster order of each component's first pixel.
+ * - Bands: threads label disjoint row bands independently; the merge step only
+ *   unions the runs on both sides of each band boundary.
+ * Per component the labeler reports area and bounding box.
+ */
+
+#ifndef SIMD_CCL_H
+#define SIMD_CCL_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+struct Run {
+    int32_t x0, x1;  // [x0, x1)
+    int32_t y;
+};
+
+struct Component {
+    uint32_t area;
+    int32_t x0, y0, x1, y1;  // inclusive bounding box
+};
+
+// 1. Run extraction - Scalar implementation, one row of a byte mask
+inline void extract_runs_scalar(const uint8_t* row, int width, int y, std::vector<Run>& runs) {
+    int x = 0;
+    while (x < width) {
+        while (x < width && !row[x]) x++;
+        if (x == width) break;
+        int start = x;
+        while (x < width && row[x]) x++;
+        runs.push_back({start, x, y});
+    }
+}
+
+// 1. Run extraction - SIMD implementation, one row of a packed bit mask
+inline void extract_runs_bits(const uint64_t* words, int width, int y, std::vector<Run>& runs) {
+    const int word_count = (width + 63) / 64;
+    bool open = false;
+    int start = 0;
+    for (int w = 0; w < word_count; w++) {
+        uint64_t bits = words[w];
+        // Nothing starts or ends in an empty word outside a run
+        if (!open && bits == 0) continue;
+        if (open && bits == ~0ull) continue;
+        int pos = 0;
+        while (pos < 64) {
+            // Next set bit while outside a run, next clear bit inside one
+            uint64_t look = (open ? ~bits : bits) & (~0ull << pos);
+            if (look == 0) break;
+            int t = static_cast<int>(_tzcnt_u64(look));
+            if (open) {
+                runs.push_back({start, w * 64 + t, y});
+            } else {
+                start = w * 64 + t;
+            }
+            open = !open;
+            pos = t;
+        }
+    }
+    if (open) runs.push_back({start, width, y});
+}
+
+class ComponentLabeler {
+public:
+    ComponentLabeler(int width, int height, bool eight_connected = true)
+        : width(width), height(height), eight_connected(eight_connected) {
+        if (width <= 0 || height <= 0) {
+            throw std::invalid_argument("mask dimensions must be positive");
+        }
+    }
+
+    // bits: packed mask, bit_mask_stride(width) bytes per row (a multiple of 8)
+    const std::vector<Component>& label(const uint8_t* bits, int threads = 1) {
+        const size_t stride_words = static_cast<size_t>((width + 63) / 64);
+        threads = std::max(1, std::min(threads, height));
+
+        // Bands are labeled independently with band-local run indices
+        std::vector<Band> bands(threads);
+        auto work = [&](int b) {
+            Band& band = bands[b];
+            band.y0 = static_cast<int>(static_cast<int64_t>(height) * b / threads);
+            band.y1 = static_cast<int>(static_cast<int64_t>(height) * (b + 1) / threads);
+            band.runs.clear();
+            band.row_start.assign(band.y1 - band.y0 + 1, 0);
+            for (int y = band.y0; y < band.y1; y++) {
+                band.row_start[y - band.y0] = static_cast<int32_t>(band.runs.size());
+                const uint64_t* words = reinterpret_cast<const uint64_t*>(bits) + y * stride_words;
+                extract_runs_bits(words, width, y, band.runs);
+            }
+            band.row_start.back() = static_cast<int32_t>(band.runs.size());
+            band.parent.resize(band.runs.size());
+            for (size_t i = 0; i < band.parent.size(); i++) band.parent[i] = static_cast<int32_t>(i);
+            for (int y = band.y0 + 1; y < band.y1; y++) {
+                int r = y - band.y0;
+                link_rows(band.runs, band.parent.data(), band.row_start[r - 1], band.row_start[r],
+                          band.row_start[r], band.row_start[r + 1]);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int b = 1; b < threads; b++) pool.emplace_back(work, b);
+        work(0);
+        for (std::thread& t : pool) t.join();
+
+        // Concatenate, shifting band-local indices to global ones
+        size_t total = 0;
+        for (const Band& band : bands) total += band.runs.size();
+        runs.resize(total);
+        parent.resize(total);
+        std::vector<int32_t> offsets(threads);
+        size_t offset = 0;
+        for (int b = 0; b < threads; b++) {
+            offsets[b] = static_cast<int32_t>(offset);
+            std::copy(bands[b].runs.begin(), bands[b].runs.end(), runs.begin() + offset);
+            for (size_t i = 0; i < bands[b].parent.size(); i++) parent[offset + i] = bands[b].parent[i] + offsets[b];
+            offset += bands[b].runs.size();
+        }
+
+        // Merge step: last row of each band against the first row of the next
+        for (int b = 1; b < threads; b++) {
+            const Band& above = bands[b - 1];
+            const Band& below = bands[b];
+            int rows_above = above.y1 - above.y0;
+            link_rows(runs, parent.data(), offsets[b - 1] + above.row_start[rows_above - 1],
+                      offsets[b - 1] + above.row_start[rows_above], offsets[b] + below.row_start[0],
+                      offsets[b] + below.row_start[1]);
+        }
+
+        // Roots are the lowest index of their component, so labels follow run order
+        labels.resize(total);
+        components.clear();
+        for (size_t i = 0; i < total; i++) {
+            const Run& run = runs[i];
+            int32_t p = parent[i];
+            if (p == static_cast<int32_t>(i)) {
+                labels[i] = static_cast<int32_t>(components.size());
+                components.push_back({0, run.x0, run.y, run.x1 - 1, run.y});
+            } else {
+                labels[i] = labels[p];
+                parent[i] = parent[p];  // p's parent is already its root
+            }
+            Component& c = components[labels[i]];
+            c.area += static_cast<uint32_t>(run.x1 - run.x0);
+            c.x0 = std::min(c.x0, run.x0);
+            c.x1 = std::max(c.x1, run.x1 - 1);
+            c.y1 = run.y;
+        }
+        return components;
+    }
+
+    // Label image after label(): 0 for background, component index + 1 otherwise
+    void paint(int32_t* image) const {
+        std::memset(image, 0, static_cast<size_t>(width) * height * sizeof(int32_t));
+        for (size_t i = 0; i < runs.size(); i++) {
+            int32_t* row = image + static_cast<size_t>(runs[i].y) * width;
+            std::fill(row + runs[i].x0, row + runs[i].x1, labels[i] + 1);
+        }
+    }
+
+    size_t run_count() const { return runs.size(); }
+
+private:
+    struct Band {
+        int y0, y1;
+        std::vector<Run> runs;
+        std::vector<int32_t> row_start;  // per row, plus one past the end
+        std::vector<int32_t> parent;
+    };
+
+    static int32_t find(int32_t* parent, int32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];  // path halving
+            i = parent[i];
+        }
+        return i;
+    }
+
+    static void unite(int32_t* parent, int32_t a, int32_t b) {
+        a = find(parent, a);
+        b = find(parent, b);
+        if (a < b) {
+            parent[b] = a;
+        } else if (b < a) {
+            parent[a] = b;
+        }
+    }
+
+    // Unions every touching pair between the runs [a0, a1) of one row and [b0, b1)
+    // of the row below; both lists are sorted by x
+    void link_rows(const std::vector<Run>& all, int32_t* parent, int32_t a0, int32_t a1, int32_t b0, int32_t b1) const {
+        const int reach = eight_connected ? 1 : 0;
+        int32_t a = a0, b = b0;
+        while (a < a1 && b < b1) {
+            const Run& up = all[a];
+            const Run& down = all[b];
+            if (up.x1 + reach <= down.x0) {
+                a++;
+            } else if (down.x1 + reach <= up.x0) {
+                b++;
+            } else {
+                unite(parent, a, b);
+                // Advance whichever ends first; the other may touch the next run too
+                if (up.x1 < down.x1) {
+                    a++;
+                } else {
+                    b++;
+                }
+            }
+        }
+    }
+
+    int width, height;
+    bool eight_connected;
+    std::vector<Run> runs;
+    std::vector<int32_t> parent;
+    std::vector<int32_t> labels;
+    std::vector<Component> components;
+};
+
+#endif // SIMD_CCL_H
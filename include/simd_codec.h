@@ -0,0 +1,362 @@
+/**
+ * simd_codec.h - Fast lossless codec for intermediate frames
+ *
+ * A predictive delta + bit-plane packing codec, designed so that both directions
+ * are plain elementwise SIMD (unlike PNG/QOI, whose predictors and entropy coders
+ * are serial):
+ * - Prediction: every byte is predicted by the byte above it (same channel, row
+ *   above; zero for the first row). The residual is stored zigzag-encoded, so
+ *   small positive and negative errors both become small unsigned values.
+ * - Packing: residuals are grouped in blocks of 32 bytes. A block stores one
+ *   byte holding its bit width b (0..8) followed by b 32-bit bit planes: plane k
+ *   holds bit k of each of the 32 residuals (one _mm256_movemask_epi8 each).
+ *   Unchanged areas cost 1 byte per 32.
+ *
+ * Stream layout: per frame a 16-byte header ("SQI1", width, height, channels as
+ * little-endian uint32), then the rows in order, each ceil(width * channels / 32)
+ * blocks. Frames can follow each other in one stream.
+ *
+ * FrameEncoder and FrameDecoder work one row at a time against a byte sink or
+ * source, so frames are never held in memory twice. Every kernel has a scalar
+ * version that produces the same bytes.
+ */
+
+#ifndef SIMD_CODEC_H
+#define SIMD_CODEC_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+const size_t CODEC_BLOCK = 32;
+const size_t CODEC_HEADER_SIZE = 16;
+const size_t CODEC_MAX_BLOCK_BYTES = 1 + 8 * 4;
+
+inline size_t codec_blocks_per_row(int width, int channels) {
+    return (static_cast<size_t>(width) * channels + CODEC_BLOCK - 1) / CODEC_BLOCK;
+}
+
+// 1. Residuals - Scalar implementation: zigzag(row - above), padded with zeros to
+// whole blocks
+inline void codec_residuals_scalar(const uint8_t* row, const uint8_t* above, size_t size, uint8_t* zz) {
+    for (size_t i = 0; i < size; i++) {
+        int8_t d = static_cast<int8_t>(row[i] - above[i]);
+        zz[i] = static_cast<uint8_t>((static_cast<uint8_t>(d) << 1) ^ (d < 0 ? 0xFF : 0x00));
+    }
+}
+
+// 1. Residuals - SIMD implementation
+inline void codec_residuals_simd(const uint8_t* row, const uint8_t* above, size_t size, uint8_t* zz) {
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i));
+        __m256i d = _mm256_sub_epi8(cur, up);
+        // zigzag: (d << 1) ^ (d < 0 ? 0xFF : 0)
+        __m256i z = _mm256_xor_si256(_mm256_add_epi8(d, d), _mm256_cmpgt_epi8(zero, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(zz + i), z);
+    }
+    codec_residuals_scalar(row + i, above + i, size - i, zz + i);
+}
+
+// 2. Reconstruction - Scalar implementation: row = above + unzigzag(zz)
+inline void codec_reconstruct_scalar(const uint8_t* zz, const uint8_t* above, size_t size, uint8_t* row) {
+    for (size_t i = 0; i < size; i++) {
+        uint8_t d = static_cast<uint8_t>((zz[i] >> 1) ^ (0 - (zz[i] & 1)));
+        row[i] = static_cast<uint8_t>(above[i] + d);
+    }
+}
+
+// 2. Reconstruction - SIMD implementation
+inline void codec_reconstruct_simd(const uint8_t* zz, const uint8_t* above, size_t size, uint8_t* row) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i low7 = _mm256_set1_epi8(0x7F);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zz + i));
+        __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i));
+        __m256i half = _mm256_and_si256(_mm256_srli_epi16(z, 1), low7);
+        __m256i sign = _mm256_sub_epi8(zero, _mm256_and_si256(z, one));
+        __m256i d = _mm256_xor_si256(half, sign);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), _mm256_add_epi8(up, d));
+    }
+    codec_reconstruct_scalar(zz + i, above + i, size - i, row + i);
+}
+
+// 3. Block packing - Scalar implementation; returns bytes written (1 + 4b)
+inline size_t codec_pack_block_scalar(const uint8_t* zz, uint8_t* out) {
+    uint8_t all = 0;
+    for (size_t i = 0; i < CODEC_BLOCK; i++) all |= zz[i];
+    int bits = 0;
+    while (all >> bits) bits++;
+
+    out[0] = static_cast<uint8_t>(bits);
+    for (int k = 0; k < bits; k++) {
+        uint32_t plane = 0;
+        for (size_t i = 0; i < CODEC_BLOCK; i++) {
+            plane |= static_cast<uint32_t>((zz[i] >> k) & 1) << i;
+        }
+        std::memcpy(out + 1 + 4 * k, &plane, 4);
+    }
+    return 1 + 4 * static_cast<size_t>(bits);
+}
+
+// 3. Block packing - SIMD implementation
+inline size_t codec_pack_block_simd(const uint8_t* zz, uint8_t* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zz));
+    // Bit width from the OR of all bytes
+    __m128i o = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    o = _mm_or_si128(o, _mm_srli_si128(o, 8));
+    o = _mm_or_si128(o, _mm_srli_si128(o, 4));
+    o = _mm_or_si128(o, _mm_srli_si128(o, 2));
+    o = _mm_or_si128(o, _mm_srli_si128(o, 1));
+    uint32_t all = static_cast<uint32_t>(_mm_cvtsi128_si32(o)) & 0xFF;
+    int bits = all ? 32 - __builtin_clz(all) : 0;
+
+    out[0] = static_cast<uint8_t>(bits);
+    // Shifting 16-bit lanes left by 7 - k moves bit k of every byte to bit 7
+    // (bits from the low byte never reach bit 7 of the high byte)
+    for (int k = 0; k < bits; k++) {
+        __m256i shifted = _mm256_sll_epi16(v, _mm_cvtsi32_si128(7 - k));
+        uint32_t plane = static_cast<uint32_t>(_mm256_movemask_epi8(shifted));
+        std::memcpy(out + 1 + 4 * k, &plane, 4);
+    }
+    return 1 + 4 * static_cast<size_t>(bits);
+}
+
+// 4. Block unpacking - Scalar implementation; returns bytes consumed
+inline size_t codec_unpack_block_scalar(const uint8_t* in, uint8_t* zz) {
+    int bits = in[0];
+    std::memset(zz, 0, CODEC_BLOCK);
+    for (int k = 0; k < bits; k++) {
+        uint32_t plane;
+        std::memcpy(&plane, in + 1 + 4 * k, 4);
+        for (size_t i = 0; i < CODEC_BLOCK; i++) {
+            zz[i] |= static_cast<uint8_t>(((plane >> i) & 1) << k);
+        }
+    }
+    return 1 + 4 * static_cast<size_t>(bits);
+}
+
+// 4. Block unpacking - SIMD implementation
+inline size_t codec_unpack_block_simd(const uint8_t* in, uint8_t* zz) {
+    int bits = in[0];
+    // Byte i of the result looks at bit (i % 8) of mask byte (i / 8)
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+    __m256i acc = _mm256_setzero_si256();
+    for (int k = 0; k < bits; k++) {
+        uint32_t plane;
+        std::memcpy(&plane, in + 1 + 4 * k, 4);
+        __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(plane)), spread);
+        __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, select), select);
+        acc = _mm256_or_si256(acc, _mm256_and_si256(set, _mm256_set1_epi8(static_cast<char>(1 << k))));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(zz), acc);
+    return 1 + 4 * static_cast<size_t>(bits);
+}
+
+// ---------------------------------------------------------------------------
+// Streaming encoder / decoder
+// ---------------------------------------------------------------------------
+
+class FrameEncoder {
+public:
+    using Sink = std::function<void(const uint8_t*, size_t)>;
+
+    explicit FrameEncoder(Sink sink, bool simd = true, size_t flush_size = 1 << 16)
+        : sink(sink), simd(simd), flush_size(flush_size), width(0), height(0), channels(0),
+          rows_left(0), total(0) {}
+
+    // The sink is called with the header and encoded rows; a frame's last row
+    // always flushes, so nothing is left buffered between frames
+    void begin_frame(int frame_width, int frame_height, int frame_channels) {
+        if (rows_left != 0) {
+            throw std::logic_error("previous frame is incomplete");
+        }
+        if (frame_width <= 0 || frame_height <= 0 || frame_channels <= 0) {
+            throw std::invalid_argument("frame dimensions must be positive");
+        }
+        width = frame_width;
+        height = frame_height;
+        channels = frame_channels;
+        rows_left = height;
+
+        size_t padded = codec_blocks_per_row(width, channels) * CODEC_BLOCK;
+        above.assign(padded, 0);
+        residuals.assign(padded, 0);
+
+        uint8_t header[CODEC_HEADER_SIZE] = {'S', 'Q', 'I', '1'};
+        uint32_t fields[3] = {static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                              static_cast<uint32_t>(channels)};
+        std::memcpy(header + 4, fields, sizeof(fields));
+        append(header, sizeof(header));
+    }
+
+    // Rows must be written top to bottom
+    void write_row(const uint8_t* row) {
+        if (rows_left == 0) {
+            throw std::logic_error("write_row outside a frame");
+        }
+        size_t row_bytes = static_cast<size_t>(width) * channels;
+        size_t blocks = codec_blocks_per_row(width, channels);
+        reserve(blocks * CODEC_MAX_BLOCK_BYTES);
+
+        if (simd) {
+            codec_residuals_simd(row, above.data(), row_bytes, residuals.data());
+        } else {
+            codec_residuals_scalar(row, above.data(), row_bytes, residuals.data());
+        }
+        uint8_t* out = buffer.data() + used;
+        for (size_t b = 0; b < blocks; b++) {
+            const uint8_t* block = residuals.data() + b * CODEC_BLOCK;
+            out += simd ? codec_pack_block_simd(block, out) : codec_pack_block_scalar(block, out);
+        }
+        used = static_cast<size_t>(out - buffer.data());
+        std::memcpy(above.data(), row, row_bytes);
+
+        if (--rows_left == 0 || used >= flush_size) flush();
+    }
+
+    void flush() {
+        if (used > 0) {
+            sink(buffer.data(), used);
+            total += used;
+            used = 0;
+        }
+    }
+
+    // Bytes handed to the sink so far
+    size_t bytes_written() const { return total; }
+
+private:
+    void append(const uint8_t* data, size_t size) {
+        reserve(size);
+        std::memcpy(buffer.data() + used, data, size);
+        used += size;
+    }
+
+    void reserve(size_t size) {
+        if (buffer.size() < used + size) buffer.resize(used + size);
+    }
+
+    Sink sink;
+    bool simd;
+    size_t flush_size;
+    int width, height, channels;
+    int rows_left;
+    size_t total;
+    size_t used = 0;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> above;
+    std::vector<uint8_t> residuals;
+};
+
+class FrameDecoder {
+public:
+    // Fills up to `size` bytes; returns how many were read, 0 at end of stream
+    using Source = std::function<size_t(uint8_t*, size_t)>;
+
+    explicit FrameDecoder(Source source, bool simd = true, size_t read_size = 1 << 16)
+        : source(source), simd(simd), read_size(read_size), width(0), height(0), channels(0),
+          rows_left(0), begin(0), end(0) {}
+
+    // Reads the next frame header; returns false at end of stream
+    bool next_frame() {
+        if (rows_left != 0) {
+            throw std::logic_error("previous frame is incomplete");
+        }
+        if (!fill(CODEC_HEADER_SIZE)) {
+            if (end == begin) return false;
+            throw std::runtime_error("truncated frame header");
+        }
+        const uint8_t* header = buffer.data() + begin;
+        if (std::memcmp(header, "SQI1", 4) != 0) {
+            throw std::runtime_error("not an SQI1 stream");
+        }
+        uint32_t fields[3];
+        std::memcpy(fields, header + 4, sizeof(fields));
+        begin += CODEC_HEADER_SIZE;
+        if (fields[0] == 0 || fields[1] == 0 || fields[2] == 0 || fields[0] > (1u << 16) ||
+            fields[1] > (1u << 16) || fields[2] > 16) {
+            throw std::runtime_error("invalid frame dimensions");
+        }
+        width = static_cast<int>(fields[0]);
+        height = static_cast<int>(fields[1]);
+        channels = static_cast<int>(fields[2]);
+        rows_left = height;
+
+        size_t padded = codec_blocks_per_row(width, channels) * CODEC_BLOCK;
+        above.assign(padded, 0);
+        residuals.assign(padded, 0);
+        return true;
+    }
+
+    int frame_width() const { return width; }
+    int frame_height() const { return height; }
+    int frame_channels() const { return channels; }
+
+    // Decodes the next row of the current frame into `row`
+    void read_row(uint8_t* row) {
+        if (rows_left == 0) {
+            throw std::logic_error("read_row outside a frame");
+        }
+        size_t row_bytes = static_cast<size_t>(width) * channels;
+        size_t blocks = codec_blocks_per_row(width, channels);
+        // Enough for the worst case; the stream may legitimately end sooner
+        fill(blocks * CODEC_MAX_BLOCK_BYTES);
+
+        for (size_t b = 0; b < blocks; b++) {
+            if (begin >= end || begin + 1 + 4 * static_cast<size_t>(buffer[begin]) > end) {
+                throw std::runtime_error("truncated frame data");
+            }
+            if (buffer[begin] > 8) {
+                throw std::runtime_error("corrupt block header");
+            }
+            uint8_t* block = residuals.data() + b * CODEC_BLOCK;
+            begin += simd ? codec_unpack_block_simd(buffer.data() + begin, block)
+                          : codec_unpack_block_scalar(buffer.data() + begin, block);
+        }
+        if (simd) {
+            codec_reconstruct_simd(residuals.data(), above.data(), row_bytes, row);
+        } else {
+            codec_reconstruct_scalar(residuals.data(), above.data(), row_bytes, row);
+        }
+        std::memcpy(above.data(), row, row_bytes);
+        rows_left--;
+    }
+
+private:
+    // Tries to have `size` unread bytes buffered; returns whether it succeeded
+    bool fill(size_t size) {
+        if (end - begin >= size) return true;
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+        if (buffer.size() < size + read_size) buffer.resize(size + read_size);
+        while (end < size) {
+            size_t n = source(buffer.data() + end, buffer.size() - end);
+            if (n == 0) return false;
+            end += n;
+        }
+        return true;
+    }
+
+    Source source;
+    bool simd;
+    size_t read_size;
+    int width, height, channels;
+    int rows_left;
+    size_t begin, end;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> above;
+    std::vector<uint8_t> residuals;
+};
+
+#endif // SIMD_CODEC_H
@@ -0,0 +1,242 @@
+/**
+ * simd_color.h - 3x4 color matrix (channel mixer) for RGB images
+ *
+ * Every per-pixel linear color operation is a 3x4 matrix applied to (R, G, B, 1):
+ * grayscale, saturation, hue rotation, sepia, white balance, channel swaps and
+ * offsets. Composing several of them gives one matrix, so a whole chain costs a
+ * single pass.
+ *
+ * ColorMatrix holds the float matrix and the presets; FixedColorMatrix is its
+ * 16-bit fixed-point form (Q12 coefficients, |m| < 8) that the kernels use. The
+ * SIMD kernel deinterleaves 32 RGB pixels into R, G and B byte vectors, widens to
+ * 16 bits and evaluates each output channel with two _mm256_madd_epi16 per 8
+ * pixels ((R, G) and (B, 0) pairs). Scalar and SIMD use the same integer math and
+ * produce identical bytes; both work in place. The ImageView overloads take
+ * RGB views of the same size.
+ */
+
+#ifndef SIMD_COLOR_H
+#define SIMD_COLOR_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include "simd_view.h"
+
+struct ColorMatrix {
+    // Row i computes output channel i from (R, G, B, 1); offsets are in 0..255 units
+    float m[3][4];
+
+    static ColorMatrix identity() {
+        return {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}};
+    }
+
+    // Rec. 601 luma in every channel, the weights used by convert_to_grayscale_simd
+    static ColorMatrix grayscale() {
+        return saturation(0.0f);
+    }
+
+    // 0 = grayscale, 1 = unchanged, > 1 = more saturated
+    static ColorMatrix saturation(float s) {
+        const float lr = 0.299f, lg = 0.587f, lb = 0.114f;
+        ColorMatrix c;
+        for (int i = 0; i < 3; i++) {
+            c.m[i][0] = (1 - s) * lr + (i == 0 ? s : 0);
+            c.m[i][1] = (1 - s) * lg + (i == 1 ? s : 0);
+            c.m[i][2] = (1 - s) * lb + (i == 2 ? s : 0);
+            c.m[i][3] = 0;
+        }
+        return c;
+    }
+
+    // Rotation around the gray axis (the SVG/CSS hue-rotate matrix)
+    static ColorMatrix hue_rotate(float degrees) {
+        const float a = degrees * 3.14159265f / 180.0f;
+        const float c = std::cos(a), s = std::sin(a);
+        return {{{0.213f + c * 0.787f - s * 0.213f, 0.715f - c * 0.715f - s * 0.715f, 0.072f - c * 0.072f + s * 0.928f, 0},
+                 {0.213f - c * 0.213f + s * 0.143f, 0.715f + c * 0.285f + s * 0.140f, 0.072f - c * 0.072f - s * 0.283f, 0},
+                 {0.213f - c * 0.213f - s * 0.787f, 0.715f - c * 0.715f + s * 0.715f, 0.072f + c * 0.928f + s * 0.072f, 0}}};
+    }
+
+    static ColorMatrix sepia() {
+        return {{{0.393f, 0.769f, 0.189f, 0}, {0.349f, 0.686f, 0.168f, 0}, {0.272f, 0.534f, 0.131f, 0}}};
+    }
+
+    // Per-channel gains
+    static ColorMatrix white_balance(float r_gain, float g_gain, float b_gain) {
+        return {{{r_gain, 0, 0, 0}, {0, g_gain, 0, 0}, {0, 0, b_gain, 0}}};
+    }
+
+    // Gain around mid-gray plus an offset, like enhance_contrast + adjust_brightness
+    static ColorMatrix contrast_brightness(float contrast, float brightness) {
+        float offset = 128.0f * (1 - contrast) + brightness;
+        return {{{contrast, 0, 0, offset}, {0, contrast, 0, offset}, {0, 0, contrast, offset}}};
+    }
+
+    // This matrix followed by `next`
+    ColorMatrix then(const ColorMatrix& next) const {
+        ColorMatrix c;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                float v = j == 3 ? next.m[i][3] : 0.0f;
+                for (int k = 0; k < 3; k++) v += next.m[i][k] * m[k][j];
+                c.m[i][j] = v;
+            }
+        }
+        return c;
+    }
+};
+
+const int COLOR_FRAC_BITS = 12;
+
+struct FixedColorMatrix {
+    int16_t coeff[3][3];
+    int32_t offset[3];  // Q12, rounding bias included
+
+    explicit FixedColorMatrix(const ColorMatrix& c) {
+        const float scale = 1 << COLOR_FRAC_BITS;
+        for (int i = 0; i < 3; i++) {
+            for (int k = 0; k < 3; k++) {
+                float q = std::round(c.m[i][k] * scale);
+                if (q < -32768.0f || q > 32767.0f) {
+                    throw std::invalid_argument("color matrix coefficients must be in (-8, 8)");
+                }
+                coeff[i][k] = static_cast<int16_t>(q);
+            }
+            float off = std::max(-1024.0f, std::min(1024.0f, c.m[i][3]));
+            offset[i] = static_cast<int32_t>(std::lround(off * scale)) + (1 << (COLOR_FRAC_BITS - 1));
+        }
+    }
+};
+
+// 1. Color matrix - Scalar implementation
+inline void apply_color_matrix_scalar(const uint8_t* src, uint8_t* dst, size_t pixels, const FixedColorMatrix& fm) {
+    for (size_t i = 0; i < pixels; i++) {
+        int r = src[i * 3 + 0], g = src[i * 3 + 1], b = src[i * 3 + 2];
+        for (int c = 0; c < 3; c++) {
+            int v = (fm.coeff[c][0] * r + fm.coeff[c][1] * g + fm.coeff[c][2] * b + fm.offset[c]) >> COLOR_FRAC_BITS;
+            dst[i * 3 + c] = static_cast<uint8_t>(std::min(255, std::max(0, v)));
+        }
+    }
+}
+
+// Shuffle controls for splitting 16 RGB pixels (48 bytes in three registers) into
+// R, G and B, and for the inverse; the same in both 128-bit lanes
+struct RgbShuffles {
+    __m256i split[3][3];  // [channel][source register]
+    __m256i merge[3][3];  // [destination register][channel]
+
+    RgbShuffles() {
+        alignas(32) int8_t bytes[32];
+        for (int ch = 0; ch < 3; ch++) {
+            for (int reg = 0; reg < 3; reg++) {
+                for (int k = 0; k < 16; k++) {
+                    int pos = 3 * k + ch - 16 * reg;
+                    bytes[k] = bytes[k + 16] = static_cast<int8_t>(pos >= 0 && pos < 16 ? pos : -1);
+                }
+                split[ch][reg] = _mm256_load_si256(reinterpret_cast<const __m256i*>(bytes));
+            }
+        }
+        for (int reg = 0; reg < 3; reg++) {
+            for (int ch = 0; ch < 3; ch++) {
+                for (int p = 0; p < 16; p++) {
+                    int j = 16 * reg + p;
+                    bytes[p] = bytes[p + 16] = static_cast<int8_t>(j % 3 == ch ? j / 3 : -1);
+                }
+                merge[reg][ch] = _mm256_load_si256(reinterpret_cast<const __m256i*>(bytes));
+            }
+        }
+    }
+};
+
+inline const RgbShuffles& rgb_shuffles() {
+    static const RgbShuffles shuffles;
+    return shuffles;
+}
+
+// Splits 32 interleaved RGB pixels into R, G and B vectors (pixel order). The low
+// lanes handle pixels 0-15 (bytes 0-47), the high lanes pixels 16-31 (bytes 48-95).
+inline void rgb_deinterleave32(const uint8_t* src, __m256i& r, __m256i& g, __m256i& b) {
+    const RgbShuffles& s = rgb_shuffles();
+    __m256i in[3];
+    for (int reg = 0; reg < 3; reg++) {
+        in[reg] = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16 * reg))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48 + 16 * reg)), 1);
+    }
+    __m256i* out[3] = {&r, &g, &b};
+    for (int ch = 0; ch < 3; ch++) {
+        *out[ch] = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(in[0], s.split[ch][0]),
+                                                   _mm256_shuffle_epi8(in[1], s.split[ch][1])),
+                                   _mm256_shuffle_epi8(in[2], s.split[ch][2]));
+    }
+}
+
+// Inverse of rgb_deinterleave32
+inline void rgb_interleave32(__m256i r, __m256i g, __m256i b, uint8_t* dst) {
+    const RgbShuffles& s = rgb_shuffles();
+    for (int reg = 0; reg < 3; reg++) {
+        __m256i v = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(r, s.merge[reg][0]),
+                                                    _mm256_shuffle_epi8(g, s.merge[reg][1])),
+                                    _mm256_shuffle_epi8(b, s.merge[reg][2]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16 * reg), _mm256_castsi256_si128(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48 + 16 * reg), _mm256_extracti128_si256(v, 1));
+    }
+}
+
+// 1. Color matrix - SIMD implementation, 32 pixels per iteration
+inline void apply_color_matrix_simd(const uint8_t* src, uint8_t* dst, size_t pixels, const FixedColorMatrix& fm) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i w_rg[3], w_b[3], off[3];
+    for (int c = 0; c < 3; c++) {
+        w_rg[c] = _mm256_set1_epi32(static_cast<uint16_t>(fm.coeff[c][0]) | (static_cast<uint32_t>(static_cast<uint16_t>(fm.coeff[c][1])) << 16));
+        w_b[c] = _mm256_set1_epi32(static_cast<uint16_t>(fm.coeff[c][2]));
+        off[c] = _mm256_set1_epi32(fm.offset[c]);
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= pixels; i += 32) {
+        __m256i r, g, b;
+        rgb_deinterleave32(src + i * 3, r, g, b);
+
+        // 16-bit halves: lo = pixels 0-7 | 16-23, hi = pixels 8-15 | 24-31
+        __m256i r_lo = _mm256_unpacklo_epi8(r, zero), r_hi = _mm256_unpackhi_epi8(r, zero);
+        __m256i g_lo = _mm256_unpacklo_epi8(g, zero), g_hi = _mm256_unpackhi_epi8(g, zero);
+        __m256i b_lo = _mm256_unpacklo_epi8(b, zero), b_hi = _mm256_unpackhi_epi8(b, zero);
+        // (R, G) and (B, 0) pairs in 32-bit lanes, four groups of 8 pixels:
+        // 0-3 | 16-19, 4-7 | 20-23, 8-11 | 24-27, 12-15 | 28-31
+        __m256i rg[4] = {_mm256_unpacklo_epi16(r_lo, g_lo), _mm256_unpackhi_epi16(r_lo, g_lo),
+                         _mm256_unpacklo_epi16(r_hi, g_hi), _mm256_unpackhi_epi16(r_hi, g_hi)};
+        __m256i b0[4] = {_mm256_unpacklo_epi16(b_lo, zero), _mm256_unpackhi_epi16(b_lo, zero),
+                         _mm256_unpacklo_epi16(b_hi, zero), _mm256_unpackhi_epi16(b_hi, zero)};
+
+        __m256i result[3];
+        for (int c = 0; c < 3; c++) {
+            __m256i v[4];
+            for (int q = 0; q < 4; q++) {
+                __m256i sum = _mm256_add_epi32(_mm256_madd_epi16(rg[q], w_rg[c]), _mm256_madd_epi16(b0[q], w_b[c]));
+                v[q] = _mm256_srai_epi32(_mm256_add_epi32(sum, off[c]), COLOR_FRAC_BITS);
+            }
+            // Packing undoes the unpacking order, and saturates to 0..255
+            result[c] = _mm256_packus_epi16(_mm256_packs_epi32(v[0], v[1]), _mm256_packs_epi32(v[2], v[3]));
+        }
+        rgb_interleave32(result[0], result[1], result[2], dst + i * 3);
+    }
+    apply_color_matrix_scalar(src + i * 3, dst + i * 3, pixels - i, fm);
+}
+
+inline void apply_color_matrix_scalar(const ConstImageView& src, const ImageView& dst, const FixedColorMatrix& fm) {
+    check_channels(src, 3);
+    check_channels(dst, 3);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) { apply_color_matrix_scalar(s, d, pixels, fm); });
+}
+
+inline void apply_color_matrix_simd(const ConstImageView& src, const ImageView& dst, const FixedColorMatrix& fm) {
+    check_channels(src, 3);
+    check_channels(dst, 3);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) { apply_color_matrix_simd(s, d, pixels, fm); });
+}
+
+#endif // SIMD_COLOR_H
@@ -0,0 +1,456 @@
+/**
+ * simd_denoise.h - Edge-preserving denoising: bilateral and guided filters
+ *
+ * Box and Gaussian blurs average across edges. Both filters here smooth flat
+ * regions but keep edges, on 8-bit single-channel images (luma, or one plane at a
+ * time), with borders replicated:
+ * - Bilateral: each neighbour in a (2r+1)^2 window is weighted by a spatial
+ *   Gaussian (a table per offset) times a range Gaussian of the intensity
+ *   difference (a 256-entry LUT). The SIMD kernel handles 16 pixels per
+ *   iteration in float, gathering the range weights with _mm256_i32gather_ps.
+ * - Guided filter (self-guided): per window a linear model q = a I + b with
+ *   a = var / (var + eps), then the window means of a and b. Everything rests on
+ *   (2r+1)^2 box sums, computed with running column sums and row prefix sums, so
+ *   the cost does not depend on the radius. Box sums are exact int32; a and b
+ *   are stored in fixed point (a in Q12, b in 1/16 levels), so they are integers
+ *   as well.
+ *
+ * Scalar and SIMD versions use the same float operations in the same order
+ * (explicit fma in both) and produce identical bytes. The SIMD versions take a
+ * thread count: the bilateral filter splits the image into tiles, the guided
+ * filter into row bands for each of its two passes (batch_for, simd_batch.h).
+ */
+
+#ifndef SIMD_DENOISE_H
+#define SIMD_DENOISE_H
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "simd_view.h"
+#include "simd_batch.h"
+
+const int BILATERAL_MAX_RADIUS = 16;
+const int GUIDED_MAX_RADIUS = 64;  // keeps the (2r+1)^2 window sums of I^2 below 2^31
+// Output tile of a bilateral worker, and row band of a guided filter pass
+const int DENOISE_TILE = 128;
+const int DENOISE_BAND = 64;
+
+inline int denoise_clamp(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+inline void check_denoise_views(const ConstImageView& src, const ImageView& dst, int radius, int max_radius) {
+    check_same_size(src, dst);
+    check_channels(src, 1);
+    check_channels(dst, 1);
+    if (radius < 1 || radius > max_radius) {
+        throw std::invalid_argument("denoise radius out of range");
+    }
+}
+
+// The weights divide by 2 sigma^2, which must not be 0 (or underflow to it)
+inline void check_bilateral_args(float sigma_space, float sigma_range) {
+    if (!(sigma_space > 0.0f) || !(sigma_range > 0.0f) || !(2.0f * sigma_space * sigma_space > 0.0f) ||
+        !(2.0f * sigma_range * sigma_range > 0.0f)) {
+        throw std::invalid_argument("bilateral filter needs sigma_space > 0 and sigma_range > 0");
+    }
+}
+
+// eps keeps a / b finite on flat windows, where the variance is 0
+inline void check_guided_args(float eps) {
+    if (!(eps > 0.0f)) {
+        throw std::invalid_argument("guided filter needs eps > 0");
+    }
+}
+
+inline bool denoise_empty(const ConstImageView& src) {
+    return src.width == 0 || src.height == 0;
+}
+
+struct BilateralWeights {
+    std::vector<float> space;  // (2r+1)^2, row by row
+    float range[256];          // by absolute intensity difference
+
+    BilateralWeights(int r, float sigma_space, float sigma_range) {
+        for (int dy = -r; dy <= r; dy++) {
+            for (int dx = -r; dx <= r; dx++) {
+                space.push_back(std::exp(-(dx * dx + dy * dy) / (2.0f * sigma_space * sigma_space)));
+            }
+        }
+        for (int d = 0; d < 256; d++) range[d] = std::exp(-(d * d) / (2.0f * sigma_range * sigma_range));
+    }
+};
+
+// One output pixel; `p` points at its center in the padded image
+inline uint8_t bilateral_pixel(const uint8_t* p, size_t pw, int r, const BilateralWeights& w) {
+    const int center = p[0];
+    float num = 0.0f, den = 0.0f;
+    const float* ws = w.space.data();
+    for (int dy = -r; dy <= r; dy++) {
+        const uint8_t* row = p + dy * static_cast<ptrdiff_t>(pw);
+        for (int dx = -r; dx <= r; dx++, ws++) {
+            int q = row[dx];
+            float wr = w.range[std::abs(q - center)];
+            num = std::fma(*ws * wr, static_cast<float>(q), num);
+            den = std::fma(*ws, wr, den);
+        }
+    }
+    return static_cast<uint8_t>(std::nearbyint(num / den));
+}
+
+// 1. Bilateral filter - Scalar implementation
+inline void bilateral_filter_scalar(const ConstImageView& src, const ImageView& dst, int radius, float sigma_space,
+                                    float sigma_range) {
+    check_denoise_views(src, dst, radius, BILATERAL_MAX_RADIUS);
+    check_bilateral_args(sigma_space, sigma_range);
+    if (denoise_empty(src)) return;
+    const BilateralWeights w(radius, sigma_space, sigma_range);
+    const std::vector<uint8_t> padded = replicate_border(src, radius);
+    const size_t pw = src.width + 2 * radius;
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* center = padded.data() + (y + radius) * pw + radius;
+        uint8_t* out = dst.row(y);
+        for (int x = 0; x < src.width; x++) out[x] = bilateral_pixel(center + x, pw, radius, w);
+    }
+}
+
+inline void bilateral_filter_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int radius,
+                                    float sigma_space, float sigma_range) {
+    bilateral_filter_scalar(ConstImageView(src, width, height), ImageView(dst, width, height), radius, sigma_space,
+                            sigma_range);
+}
+
+// 8 pixels: num/den accumulation for one window offset
+inline void bilateral_tap8(const uint8_t* q_ptr, __m256i center, __m256 ws, const float* range, __m256& num,
+                           __m256& den) {
+    __m256i q = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q_ptr)));
+    __m256 wr = _mm256_i32gather_ps(range, _mm256_abs_epi32(_mm256_sub_epi32(q, center)), 4);
+    num = _mm256_fmadd_ps(_mm256_mul_ps(ws, wr), _mm256_cvtepi32_ps(q), num);
+    den = _mm256_fmadd_ps(ws, wr, den);
+}
+
+// 8 output bytes from num/den, rounded to nearest even like std::nearbyint
+inline void bilateral_store8(__m256 num, __m256 den, uint8_t* out) {
+    __m256i v = _mm256_cvtps_epi32(_mm256_div_ps(num, den));
+    __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words, words));
+}
+
+// 1. Bilateral filter - SIMD implementation, 16 pixels per iteration, tiles
+// spread over `threads` threads
+inline void bilateral_filter_simd(const ConstImageView& src, const ImageView& dst, int radius, float sigma_space,
+                                  float sigma_range, int threads = 1) {
+    check_denoise_views(src, dst, radius, BILATERAL_MAX_RADIUS);
+    check_bilateral_args(sigma_space, sigma_range);
+    if (denoise_empty(src)) return;
+    const BilateralWeights w(radius, sigma_space, sigma_range);
+    const std::vector<uint8_t> padded = replicate_border(src, radius);
+    const size_t pw = src.width + 2 * radius;
+    const int r = radius;
+    const int tiles_x = (src.width + DENOISE_TILE - 1) / DENOISE_TILE;
+    const int tiles_y = (src.height + DENOISE_TILE - 1) / DENOISE_TILE;
+
+    batch_for(static_cast<size_t>(tiles_x) * tiles_y, threads, [&](size_t begin, size_t end, int) {
+        for (size_t t = begin; t < end; t++) {
+            const int x0 = static_cast<int>(t % tiles_x) * DENOISE_TILE;
+            const int y0 = static_cast<int>(t / tiles_x) * DENOISE_TILE;
+            const int x1 = std::min(src.width, x0 + DENOISE_TILE);
+            const int y1 = std::min(src.height, y0 + DENOISE_TILE);
+            for (int y = y0; y < y1; y++) {
+                const uint8_t* center = padded.data() + (y + r) * pw + r;
+                uint8_t* out = dst.row(y);
+                int x = x0;
+                for (; x + 16 <= x1; x += 16) {
+                    const __m256i c0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(center + x)));
+                    const __m256i c1 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(center + x + 8)));
+                    __m256 num0 = _mm256_setzero_ps(), den0 = _mm256_setzero_ps();
+                    __m256 num1 = _mm256_setzero_ps(), den1 = _mm256_setzero_ps();
+                    const float* ws = w.space.data();
+                    for (int dy = -r; dy <= r; dy++) {
+                        const uint8_t* row = center + x + dy * static_cast<ptrdiff_t>(pw);
+                        for (int dx = -r; dx <= r; dx++, ws++) {
+                            const __m256 wsv = _mm256_set1_ps(*ws);
+                            bilateral_tap8(row + dx, c0, wsv, w.range, num0, den0);
+                            bilateral_tap8(row + dx + 8, c1, wsv, w.range, num1, den1);
+                        }
+                    }
+                    bilateral_store8(num0, den0, out + x);
+                    bilateral_store8(num1, den1, out + x + 8);
+                }
+                for (; x + 8 <= x1; x += 8) {
+                    const __m256i c0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(center + x)));
+                    __m256 num = _mm256_setzero_ps(), den = _mm256_setzero_ps();
+                    const float* ws = w.space.data();
+                    for (int dy = -r; dy <= r; dy++) {
+                        const uint8_t* row = center + x + dy * static_cast<ptrdiff_t>(pw);
+                        for (int dx = -r; dx <= r; dx++, ws++) {
+                            bilateral_tap8(row + dx, c0, _mm256_set1_ps(*ws), w.range, num, den);
+                        }
+                    }
+                    bilateral_store8(num, den, out + x);
+                }
+                for (; x < x1; x++) out[x] = bilateral_pixel(center + x, pw, r, w);
+            }
+        }
+    }, 1);
+}
+
+inline void bilateral_filter_simd(const uint8_t* src, uint8_t* dst, int width, int height, int radius,
+                                  float sigma_space, float sigma_range, int threads = 1) {
+    bilateral_filter_simd(ConstImageView(src, width, height), ImageView(dst, width, height), radius, sigma_space,
+                          sigma_range, threads);
+}
+
+// Fixed-point scales of the guided filter's linear model
+const float GUIDED_A_SCALE = 4096.0f;  // a in Q12
+const float GUIDED_B_SCALE = 16.0f;    // b in 1/16 levels
+
+// Per-pixel model from the window sums of I and I^2
+inline void guided_model(int32_t sum, int32_t sum_sq, float inv_n, float eps, int32_t& a_fixed, int32_t& b_fixed) {
+    float mean = static_cast<float>(sum) * inv_n;
+    float var = std::fma(-mean, mean, static_cast<float>(sum_sq) * inv_n);
+    float a = var / (var + eps);
+    float b = std::fma(-a, mean, mean);
+    a_fixed = static_cast<int32_t>(std::nearbyint(a * GUIDED_A_SCALE));
+    b_fixed = static_cast<int32_t>(std::nearbyint(b * GUIDED_B_SCALE));
+}
+
+// Output pixel from the window sums of a and b
+inline uint8_t guided_output(int32_t sum_a, int32_t sum_b, int pixel, float inv_n) {
+    float q = std::fma(static_cast<float>(sum_a) * (inv_n / GUIDED_A_SCALE), static_cast<float>(pixel),
+                       static_cast<float>(sum_b) * (inv_n / GUIDED_B_SCALE));
+    return static_cast<uint8_t>(denoise_clamp(static_cast<int>(std::nearbyint(q)), 0, 255));
+}
+
+// Box sums - Scalar implementation: separable direct sums over (2r+1)^2 windows
+// of an int32 plane, replicated borders
+inline void box_sums_scalar(const int32_t* plane, int width, int height, int r, int32_t* out) {
+    std::vector<int32_t> col(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int32_t s = 0;
+            for (int k = -r; k <= r; k++) s += plane[static_cast<size_t>(denoise_clamp(y + k, 0, height - 1)) * width + x];
+            col[static_cast<size_t>(y) * width + x] = s;
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        const int32_t* c = col.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            int32_t s = 0;
+            for (int k = -r; k <= r; k++) s += c[denoise_clamp(x + k, 0, width - 1)];
+            out[static_cast<size_t>(y) * width + x] = s;
+        }
+    }
+}
+
+// 2. Guided filter - Scalar implementation
+inline void guided_filter_scalar(const ConstImageView& src, const ImageView& dst, int radius, float eps) {
+    check_denoise_views(src, dst, radius, GUIDED_MAX_RADIUS);
+    check_guided_args(eps);
+    if (denoise_empty(src)) return;
+    const int w = src.width, h = src.height;
+    const size_t n = static_cast<size_t>(w) * h;
+    const float inv_n = 1.0f / ((2 * radius + 1) * (2 * radius + 1));
+    std::vector<int32_t> plane(n), plane_sq(n), sum(n), sum_sq(n);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int v = src.row(y)[x];
+            plane[static_cast<size_t>(y) * w + x] = v;
+            plane_sq[static_cast<size_t>(y) * w + x] = v * v;
+        }
+    }
+    box_sums_scalar(plane.data(), w, h, radius, sum.data());
+    box_sums_scalar(plane_sq.data(), w, h, radius, sum_sq.data());
+    // The planes now hold a and b
+    for (size_t i = 0; i < n; i++) guided_model(sum[i], sum_sq[i], inv_n, eps, plane[i], plane_sq[i]);
+    box_sums_scalar(plane.data(), w, h, radius, sum.data());
+    box_sums_scalar(plane_sq.data(), w, h, radius, sum_sq.data());
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            size_t i = static_cast<size_t>(y) * w + x;
+            dst.row(y)[x] = guided_output(sum[i], sum_sq[i], src.row(y)[x], inv_n);
+        }
+    }
+}
+
+inline void guided_filter_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int radius, float eps) {
+    guided_filter_scalar(ConstImageView(src, width, height), ImageView(dst, width, height), radius, eps);
+}
+
+// Box sums - SIMD implementation. Column sums slide down one row at a time
+// (add the entering row, subtract the leaving one, 8 columns per instruction);
+// each row of column sums becomes window sums through a prefix sum.
+
+// add_row(y, subtract) for the first window of y0, then the entering and
+// leaving rows of each next one; emit_row(y) once the column sums cover row y
+template<typename AddRow, typename EmitRow>
+inline void slide_box_rows(int height, int r, int y0, int y1, AddRow add_row, EmitRow emit_row) {
+    for (int k = -r; k <= r; k++) add_row(denoise_clamp(y0 + k, 0, height - 1), false);
+    for (int y = y0; y < y1; y++) {
+        if (y > y0) {
+            add_row(denoise_clamp(y + r, 0, height - 1), false);
+            add_row(denoise_clamp(y - r - 1, 0, height - 1), true);
+        }
+        emit_row(y);
+    }
+}
+
+inline void column_add_simd(int32_t* col, const int32_t* row, int width, bool subtract) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + x));
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+        c = subtract ? _mm256_sub_epi32(c, v) : _mm256_add_epi32(c, v);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(col + x), c);
+    }
+    for (; x < width; x++) col[x] += subtract ? -row[x] : row[x];
+}
+
+// Column sums of I and I^2 straight from 8-bit samples
+inline void column_add_u8_simd(int32_t* col, int32_t* col_sq, const uint8_t* row, int width, bool subtract) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x)));
+        __m256i v_sq = _mm256_mullo_epi32(v, v);
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col + x));
+        __m256i c_sq = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(col_sq + x));
+        c = subtract ? _mm256_sub_epi32(c, v) : _mm256_add_epi32(c, v);
+        c_sq = subtract ? _mm256_sub_epi32(c_sq, v_sq) : _mm256_add_epi32(c_sq, v_sq);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(col + x), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(col_sq + x), c_sq);
+    }
+    for (; x < width; x++) {
+        col[x] += subtract ? -row[x] : row[x];
+        col_sq[x] += subtract ? -row[x] * row[x] : row[x] * row[x];
+    }
+}
+
+// Window sums of one row of column sums; prefix holds width + 2r + 1 entries.
+// The prefix of a row of I^2 sums outgrows int32, so it is kept unsigned: it
+// wraps modulo 2^32, and the differences, which do fit, come out exact.
+inline void row_window_sums_simd(const int32_t* col, int width, int r, uint32_t* prefix, int32_t* out) {
+    // Prefix over the row extended by r replicated columns on each side
+    uint32_t running = 0;
+    uint32_t* p = prefix;
+    *p++ = 0;
+    for (int j = 0; j < r; j++) *p++ = running += static_cast<uint32_t>(col[0]);
+    for (int x = 0; x < width; x++) *p++ = running += static_cast<uint32_t>(col[x]);
+    for (int j = 0; j < r; j++) *p++ = running += static_cast<uint32_t>(col[width - 1]);
+    const int span = 2 * r + 1;
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefix + x + span));
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prefix + x));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), _mm256_sub_epi32(hi, lo));
+    }
+    for (; x < width; x++) out[x] = static_cast<int32_t>(prefix[x + span] - prefix[x]);
+}
+
+// 2. Guided filter - SIMD implementation: two passes over row bands, each band
+// on whichever thread claims it. Pass 1 reads the 8-bit rows directly and
+// writes a and b; pass 2 slides over a and b and writes the output, one row of
+// window sums at a time.
+inline void guided_filter_simd(const ConstImageView& src, const ImageView& dst, int radius, float eps,
+                               int threads = 1) {
+    check_denoise_views(src, dst, radius, GUIDED_MAX_RADIUS);
+    check_guided_args(eps);
+    if (denoise_empty(src)) return;
+    const int w = src.width, h = src.height;
+    const size_t n = static_cast<size_t>(w) * h;
+    const float inv_n = 1.0f / ((2 * radius + 1) * (2 * radius + 1));
+    const int workers = std::max(1, threads);
+    const size_t bands = (h + DENOISE_BAND - 1) / DENOISE_BAND;
+
+    std::vector<int32_t> a(n), b(n);
+    // Per-worker rows: column sums, prefix and window sums of two quantities
+    struct Scratch {
+        std::vector<int32_t> col, col2, sum, sum2;
+        std::vector<uint32_t> prefix;
+    };
+    std::vector<Scratch> scratch(workers);
+    for (Scratch& s : scratch) {
+        s.prefix.resize(w + 2 * radius + 1);
+        s.sum.resize(w);
+        s.sum2.resize(w);
+    }
+
+    const __m256 inv_n_vec = _mm256_set1_ps(inv_n);
+    const __m256 eps_vec = _mm256_set1_ps(eps);
+    const __m256 a_scale = _mm256_set1_ps(GUIDED_A_SCALE);
+    const __m256 b_scale = _mm256_set1_ps(GUIDED_B_SCALE);
+
+    // Pass 1: window sums of I and I^2 -> a and b
+    batch_for(bands, threads, [&](size_t begin, size_t end, int worker) {
+        Scratch& s = scratch[worker];
+        for (size_t band = begin; band < end; band++) {
+            const int y0 = static_cast<int>(band) * DENOISE_BAND, y1 = std::min(h, y0 + DENOISE_BAND);
+            s.col.assign(w, 0);
+            s.col2.assign(w, 0);
+            slide_box_rows(h, radius, y0, y1,
+                [&](int y, bool subtract) { column_add_u8_simd(s.col.data(), s.col2.data(), src.row(y), w, subtract); },
+                [&](int y) {
+                    row_window_sums_simd(s.col.data(), w, radius, s.prefix.data(), s.sum.data());
+                    row_window_sums_simd(s.col2.data(), w, radius, s.prefix.data(), s.sum2.data());
+                    int32_t* a_out = a.data() + static_cast<size_t>(y) * w;
+                    int32_t* b_out = b.data() + static_cast<size_t>(y) * w;
+                    int x = 0;
+                    for (; x + 8 <= w; x += 8) {
+                        __m256 sum = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.sum.data() + x)));
+                        __m256 sum_sq = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.sum2.data() + x)));
+                        __m256 mean = _mm256_mul_ps(sum, inv_n_vec);
+                        __m256 var = _mm256_fnmadd_ps(mean, mean, _mm256_mul_ps(sum_sq, inv_n_vec));
+                        __m256 av = _mm256_div_ps(var, _mm256_add_ps(var, eps_vec));
+                        __m256 bv = _mm256_fnmadd_ps(av, mean, mean);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a_out + x), _mm256_cvtps_epi32(_mm256_mul_ps(av, a_scale)));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b_out + x), _mm256_cvtps_epi32(_mm256_mul_ps(bv, b_scale)));
+                    }
+                    for (; x < w; x++) guided_model(s.sum[x], s.sum2[x], inv_n, eps, a_out[x], b_out[x]);
+                });
+        }
+    }, 1);
+
+    // Pass 2: window sums of a and b -> output
+    const __m256 ka = _mm256_set1_ps(inv_n / GUIDED_A_SCALE);
+    const __m256 kb = _mm256_set1_ps(inv_n / GUIDED_B_SCALE);
+    batch_for(bands, threads, [&](size_t begin, size_t end, int worker) {
+        Scratch& s = scratch[worker];
+        for (size_t band = begin; band < end; band++) {
+            const int y0 = static_cast<int>(band) * DENOISE_BAND, y1 = std::min(h, y0 + DENOISE_BAND);
+            s.col.assign(w, 0);
+            s.col2.assign(w, 0);
+            slide_box_rows(h, radius, y0, y1,
+                [&](int y, bool subtract) {
+                    column_add_simd(s.col.data(), a.data() + static_cast<size_t>(y) * w, w, subtract);
+                    column_add_simd(s.col2.data(), b.data() + static_cast<size_t>(y) * w, w, subtract);
+                },
+                [&](int y) {
+                    row_window_sums_simd(s.col.data(), w, radius, s.prefix.data(), s.sum.data());
+                    row_window_sums_simd(s.col2.data(), w, radius, s.prefix.data(), s.sum2.data());
+                    const uint8_t* in = src.row(y);
+                    uint8_t* out = dst.row(y);
+                    int x = 0;
+                    for (; x + 8 <= w; x += 8) {
+                        __m256 pixel = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + x))));
+                        __m256 fa = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.sum.data() + x))), ka);
+                        __m256 fb = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.sum2.data() + x))), kb);
+                        __m256i q = _mm256_cvtps_epi32(_mm256_fmadd_ps(fa, pixel, fb));
+                        // Saturating packs clamp to 0..255
+                        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(words, words));
+                    }
+                    for (; x < w; x++) out[x] = guided_output(s.sum[x], s.sum2[x], in[x], inv_n);
+                });
+        }
+    }, 1);
+}
+
+inline void guided_filter_simd(const uint8_t* src, uint8_t* dst, int width, int height, int radius, float eps,
+                               int threads = 1) {
+    guided_filter_simd(ConstImageView(src, width, height), ImageView(dst, width, height), radius, eps, threads);
+}
+
+#endif // SIMD_DENOISE_H
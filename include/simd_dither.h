@@ -0,0 +1,384 @@
+/**
+ * simd_dither.h - Dithering and palette quantization for low-bit displays
+ *
+ * E-ink panels and small LCDs show 2 to 16 gray levels per channel, or a handful
+ * of fixed colors. Reducing an 8-bit image to them:
+ * - Ordered (Bayer) dithering: each sample gets the 8x8 Bayer threshold of its
+ *   pixel position, level = (v * (levels - 1) + offset) / 255. The SIMD kernel
+ *   does 32 samples per iteration in 16-bit lanes, divides by 255 with a shift
+ *   identity and maps levels to output bytes with one _mm256_shuffle_epi8.
+ * - Floyd-Steinberg error diffusion: the quantization error of each sample goes
+ *   7/16 to the right, 3/16, 5/16 and 1/16 to the row below. Along a row the
+ *   chain is serial, but everything a row receives from the row above is a 3-tap
+ *   filter of that row's errors, 3 e[x + 1] + 5 e[x] + e[x - 1]; the SIMD kernel
+ *   computes that carry row 16 samples at a time instead of scattering three
+ *   updates per sample.
+ * - Palette quantization: nearest palette color by squared RGB distance. The
+ *   SIMD kernel deinterleaves 32 pixels and gets the distances to one palette
+ *   entry with two _mm256_madd_epi16 per 8 pixels ((dR, dG) and (dB, 0) pairs);
+ *   ties go to the lower index, as in the scalar version.
+ *
+ * Levels are 2..16, spread evenly over 0..255; interleaved images have 1 or
+ * more channels, each dithered on its own. All arithmetic is integer, so scalar
+ * and SIMD versions produce identical bytes. A 1-bit result can be packed for
+ * the panel with mask_to_bits_simd (simd_threshold.h). The ImageView overloads
+ * (simd_view.h) accept any row stride; the pointer versions take tight rows.
+ */
+
+#ifndef SIMD_DITHER_H
+#define SIMD_DITHER_H
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "simd_view.h"
+#include "simd_color.h"
+
+inline void check_dither_levels(int levels) {
+    if (levels < 2 || levels > 16) {
+        throw std::invalid_argument("dither levels must be 2..16");
+    }
+}
+
+// Output byte of each level: level * 255 / (levels - 1), rounded
+inline void dither_level_values(int levels, uint8_t values[16]) {
+    for (int l = 0; l < 16; l++) {
+        int level = std::min(l, levels - 1);
+        values[l] = static_cast<uint8_t>((level * 255 + (levels - 1) / 2) / (levels - 1));
+    }
+}
+
+// Bayer threshold offsets in 1/255 level units, ((2 m + 1) * 255) / 128, for the
+// 8x8 index matrix m
+inline const uint16_t* bayer_offsets(int y) {
+    static const uint8_t index[8][8] = {
+        {0, 32, 8, 40, 2, 34, 10, 42},  {48, 16, 56, 24, 50, 18, 58, 26},
+        {12, 44, 4, 36, 14, 46, 6, 38}, {60, 28, 52, 20, 62, 30, 54, 22},
+        {3, 35, 11, 43, 1, 33, 9, 41},  {51, 19, 59, 27, 49, 17, 57, 25},
+        {15, 47, 7, 39, 13, 45, 5, 37}, {63, 31, 55, 23, 61, 29, 53, 21}};
+    struct Table {
+        uint16_t offsets[8][8];
+        Table() {
+            for (int r = 0; r < 8; r++) {
+                for (int c = 0; c < 8; c++) offsets[r][c] = static_cast<uint16_t>(((2 * index[r][c] + 1) * 255) / 128);
+            }
+        }
+    };
+    static const Table table;
+    return table.offsets[y & 7];
+}
+
+// 1. Ordered dithering - Scalar implementation
+inline void bayer_dither_scalar(const ConstImageView& src, const ImageView& dst, int levels) {
+    check_dither_levels(levels);
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    uint8_t values[16];
+    dither_level_values(levels, values);
+    for (int y = 0; y < src.height; y++) {
+        const uint16_t* offsets = bayer_offsets(y);
+        const uint8_t* in = src.row(y);
+        uint8_t* out = dst.row(y);
+        for (int x = 0; x < src.width; x++) {
+            for (int c = 0; c < src.channels; c++) {
+                int i = x * src.channels + c;
+                out[i] = values[(in[i] * (levels - 1) + offsets[x & 7]) / 255];
+            }
+        }
+    }
+}
+
+inline void bayer_dither_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels, int levels) {
+    bayer_dither_scalar(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels), levels);
+}
+
+// 1. Ordered dithering - SIMD implementation, 32 samples per iteration
+inline void bayer_dither_simd(const ConstImageView& src, const ImageView& dst, int levels) {
+    check_dither_levels(levels);
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    alignas(16) uint8_t values[16];
+    dither_level_values(levels, values);
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(values)));
+    const __m256i scale = _mm256_set1_epi16(static_cast<int16_t>(levels - 1));
+    const __m256i one = _mm256_set1_epi16(1);
+
+    // Per-sample offsets of the 8 Bayer rows; a row's pattern repeats every 8 pixels
+    const int row_elems = static_cast<int>(src.row_elements());
+    std::vector<uint16_t> thresholds(static_cast<size_t>(8) * row_elems);
+    for (int r = 0; r < 8; r++) {
+        const uint16_t* offsets = bayer_offsets(r);
+        for (int i = 0; i < row_elems; i++) thresholds[r * row_elems + i] = offsets[(i / src.channels) & 7];
+    }
+
+    // floor(x / 255) = (x + 1 + (x >> 8)) >> 8 for x < 65535; here x <= 255 * 15 + 253
+    auto quantize = [&](__m256i v16, const uint16_t* t) {
+        __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(v16, scale),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t)));
+        return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+    };
+
+    for (int y = 0; y < src.height; y++) {
+        const uint16_t* t = thresholds.data() + static_cast<size_t>(y & 7) * row_elems;
+        const uint16_t* offsets = bayer_offsets(y);
+        const uint8_t* in = src.row(y);
+        uint8_t* out = dst.row(y);
+        int i = 0;
+        for (; i <= row_elems - 32; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i lo = quantize(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)), t + i);
+            __m256i hi = quantize(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)), t + i + 16);
+            // packus interleaves the 128-bit lanes; restore sample order
+            __m256i level = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(lut, level));
+        }
+        for (; i < row_elems; i++) {
+            out[i] = values[(in[i] * (levels - 1) + offsets[(i / src.channels) & 7]) / 255];
+        }
+    }
+}
+
+inline void bayer_dither_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels, int levels) {
+    bayer_dither_simd(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels), levels);
+}
+
+// Quantizer for error diffusion: nearest level value of every (clamped) sample
+struct DiffusionLevels {
+    uint8_t nearest[256];
+
+    explicit DiffusionLevels(int levels) {
+        check_dither_levels(levels);
+        uint8_t values[16];
+        dither_level_values(levels, values);
+        for (int v = 0; v < 256; v++) nearest[v] = values[(v * (levels - 1) + 127) / 255];
+    }
+};
+
+// One sample of Floyd-Steinberg: `incoming` is everything diffused into it, in
+// 1/16 units; returns the quantization error
+inline int diffuse_sample(uint8_t in, int incoming, const DiffusionLevels& q, uint8_t& out) {
+    int v = std::min(255, std::max(0, in + ((incoming + 8) >> 4)));
+    out = q.nearest[v];
+    return v - out;
+}
+
+// 2. Floyd-Steinberg - Scalar implementation: every error is scattered into an
+// accumulator for the row below as it is produced
+inline void floyd_steinberg_scalar(const ConstImageView& src, const ImageView& dst, int levels) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    const DiffusionLevels q(levels);
+    const int ch = src.channels;
+    const int row_elems = static_cast<int>(src.row_elements());
+    // Accumulators with `ch` samples of padding at each end, in 1/16 units
+    std::vector<int> below(row_elems + 2 * ch), next(row_elems + 2 * ch);
+    for (int y = 0; y < src.height; y++) {
+        std::fill(next.begin(), next.end(), 0);
+        const uint8_t* in = src.row(y);
+        uint8_t* out = dst.row(y);
+        for (int c = 0; c < ch; c++) {
+            int right = 0;  // 7/16 of the previous error of this channel
+            for (int i = c; i < row_elems; i += ch) {
+                int e = diffuse_sample(in[i], below[i + ch] + right, q, out[i]);
+                right = 7 * e;
+                next[i] += 3 * e;           // below left
+                next[i + ch] += 5 * e;      // below
+                next[i + 2 * ch] += e;      // below right
+            }
+        }
+        std::swap(below, next);
+    }
+}
+
+inline void floyd_steinberg_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+                                   int levels) {
+    floyd_steinberg_scalar(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels),
+                           levels);
+}
+
+// 2. Floyd-Steinberg - SIMD implementation: the serial pass only records each
+// row's errors; the carry into the next row, 3 e[i + ch] + 5 e[i] + e[i - ch], is
+// one vectorized 3-tap pass over the error row
+inline void floyd_steinberg_simd(const ConstImageView& src, const ImageView& dst, int levels) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    const DiffusionLevels q(levels);
+    const int ch = src.channels;
+    const int row_elems = static_cast<int>(src.row_elements());
+    // Errors (|e| <= 255) with `ch` zero samples at each end; carry <= 9 * 255,
+    // so 16-bit lanes are enough
+    std::vector<int16_t> errors(row_elems + 2 * ch, 0), carry(row_elems + 16, 0);
+    int16_t* e = errors.data() + ch;
+    const __m256i three = _mm256_set1_epi16(3);
+    const __m256i five = _mm256_set1_epi16(5);
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* in = src.row(y);
+        uint8_t* out = dst.row(y);
+        // Serial pass, one chain per channel; the left error stays in a register
+        for (int c = 0; c < ch; c++) {
+            int left = 0;
+            for (int i = c; i < row_elems; i += ch) {
+                left = diffuse_sample(in[i], carry[i] + 7 * left, q, out[i]);
+                e[i] = static_cast<int16_t>(left);
+            }
+        }
+        // Carry into the next row
+        int i = 0;
+        for (; i <= row_elems - 16; i += 16) {
+            __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e + i - ch));
+            __m256i center = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e + i));
+            __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e + i + ch));
+            __m256i sum = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(right, three),
+                                                            _mm256_mullo_epi16(center, five)), left);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(carry.data() + i), sum);
+        }
+        for (; i < row_elems; i++) carry[i] = static_cast<int16_t>(3 * e[i + ch] + 5 * e[i] + e[i - ch]);
+    }
+}
+
+inline void floyd_steinberg_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+                                 int levels) {
+    floyd_steinberg_simd(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels),
+                         levels);
+}
+
+struct PaletteColor {
+    uint8_t r, g, b;
+};
+
+// Evenly spaced grays, as the dither levels
+inline std::vector<PaletteColor> palette_gray(int levels) {
+    check_dither_levels(levels);
+    uint8_t values[16];
+    dither_level_values(levels, values);
+    std::vector<PaletteColor> palette;
+    for (int l = 0; l < levels; l++) palette.push_back({values[l], values[l], values[l]});
+    return palette;
+}
+
+// The seven inks of 7-color e-paper panels
+inline std::vector<PaletteColor> palette_eink7() {
+    return {{0, 0, 0}, {255, 255, 255}, {0, 255, 0}, {0, 0, 255}, {255, 0, 0}, {255, 255, 0}, {255, 128, 0}};
+}
+
+// 6x6x6 color cube
+inline std::vector<PaletteColor> palette_web_safe() {
+    std::vector<PaletteColor> palette;
+    for (int r = 0; r < 6; r++) {
+        for (int g = 0; g < 6; g++) {
+            for (int b = 0; b < 6; b++) {
+                palette.push_back({static_cast<uint8_t>(51 * r), static_cast<uint8_t>(51 * g), static_cast<uint8_t>(51 * b)});
+            }
+        }
+    }
+    return palette;
+}
+
+inline void check_palette(const std::vector<PaletteColor>& palette) {
+    if (palette.empty() || palette.size() > 256) {
+        throw std::invalid_argument("palette must have 1..256 colors");
+    }
+}
+
+// 3. Palette quantization - Scalar implementation: index of the nearest color
+inline void quantize_palette_scalar(const uint8_t* rgb, uint8_t* index, size_t pixels,
+                                    const std::vector<PaletteColor>& palette) {
+    check_palette(palette);
+    for (size_t p = 0; p < pixels; p++) {
+        const uint8_t* px = rgb + p * 3;
+        int best = 0, best_dist = 1 << 30;
+        for (size_t k = 0; k < palette.size(); k++) {
+            int dr = px[0] - palette[k].r, dg = px[1] - palette[k].g, db = px[2] - palette[k].b;
+            int dist = dr * dr + dg * dg + db * db;
+            if (dist < best_dist) {
+                best_dist = dist;
+                best = static_cast<int>(k);
+            }
+        }
+        index[p] = static_cast<uint8_t>(best);
+    }
+}
+
+// 3. Palette quantization - SIMD implementation, 32 pixels per iteration
+inline void quantize_palette_simd(const uint8_t* rgb, uint8_t* index, size_t pixels,
+                                  const std::vector<PaletteColor>& palette) {
+    check_palette(palette);
+    const __m256i zero = _mm256_setzero_si256();
+    // Each entry as 32-bit (R, G) and (B, 0) pairs of 16-bit values
+    std::vector<int32_t> entry_rg(palette.size()), entry_b(palette.size());
+    for (size_t k = 0; k < palette.size(); k++) {
+        entry_rg[k] = palette[k].r | (palette[k].g << 16);
+        entry_b[k] = palette[k].b;
+    }
+
+    size_t p = 0;
+    for (; p + 32 <= pixels; p += 32) {
+        __m256i r, g, b;
+        rgb_deinterleave32(rgb + p * 3, r, g, b);
+        __m256i r_lo = _mm256_unpacklo_epi8(r, zero), r_hi = _mm256_unpackhi_epi8(r, zero);
+        __m256i g_lo = _mm256_unpacklo_epi8(g, zero), g_hi = _mm256_unpackhi_epi8(g, zero);
+        __m256i b_lo = _mm256_unpacklo_epi8(b, zero), b_hi = _mm256_unpackhi_epi8(b, zero);
+        // Four groups of 8 pixels: 0-3 | 16-19, 4-7 | 20-23, 8-11 | 24-27, 12-15 | 28-31
+        __m256i rg[4] = {_mm256_unpacklo_epi16(r_lo, g_lo), _mm256_unpackhi_epi16(r_lo, g_lo),
+                         _mm256_unpacklo_epi16(r_hi, g_hi), _mm256_unpackhi_epi16(r_hi, g_hi)};
+        __m256i b0[4] = {_mm256_unpacklo_epi16(b_lo, zero), _mm256_unpackhi_epi16(b_lo, zero),
+                         _mm256_unpacklo_epi16(b_hi, zero), _mm256_unpackhi_epi16(b_hi, zero)};
+
+        __m256i best_dist[4], best[4];
+        for (int q = 0; q < 4; q++) {
+            best_dist[q] = _mm256_set1_epi32(1 << 30);
+            best[q] = zero;
+        }
+        for (size_t k = 0; k < palette.size(); k++) {
+            const __m256i id = _mm256_set1_epi32(static_cast<int>(k));
+            const __m256i p_rg = _mm256_set1_epi32(entry_rg[k]);
+            const __m256i p_b = _mm256_set1_epi32(entry_b[k]);
+            for (int q = 0; q < 4; q++) {
+                __m256i d_rg = _mm256_sub_epi16(rg[q], p_rg);
+                __m256i d_b = _mm256_sub_epi16(b0[q], p_b);
+                __m256i dist = _mm256_add_epi32(_mm256_madd_epi16(d_rg, d_rg), _mm256_madd_epi16(d_b, d_b));
+                // Strictly closer only, so ties keep the lower index
+                __m256i closer = _mm256_cmpgt_epi32(best_dist[q], dist);
+                best_dist[q] = _mm256_min_epi32(best_dist[q], dist);
+                best[q] = _mm256_blendv_epi8(best[q], id, closer);
+            }
+        }
+        // Packing undoes the unpacking order
+        __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(best[0], best[1]), _mm256_packs_epi32(best[2], best[3]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(index + p), packed);
+    }
+    quantize_palette_scalar(rgb + p * 3, index + p, pixels - p, palette);
+}
+
+// Palette indices back to RGB
+inline void palette_to_rgb(const uint8_t* index, uint8_t* rgb, size_t pixels, const std::vector<PaletteColor>& palette) {
+    for (size_t p = 0; p < pixels; p++) {
+        const PaletteColor& c = palette[index[p]];
+        rgb[p * 3 + 0] = c.r;
+        rgb[p * 3 + 1] = c.g;
+        rgb[p * 3 + 2] = c.b;
+    }
+}
+
+// src: RGB, index: one channel
+inline void quantize_palette_scalar(const ConstImageView& src, const ImageView& index,
+                                    const std::vector<PaletteColor>& palette) {
+    check_channels(src, 3);
+    check_channels(index, 1);
+    for_each_span(src, index, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        quantize_palette_scalar(s, d, pixels, palette);
+    });
+}
+
+inline void quantize_palette_simd(const ConstImageView& src, const ImageView& index,
+                                  const std::vector<PaletteColor>& palette) {
+    check_channels(src, 3);
+    check_channels(index, 1);
+    for_each_span(src, index, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        quantize_palette_simd(s, d, pixels, palette);
+    });
+}
+
+#endif // SIMD_DITHER_H
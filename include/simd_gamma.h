@@ -0,0 +1,389 @@
+/**
+ * simd_gamma.h - Linear-light image operations
+ *
+ * 8-bit images are sRGB encoded: byte values are roughly proportional to
+ * perceived brightness, not to light. Averaging them (blurring, resizing, mixing
+ * channels into grayscale) darkens edges and saturated colors and causes banding.
+ * The physically correct way is to decode to linear light, operate there, and
+ * encode back:
+ * - srgb_to_linear: 256-entry table, bytes -> 12-bit linear (0..4095) in uint16
+ * - linear_to_srgb: 4096-entry table, 12-bit linear -> bytes
+ * Both tables are int32 so the SIMD versions can use _mm256_i32gather_epi32, and
+ * every sRGB byte survives the round trip unchanged.
+ *
+ * The linear-light kernels (grayscale, 1-2-1 blur, 2x box downscale) work on
+ * interleaved data with any channel count; the blur and downscale take the
+ * uint16 planes, so the same code also runs on widened sRGB bytes for comparison.
+ * All kernels also take image views (simd_view.h); the blur and downscale read
+ * neighbouring rows through the views' strides.
+ */
+
+#ifndef SIMD_GAMMA_H
+#define SIMD_GAMMA_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "simd_view.h"
+
+const int LINEAR_MAX = 4095;
+
+struct GammaTables {
+    int32_t to_linear[256];
+    int32_t to_srgb[LINEAR_MAX + 1];
+
+    GammaTables() {
+        for (int v = 0; v < 256; v++) {
+            double c = v / 255.0;
+            double l = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            to_linear[v] = static_cast<int32_t>(std::lround(l * LINEAR_MAX));
+        }
+        for (int i = 0; i <= LINEAR_MAX; i++) {
+            double l = static_cast<double>(i) / LINEAR_MAX;
+            double c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+            to_srgb[i] = static_cast<int32_t>(std::lround(c * 255.0));
+        }
+    }
+};
+
+// Built on first use
+inline const GammaTables& gamma_tables() {
+    static const GammaTables tables;
+    return tables;
+}
+
+// 1. sRGB to linear - Scalar implementation
+inline void srgb_to_linear_scalar(const uint8_t* src, uint16_t* dst, size_t count) {
+    const int32_t* lut = gamma_tables().to_linear;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = static_cast<uint16_t>(lut[src[i]]);
+    }
+}
+
+// 1. sRGB to linear - SIMD implementation
+inline void srgb_to_linear_simd(const uint8_t* src, uint16_t* dst, size_t count) {
+    const int32_t* lut = gamma_tables().to_linear;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m256i lo = _mm256_i32gather_epi32(lut, _mm256_cvtepu8_epi32(bytes), 4);
+        __m256i hi = _mm256_i32gather_epi32(lut, _mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)), 4);
+        // packus works per 128-bit lane; restore element order afterwards
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+    srgb_to_linear_scalar(src + i, dst + i, count - i);
+}
+
+// 2. Linear to sRGB - Scalar implementation (values above LINEAR_MAX saturate)
+inline void linear_to_srgb_scalar(const uint16_t* src, uint8_t* dst, size_t count) {
+    const int32_t* lut = gamma_tables().to_srgb;
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = static_cast<uint8_t>(lut[std::min<int>(src[i], LINEAR_MAX)]);
+    }
+}
+
+// 2. Linear to sRGB - SIMD implementation
+inline void linear_to_srgb_simd(const uint16_t* src, uint8_t* dst, size_t count) {
+    const int32_t* lut = gamma_tables().to_srgb;
+    const __m256i max = _mm256_set1_epi16(LINEAR_MAX);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_min_epu16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), max);
+        __m256i lo = _mm256_i32gather_epi32(lut, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)), 4);
+        __m256i hi = _mm256_i32gather_epi32(lut, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)), 4);
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    linear_to_srgb_scalar(src + i, dst + i, count - i);
+}
+
+// Plain widening / narrowing, for running the uint16 kernels on sRGB bytes
+inline void widen_u8_to_u16_simd(const uint8_t* src, uint16_t* dst, size_t count) {
+    const size_t vec_end = count - count % 16;
+    size_t i = 0;
+    for (; i < vec_end; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(bytes));
+    }
+    for (; i < count; i++) dst[i] = src[i];
+}
+
+inline void narrow_u16_to_u8_simd(const uint16_t* src, uint8_t* dst, size_t count) {
+    const size_t vec_end = count - count % 16;
+    size_t i = 0;
+    for (; i < vec_end; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+    for (; i < count; i++) dst[i] = static_cast<uint8_t>(std::min<int>(src[i], 255));
+}
+
+// Per-element conversions on views with the same size and channel count
+template<typename Src, typename Dst, typename Fn>
+inline void convert_view(const ImageViewT<Src>& src, const ImageViewT<Dst>& dst, Fn kernel) {
+    check_channels(dst, src.channels);
+    for_each_span(src, dst, [&](Src* s, Dst* d, size_t pixels) { kernel(s, d, pixels * src.channels); });
+}
+
+inline void srgb_to_linear_scalar(const ConstImageView& src, const ImageView16& dst) {
+    convert_view(src, dst, [](const uint8_t* s, uint16_t* d, size_t n) { srgb_to_linear_scalar(s, d, n); });
+}
+
+inline void srgb_to_linear_simd(const ConstImageView& src, const ImageView16& dst) {
+    convert_view(src, dst, [](const uint8_t* s, uint16_t* d, size_t n) { srgb_to_linear_simd(s, d, n); });
+}
+
+inline void linear_to_srgb_scalar(const ConstImageView16& src, const ImageView& dst) {
+    convert_view(src, dst, [](const uint16_t* s, uint8_t* d, size_t n) { linear_to_srgb_scalar(s, d, n); });
+}
+
+inline void linear_to_srgb_simd(const ConstImageView16& src, const ImageView& dst) {
+    convert_view(src, dst, [](const uint16_t* s, uint8_t* d, size_t n) { linear_to_srgb_simd(s, d, n); });
+}
+
+inline void widen_u8_to_u16_simd(const ConstImageView& src, const ImageView16& dst) {
+    convert_view(src, dst, [](const uint8_t* s, uint16_t* d, size_t n) { widen_u8_to_u16_simd(s, d, n); });
+}
+
+inline void narrow_u16_to_u8_simd(const ConstImageView16& src, const ImageView& dst) {
+    convert_view(src, dst, [](const uint16_t* s, uint8_t* d, size_t n) { narrow_u16_to_u8_simd(s, d, n); });
+}
+
+// Rec. 709 luminance weights for linear RGB, scaled by 4096 (sum 4096)
+const int LUMA_R = 871;
+const int LUMA_G = 2929;
+const int LUMA_B = 296;
+
+// 3. Linear-light grayscale - Scalar implementation
+inline void grayscale_linear_scalar(const uint8_t* src, uint8_t* dst, int width, int height) {
+    const GammaTables& t = gamma_tables();
+    size_t pixels = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixels; i++) {
+        const uint8_t* p = src + i * 3;
+        int y = (t.to_linear[p[0]] * LUMA_R + t.to_linear[p[1]] * LUMA_G + t.to_linear[p[2]] * LUMA_B + 2048) >> 12;
+        dst[i] = static_cast<uint8_t>(t.to_srgb[y]);
+    }
+}
+
+// 3. Linear-light grayscale - SIMD implementation, 8 pixels per iteration
+inline void grayscale_linear_simd(const uint8_t* src, uint8_t* dst, int width, int height) {
+    const GammaTables& t = gamma_tables();
+    size_t pixels = static_cast<size_t>(width) * height;
+    // Move pixels 0-3 (bytes 0-11) to the low lane and pixels 4-7 (bytes 12-23) to the high lane
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i pick_r = _mm256_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1,
+                                            0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1);
+    const __m256i pick_g = _mm256_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1,
+                                            1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1);
+    const __m256i pick_b = _mm256_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1,
+                                            2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+    // R and G share a dword (G in the high half) so one madd applies both weights
+    const __m256i w_rg = _mm256_set1_epi32(LUMA_R | (LUMA_G << 16));
+    const __m256i w_b = _mm256_set1_epi32(LUMA_B);
+    const __m256i half = _mm256_set1_epi32(2048);
+
+    size_t i = 0;
+    // The 32-byte load covers 8 pixels plus 8 bytes of the next ones
+    for (; (i + 8) * 3 + 8 <= pixels * 3; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 3));
+        v = _mm256_permutevar8x32_epi32(v, spread);
+        __m256i r = _mm256_i32gather_epi32(t.to_linear, _mm256_shuffle_epi8(v, pick_r), 4);
+        __m256i g = _mm256_i32gather_epi32(t.to_linear, _mm256_shuffle_epi8(v, pick_g), 4);
+        __m256i b = _mm256_i32gather_epi32(t.to_linear, _mm256_shuffle_epi8(v, pick_b), 4);
+        __m256i rg = _mm256_or_si256(r, _mm256_slli_epi32(g, 16));
+        __m256i y = _mm256_add_epi32(_mm256_madd_epi16(rg, w_rg), _mm256_madd_epi16(b, w_b));
+        y = _mm256_add_epi32(y, half);
+        __m256i gray = _mm256_i32gather_epi32(t.to_srgb, _mm256_srli_epi32(y, 12), 4);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtepi32_epi8(gray));
+    }
+    for (; i < pixels; i++) {
+        const uint8_t* p = src + i * 3;
+        int y = (t.to_linear[p[0]] * LUMA_R + t.to_linear[p[1]] * LUMA_G + t.to_linear[p[2]] * LUMA_B + 2048) >> 12;
+        dst[i] = static_cast<uint8_t>(t.to_srgb[y]);
+    }
+}
+
+// src: RGB, dst: one channel
+inline void grayscale_linear_scalar(const ConstImageView& src, const ImageView& dst) {
+    check_channels(src, 3);
+    check_channels(dst, 1);
+    for_each_span(src, dst, [](const uint8_t* s, uint8_t* d, size_t pixels) {
+        grayscale_linear_scalar(s, d, static_cast<int>(pixels), 1);
+    });
+}
+
+inline void grayscale_linear_simd(const ConstImageView& src, const ImageView& dst) {
+    check_channels(src, 3);
+    check_channels(dst, 1);
+    for_each_span(src, dst, [](const uint8_t* s, uint8_t* d, size_t pixels) {
+        grayscale_linear_simd(s, d, static_cast<int>(pixels), 1);
+    });
+}
+
+// 4. 1-2-1 blur (3x3 separable, replicated borders) - Scalar implementation.
+// Inputs must not exceed LINEAR_MAX so the 16x-weighted sums fit in 16 bits.
+inline void blur3_u16_scalar(const ConstImageView16& src, const ImageView16& dst) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    const int width = src.width, height = src.height, channels = src.channels;
+    const size_t row = src.row_elements();
+    auto vsum = [&](int y, size_t i) {
+        return src.row(y > 0 ? y - 1 : 0)[i] + 2 * src.row(y)[i] + src.row(y < height - 1 ? y + 1 : y)[i];
+    };
+    for (int y = 0; y < height; y++) {
+        uint16_t* out = dst.row(y);
+        for (size_t i = 0; i < row; i++) {
+            size_t x = i / channels;
+            size_t left = x > 0 ? i - channels : i;
+            size_t right = x + 1 < static_cast<size_t>(width) ? i + channels : i;
+            out[i] = static_cast<uint16_t>((vsum(y, left) + 2 * vsum(y, i) + vsum(y, right) + 8) >> 4);
+        }
+    }
+}
+
+inline void blur3_u16_scalar(const uint16_t* src, uint16_t* dst, int width, int height, int channels) {
+    blur3_u16_scalar(ConstImageView16(src, width, height, channels), ImageView16(dst, width, height, channels));
+}
+
+// 4. 1-2-1 blur - SIMD implementation: vertical pass into a row padded by one
+// pixel on each side, then the horizontal pass with shifted loads
+inline void blur3_u16_simd(const ConstImageView16& src, const ImageView16& dst) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    const int height = src.height;
+    const size_t row = src.row_elements();
+    const size_t c = static_cast<size_t>(src.channels);
+    std::vector<uint16_t> padded(row + 2 * c);
+    uint16_t* vrow = padded.data() + c;
+    const __m256i eight = _mm256_set1_epi16(8);
+
+    for (int y = 0; y < height; y++) {
+        const uint16_t* above = src.row(y > 0 ? y - 1 : 0);
+        const uint16_t* center = src.row(y);
+        const uint16_t* below = src.row(y < height - 1 ? y + 1 : y);
+        size_t i = 0;
+        for (; i + 16 <= row; i += 16) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + i));
+            __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(center + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + i));
+            __m256i s = _mm256_add_epi16(_mm256_add_epi16(a, b), _mm256_add_epi16(m, m));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(vrow + i), s);
+        }
+        for (; i < row; i++) vrow[i] = static_cast<uint16_t>(above[i] + 2 * center[i] + below[i]);
+        std::memcpy(padded.data(), vrow, c * sizeof(uint16_t));
+        std::memcpy(vrow + row, vrow + row - c, c * sizeof(uint16_t));
+
+        uint16_t* out = dst.row(y);
+        i = 0;
+        for (; i + 16 <= row; i += 16) {
+            __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vrow + i - c));
+            __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vrow + i));
+            __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vrow + i + c));
+            __m256i s = _mm256_add_epi16(_mm256_add_epi16(l, r), _mm256_add_epi16(m, m));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_srli_epi16(_mm256_add_epi16(s, eight), 4));
+        }
+        for (; i < row; i++) {
+            out[i] = static_cast<uint16_t>((vrow[i - c] + 2 * vrow[i] + vrow[i + c] + 8) >> 4);
+        }
+    }
+}
+
+inline void blur3_u16_simd(const uint16_t* src, uint16_t* dst, int width, int height, int channels) {
+    blur3_u16_simd(ConstImageView16(src, width, height, channels), ImageView16(dst, width, height, channels));
+}
+
+// dst must be (src.width / 2) x (src.height / 2) with the same channel count
+template<typename Src, typename Dst>
+inline void check_half_size(const ImageViewT<Src>& src, const ImageViewT<Dst>& dst) {
+    if (dst.width != src.width / 2 || dst.height != src.height / 2 || dst.channels != src.channels) {
+        throw std::invalid_argument("downscale target must be half the source size");
+    }
+}
+
+// 5. 2x box downscale (odd last row/column dropped) - Scalar implementation
+inline void resize_half_u16_scalar(const ConstImageView16& src, const ImageView16& dst) {
+    check_half_size(src, dst);
+    const int channels = src.channels;
+    for (int y = 0; y < dst.height; y++) {
+        const uint16_t* a = src.row(2 * y);
+        const uint16_t* b = src.row(2 * y + 1);
+        uint16_t* out = dst.row(y);
+        for (int x = 0; x < dst.width; x++) {
+            for (int ch = 0; ch < channels; ch++) {
+                size_t i = static_cast<size_t>(2 * x) * channels + ch;
+                out[static_cast<size_t>(x) * channels + ch] =
+                    static_cast<uint16_t>((a[i] + a[i + channels] + b[i] + b[i + channels] + 2) >> 2);
+            }
+        }
+    }
+}
+
+inline void resize_half_u16_scalar(const uint16_t* src, uint16_t* dst, int width, int height, int channels) {
+    resize_half_u16_scalar(ConstImageView16(src, width, height, channels),
+                           ImageView16(dst, width / 2, height / 2, channels));
+}
+
+// 5. 2x box downscale - SIMD implementation. Row pairs and neighbouring pixels are
+// summed with plain adds; every other pixel is then picked with a gather driven by
+// a per-call index table, which works for any channel count.
+inline void resize_half_u16_simd(const ConstImageView16& src, const ImageView16& dst) {
+    check_half_size(src, dst);
+    const size_t row = src.row_elements();
+    const size_t c = static_cast<size_t>(src.channels);
+    const int out_h = dst.height;
+    const size_t out_row = dst.row_elements();
+
+    std::vector<int32_t> pick(out_row);
+    for (size_t j = 0; j < out_row; j++) pick[j] = static_cast<int32_t>((j / c) * 2 * c + j % c);
+    // Sums of a pixel and its right neighbour; padded so gathers and shifted loads stay in bounds
+    std::vector<uint16_t> vsum(row + c + 16, 0), hsum(row + 16, 0);
+    const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+    const __m256i two = _mm256_set1_epi32(2);
+
+    for (int y = 0; y < out_h; y++) {
+        const uint16_t* a = src.row(2 * y);
+        const uint16_t* b = src.row(2 * y + 1);
+        size_t i = 0;
+        for (; i + 16 <= row; i += 16) {
+            __m256i s = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(vsum.data() + i), s);
+        }
+        for (; i < row; i++) vsum[i] = static_cast<uint16_t>(a[i] + b[i]);
+        for (i = 0; i + 16 <= row; i += 16) {
+            __m256i s = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vsum.data() + i)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vsum.data() + i + c)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(hsum.data() + i), s);
+        }
+        for (; i < row; i++) hsum[i] = static_cast<uint16_t>(vsum[i] + vsum[i + c]);
+
+        uint16_t* out = dst.row(y);
+        const int* base = reinterpret_cast<const int*>(hsum.data());
+        size_t j = 0;
+        for (; j + 16 <= out_row; j += 16) {
+            __m256i idx_lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pick.data() + j));
+            __m256i idx_hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pick.data() + j + 8));
+            // Scale 2 addresses uint16 elements; the upper half of each dword is the next element
+            __m256i lo = _mm256_and_si256(_mm256_i32gather_epi32(base, idx_lo, 2), low16);
+            __m256i hi = _mm256_and_si256(_mm256_i32gather_epi32(base, idx_hi, 2), low16);
+            lo = _mm256_srli_epi32(_mm256_add_epi32(lo, two), 2);
+            hi = _mm256_srli_epi32(_mm256_add_epi32(hi, two), 2);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), packed);
+        }
+        for (; j < out_row; j++) out[j] = static_cast<uint16_t>((hsum[pick[j]] + 2) >> 2);
+    }
+}
+
+inline void resize_half_u16_simd(const uint16_t* src, uint16_t* dst, int width, int height, int channels) {
+    resize_half_u16_simd(ConstImageView16(src, width, height, channels),
+                         ImageView16(dst, width / 2, height / 2, channels));
+}
+
+#endif // SIMD_GAMMA_H
@@ -0,0 +1,563 @@
+/**
+ * simd_image.h - Image processing kernels shared by the image examples
+ *
+ * The kernels from 03_Examples/04_image_processing, collected here so that
+ * later examples (streaming, pipelines, servers) can reuse them:
+ * - Test image generation and printing helpers, binary PPM output
+ * - Brightness adjustment (scalar and SIMD)
+ * - Contrast enhancement (scalar and SIMD)
+ * - Grayscale conversion (scalar and SIMD)
+ *
+ * Images are interleaved RGB, 3 bytes per pixel, rows stored back to back.
+ * Every operation comes in place (image, ...) and out of place (src, dst, ...);
+ * out-of-place pointers are __restrict and must not overlap. The _stream forms
+ * are out of place with non-temporal stores, for frames larger than the cache.
+ * Every kernel also has an ImageView overload (simd_view.h) for regions of
+ * interest and padded rows, and an _aligned version for ImageBuffer (rows
+ * padded to 64 pixels, 64-byte aligned) that has no tail handling at all.
+ * enhance_contrast_simd uses _mm256_cvtepi32_epi8, so compile with
+ * -mavx512f -mavx512vl as in the image examples.
+ */
+
+#ifndef SIMD_IMAGE_H
+#define SIMD_IMAGE_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "simd_view.h"
+
+// Interleaved RGB
+const int RGB_CHANNELS = 3;
+
+// Utility function to initialize a test image
+inline void initialize_test_image(uint8_t* image, int width, int height, int channels) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int idx = (y * width + x) * channels;
+            
+            // Create a gradient pattern
+            image[idx + 0] = static_cast<uint8_t>(x * 255 / width);  // R
+            image[idx + 1] = static_cast<uint8_t>(y * 255 / height); // G
+            image[idx + 2] = static_cast<uint8_t>(128);              // B
+        }
+    }
+}
+
+// Print a small section of the image for verification
+inline void print_image_section(const uint8_t* image, int width, int channels, 
+                         int start_x, int start_y, int section_width, int section_height) {
+    std::cout << "Image section (" << start_x << "," << start_y << ") to (" 
+              << start_x + section_width - 1 << "," << start_y + section_height - 1 << "):" << std::endl;
+    
+    for (int y = start_y; y < start_y + section_height; y++) {
+        for (int x = start_x; x < start_x + section_width; x++) {
+            int idx = (y * width + x) * channels;
+            std::cout << "(" << static_cast<int>(image[idx + 0]) << ","
+                      << static_cast<int>(image[idx + 1]) << ","
+                      << static_cast<int>(image[idx + 2]) << ") ";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Write interleaved RGB as a binary PPM (P6); false if the file cannot be written
+inline bool write_ppm(const std::string& path, const uint8_t* rgb, int width, int height) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    const size_t bytes = static_cast<size_t>(width) * height * RGB_CHANNELS;
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size() &&
+              std::fwrite(rgb, 1, bytes, file) == bytes;
+    return std::fclose(file) == 0 && ok;
+}
+
+// 1. Brightness adjustment - Scalar implementation
+inline void adjust_brightness_scalar(uint8_t* image, int size, int brightness) {
+    for (int i = 0; i < size; i++) {
+        int value = static_cast<int>(image[i]) + brightness;
+        image[i] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+    }
+}
+
+// 1. Brightness adjustment - SIMD implementation
+inline void adjust_brightness_simd(uint8_t* image, int size, int brightness) {
+    // Create a vector with the brightness value
+    __m256i brightness_vec = _mm256_set1_epi8(static_cast<char>(brightness));
+    __m256i zero_vec = _mm256_setzero_si256();
+    __m256i max_vec = _mm256_set1_epi8(static_cast<char>(255));
+    
+    // Process 32 bytes at a time (32 pixels)
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        // Load 32 bytes
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&image[i]));
+        
+        // Add brightness
+        __m256i result = _mm256_adds_epu8(pixels, brightness_vec);
+        
+        // Store result
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&image[i]), result);
+    }
+    
+    // Handle remaining pixels
+    for (; i < size; i++) {
+        int value = static_cast<int>(image[i]) + brightness;
+        image[i] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+    }
+}
+
+// Packs four vectors of 8 int32 (each 0..255) into 32 bytes in order
+inline __m256i pack_epi32_to_epu8(__m256i q0, __m256i q1, __m256i q2, __m256i q3) {
+    // packs/packus interleave the 128-bit lanes; the dword permute restores order
+    __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(q0, q1), _mm256_packs_epi32(q2, q3));
+    return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+// Contrast on 32 bytes with the float math (and rounding) of enhance_contrast_simd
+inline __m256i enhance_contrast_x32(__m256i v, __m256 contrast_vec) {
+    const __m256 offset_vec = _mm256_set1_ps(128.0f);
+    const __m256 min_vec = _mm256_setzero_ps();
+    const __m256 max_vec = _mm256_set1_ps(255.0f);
+    auto apply = [&](__m128i part) -> __m256i {
+        __m256 f = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(part));
+        f = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(f, offset_vec), contrast_vec), offset_vec);
+        return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(f, min_vec), max_vec));
+    };
+    __m128i lo = _mm256_castsi256_si128(v);
+    __m128i hi = _mm256_extracti128_si256(v, 1);
+    return pack_epi32_to_epu8(apply(lo), apply(_mm_srli_si128(lo, 8)), apply(hi), apply(_mm_srli_si128(hi, 8)));
+}
+
+// 2. Contrast enhancement - Scalar implementation
+inline void enhance_contrast_scalar(uint8_t* image, int size, float contrast) {
+    // Apply contrast formula: (pixel - 128) * contrast + 128
+    for (int i = 0; i < size; i++) {
+        float value = (static_cast<float>(image[i]) - 128.0f) * contrast + 128.0f;
+        image[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value)));
+    }
+}
+
+// 2. Contrast enhancement - SIMD implementation
+inline void enhance_contrast_simd(uint8_t* image, int size, float contrast) {
+    // Pixels are converted to float for the calculation
+    __m256 contrast_vec = _mm256_set1_ps(contrast);
+    __m256 offset_vec = _mm256_set1_ps(128.0f);
+    __m256 min_vec = _mm256_setzero_ps();
+    __m256 max_vec = _mm256_set1_ps(255.0f);
+    
+    // 32 pixels at a time while possible, then 8
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&image[i]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&image[i]), enhance_contrast_x32(pixels, contrast_vec));
+    }
+    for (; i <= size - 8; i += 8) {
+        // Load 8 bytes and convert to float
+        __m128i pixels_epi8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&image[i]));
+        __m256i pixels_epi32 = _mm256_cvtepu8_epi32(pixels_epi8);
+        __m256 pixels_ps = _mm256_cvtepi32_ps(pixels_epi32);
+        
+        // Apply contrast formula: (pixel - 128) * contrast + 128
+        __m256 centered = _mm256_sub_ps(pixels_ps, offset_vec);
+        __m256 scaled = _mm256_mul_ps(centered, contrast_vec);
+        __m256 result_ps = _mm256_add_ps(scaled, offset_vec);
+        
+        // Clamp to [0, 255]
+        result_ps = _mm256_min_ps(_mm256_max_ps(result_ps, min_vec), max_vec);
+        
+        // Convert back to integers and store
+        __m256i result_epi32 = _mm256_cvtps_epi32(result_ps);
+        __m128i result_epi8 = _mm256_cvtepi32_epi8(result_epi32);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&image[i]), result_epi8);
+    }
+    
+    // Handle remaining pixels, rounding like _mm256_cvtps_epi32 so the result does
+    // not depend on where a span ends (image views call this once per row)
+    for (; i < size; i++) {
+        float value = (static_cast<float>(image[i]) - 128.0f) * contrast + 128.0f;
+        image[i] = static_cast<uint8_t>(std::nearbyint(std::min(255.0f, std::max(0.0f, value))));
+    }
+}
+
+// 3. Grayscale conversion - Scalar implementation
+inline void convert_to_grayscale_scalar(const uint8_t* __restrict src, uint8_t* __restrict dst, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int src_idx = (y * width + x) * RGB_CHANNELS;
+            int dst_idx = y * width + x;
+            
+            // Standard grayscale conversion weights
+            uint8_t gray = static_cast<uint8_t>(
+                0.299f * src[src_idx + 0] +  // R
+                0.587f * src[src_idx + 1] +  // G
+                0.114f * src[src_idx + 2]    // B
+            );
+            
+            dst[dst_idx] = gray;
+        }
+    }
+}
+
+// 3. Grayscale conversion - SIMD implementation
+inline void convert_to_grayscale_simd(const uint8_t* __restrict src, uint8_t* __restrict dst, int width, int height) {
+    // RGB to Grayscale conversion weights
+    const float weight_r = 0.299f;
+    const float weight_g = 0.587f;
+    const float weight_b = 0.114f;
+    
+    // Process 4 pixels at a time (4 pixels * 3 channels = 12 bytes)
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x += 4) {
+            // Handle edge case
+            if (x + 4 > width) {
+                // Fall back to scalar for the last few pixels
+                for (int i = x; i < width; i++) {
+                    int src_idx = (y * width + i) * 3;
+                    float r = static_cast<float>(src[src_idx + 0]);
+                    float g = static_cast<float>(src[src_idx + 1]);
+                    float b = static_cast<float>(src[src_idx + 2]);
+                    
+                    float gray = r * weight_r + g * weight_g + b * weight_b;
+                    dst[y * width + i] = static_cast<uint8_t>(gray);
+                }
+                break;
+            }
+            
+            // Process 4 pixels at once using AVX2
+            __m128i pixel0 = _mm_set_epi32(0, src[(y * width + x + 0) * 3 + 2], 
+                                          src[(y * width + x + 0) * 3 + 1], 
+                                          src[(y * width + x + 0) * 3 + 0]);
+            __m128i pixel1 = _mm_set_epi32(0, src[(y * width + x + 1) * 3 + 2], 
+                                          src[(y * width + x + 1) * 3 + 1], 
+                                          src[(y * width + x + 1) * 3 + 0]);
+            __m128i pixel2 = _mm_set_epi32(0, src[(y * width + x + 2) * 3 + 2], 
+                                          src[(y * width + x + 2) * 3 + 1], 
+                                          src[(y * width + x + 2) * 3 + 0]);
+            __m128i pixel3 = _mm_set_epi32(0, src[(y * width + x + 3) * 3 + 2], 
+                                          src[(y * width + x + 3) * 3 + 1], 
+                                          src[(y * width + x + 3) * 3 + 0]);
+            
+            // Convert to float for calculations
+            __m128 pixel0_ps = _mm_cvtepi32_ps(pixel0);
+            __m128 pixel1_ps = _mm_cvtepi32_ps(pixel1);
+            __m128 pixel2_ps = _mm_cvtepi32_ps(pixel2);
+            __m128 pixel3_ps = _mm_cvtepi32_ps(pixel3);
+            
+            // Apply weights
+            __m128 weights = _mm_set_ps(0.0f, weight_b, weight_g, weight_r);
+            
+            // Dot product for each pixel
+            __m128 gray0 = _mm_dp_ps(pixel0_ps, weights, 0x71);
+            __m128 gray1 = _mm_dp_ps(pixel1_ps, weights, 0x71);
+            __m128 gray2 = _mm_dp_ps(pixel2_ps, weights, 0x71);
+            __m128 gray3 = _mm_dp_ps(pixel3_ps, weights, 0x71);
+            
+            // Convert back to integers
+            __m128i gray0_epi32 = _mm_cvtps_epi32(gray0);
+            __m128i gray1_epi32 = _mm_cvtps_epi32(gray1);
+            __m128i gray2_epi32 = _mm_cvtps_epi32(gray2);
+            __m128i gray3_epi32 = _mm_cvtps_epi32(gray3);
+            
+            // Extract the grayscale values
+            dst[y * width + x + 0] = static_cast<uint8_t>(_mm_extract_epi32(gray0_epi32, 0));
+            dst[y * width + x + 1] = static_cast<uint8_t>(_mm_extract_epi32(gray1_epi32, 0));
+            dst[y * width + x + 2] = static_cast<uint8_t>(_mm_extract_epi32(gray2_epi32, 0));
+            dst[y * width + x + 3] = static_cast<uint8_t>(_mm_extract_epi32(gray3_epi32, 0));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ImageView overloads
+// ---------------------------------------------------------------------------
+
+inline void adjust_brightness_scalar(const ImageView& image, int brightness) {
+    for_each_span(image, [&](uint8_t* p, size_t pixels) {
+        adjust_brightness_scalar(p, static_cast<int>(pixels * image.channels), brightness);
+    });
+}
+
+inline void adjust_brightness_simd(const ImageView& image, int brightness) {
+    for_each_span(image, [&](uint8_t* p, size_t pixels) {
+        adjust_brightness_simd(p, static_cast<int>(pixels * image.channels), brightness);
+    });
+}
+
+inline void enhance_contrast_scalar(const ImageView& image, float contrast) {
+    for_each_span(image, [&](uint8_t* p, size_t pixels) {
+        enhance_contrast_scalar(p, static_cast<int>(pixels * image.channels), contrast);
+    });
+}
+
+inline void enhance_contrast_simd(const ImageView& image, float contrast) {
+    for_each_span(image, [&](uint8_t* p, size_t pixels) {
+        enhance_contrast_simd(p, static_cast<int>(pixels * image.channels), contrast);
+    });
+}
+
+// src: RGB, dst: one channel
+inline void convert_to_grayscale_scalar(const ConstImageView& src, const ImageView& dst) {
+    check_channels(src, RGB_CHANNELS);
+    check_channels(dst, 1);
+    for_each_span(src, dst, [](const uint8_t* s, uint8_t* d, size_t pixels) {
+        convert_to_grayscale_scalar(s, d, static_cast<int>(pixels), 1);
+    });
+}
+
+inline void convert_to_grayscale_simd(const ConstImageView& src, const ImageView& dst) {
+    check_channels(src, RGB_CHANNELS);
+    check_channels(dst, 1);
+    for_each_span(src, dst, [](const uint8_t* s, uint8_t* d, size_t pixels) {
+        convert_to_grayscale_simd(s, d, static_cast<int>(pixels), 1);
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Aligned kernels on ImageBuffer: every row is a whole number of 32-byte
+// vectors, so there are no tails; the padding is processed along with the pixels
+// ---------------------------------------------------------------------------
+
+// 1. Brightness adjustment - aligned implementation (any sign of brightness)
+inline void adjust_brightness_aligned(ImageBuffer& image, int brightness) {
+    const int amount = std::min(255, std::abs(brightness));
+    const __m256i delta = _mm256_set1_epi8(static_cast<char>(amount));
+    uint8_t* p = image.data();
+    const size_t size = image.size_bytes();
+    for (size_t i = 0; i < size; i += 64) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(p + i + 32));
+        a = brightness >= 0 ? _mm256_adds_epu8(a, delta) : _mm256_subs_epu8(a, delta);
+        b = brightness >= 0 ? _mm256_adds_epu8(b, delta) : _mm256_subs_epu8(b, delta);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + i), a);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + i + 32), b);
+    }
+}
+
+// 2. Contrast enhancement - aligned implementation, 32 bytes per iteration with
+// the same float math (and rounding) as enhance_contrast_simd
+inline void enhance_contrast_aligned(ImageBuffer& image, float contrast) {
+    const __m256 contrast_vec = _mm256_set1_ps(contrast);
+    uint8_t* p = image.data();
+    const size_t size = image.size_bytes();
+    for (size_t i = 0; i < size; i += 32) {
+        __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(p + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(p + i), enhance_contrast_x32(v, contrast_vec));
+    }
+}
+
+// 3. Grayscale conversion - aligned implementation: 32 pixels per iteration, the
+// same weights and rounding as convert_to_grayscale_simd, one aligned store.
+// The last load of a row may run 8 bytes past it, into the next row or the
+// buffer's spare block.
+inline void convert_to_grayscale_aligned(const ImageBuffer& src, ImageBuffer& dst) {
+    if (src.channels() != RGB_CHANNELS || dst.channels() != 1 || src.width() != dst.width() ||
+        src.height() != dst.height()) {
+        throw std::invalid_argument("grayscale needs an RGB source and a one-channel target of the same size");
+    }
+    // Pixels 0-3 (bytes 0-11) to the low lane, pixels 4-7 (bytes 12-23) to the high lane
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i pick_r = _mm256_setr_epi8(0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1,
+                                            0, -1, -1, -1, 3, -1, -1, -1, 6, -1, -1, -1, 9, -1, -1, -1);
+    const __m256i pick_g = _mm256_setr_epi8(1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1,
+                                            1, -1, -1, -1, 4, -1, -1, -1, 7, -1, -1, -1, 10, -1, -1, -1);
+    const __m256i pick_b = _mm256_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1,
+                                            2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+    const __m256 weight_r = _mm256_set1_ps(0.299f);
+    const __m256 weight_g = _mm256_set1_ps(0.587f);
+    const __m256 weight_b = _mm256_set1_ps(0.114f);
+    const int padded = src.padded_width();
+
+    for (int y = 0; y < src.height(); y++) {
+        const uint8_t* in = src.row(y);
+        uint8_t* out = dst.row(y);
+        for (int x = 0; x < padded; x += 32) {
+            __m256i q[4];
+            for (int k = 0; k < 4; k++) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + (x + 8 * k) * 3));
+                v = _mm256_permutevar8x32_epi32(v, spread);
+                __m256 r = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(v, pick_r));
+                __m256 g = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(v, pick_g));
+                __m256 b = _mm256_cvtepi32_ps(_mm256_shuffle_epi8(v, pick_b));
+                // (r * wr + g * wg) + b * wb: the summation order of _mm_dp_ps
+                __m256 gray = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r, weight_r), _mm256_mul_ps(g, weight_g)),
+                                            _mm256_mul_ps(b, weight_b));
+                q[k] = _mm256_cvtps_epi32(gray);
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out + x), pack_epi32_to_epu8(q[0], q[1], q[2], q[3]));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Out-of-place and in-place variants
+//
+// Aliasing rules: (image, ...) forms work in place. (src, dst, ...) forms take
+// __restrict pointers, so src and dst must not overlap at all, not even by one
+// byte; to process a buffer onto itself use the in-place form. In-place
+// grayscale is the exception that shrinks: the gray image is written over the
+// start of the RGB buffer.
+//
+// In place, every byte is read and written back (one read stream, one write
+// stream). Out of place, a normal store first reads the target line into the
+// cache (read for ownership), so dst costs a read and a write. The _stream forms
+// store with _mm256_stream_si256, which writes whole lines without reading them
+// and without evicting the working set; for frames larger than the last-level
+// cache that brings out of place close to in place, and well ahead of copy
+// followed by in place when the source must be kept. When dst is read again
+// right away (the next stage of a pipeline on a frame that fits in the cache),
+// normal stores leave it cached and are the better choice.
+// ---------------------------------------------------------------------------
+
+// 1. Brightness adjustment - Scalar implementation, out of place
+inline void adjust_brightness_scalar(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                     int brightness) {
+    for (int i = 0; i < size; i++) {
+        int value = static_cast<int>(src[i]) + brightness;
+        dst[i] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+    }
+}
+
+// 1. Brightness adjustment - SIMD implementation, out of place (brightness in
+// [0, 255], as in place)
+inline void adjust_brightness_simd(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                   int brightness) {
+    const __m256i brightness_vec = _mm256_set1_epi8(static_cast<char>(brightness));
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_adds_epu8(pixels, brightness_vec));
+    }
+    adjust_brightness_scalar(src + i, dst + i, size - i, brightness);
+}
+
+// Bytes until p is 32-byte aligned, at most size
+inline int bytes_to_alignment(const void* p, int size) {
+    int head = static_cast<int>((32 - reinterpret_cast<uintptr_t>(p) % 32) % 32);
+    return std::min(head, size);
+}
+
+// 1. Brightness adjustment - SIMD implementation, out of place with
+// non-temporal stores
+inline void adjust_brightness_stream(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                     int brightness) {
+    const __m256i brightness_vec = _mm256_set1_epi8(static_cast<char>(brightness));
+    // Streaming stores need an aligned target
+    int i = bytes_to_alignment(dst, size);
+    adjust_brightness_scalar(src, dst, i, brightness);
+    for (; i <= size - 32; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_adds_epu8(pixels, brightness_vec));
+    }
+    adjust_brightness_scalar(src + i, dst + i, size - i, brightness);
+    // Non-temporal stores are weakly ordered; fence before dst is handed on
+    _mm_sfence();
+}
+
+// 2. Contrast enhancement - Scalar implementation, out of place
+inline void enhance_contrast_scalar(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                    float contrast) {
+    for (int i = 0; i < size; i++) {
+        float value = (static_cast<float>(src[i]) - 128.0f) * contrast + 128.0f;
+        dst[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value)));
+    }
+}
+
+// 2. Contrast enhancement - SIMD implementation, out of place (same rounding as
+// in place)
+inline void enhance_contrast_simd(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                  float contrast) {
+    const __m256 contrast_vec = _mm256_set1_ps(contrast);
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), enhance_contrast_x32(pixels, contrast_vec));
+    }
+    for (; i < size; i++) {
+        float value = (static_cast<float>(src[i]) - 128.0f) * contrast + 128.0f;
+        dst[i] = static_cast<uint8_t>(std::nearbyint(std::min(255.0f, std::max(0.0f, value))));
+    }
+}
+
+// 2. Contrast enhancement - SIMD implementation, out of place with non-temporal
+// stores
+inline void enhance_contrast_stream(const uint8_t* __restrict src, uint8_t* __restrict dst, int size,
+                                    float contrast) {
+    const __m256 contrast_vec = _mm256_set1_ps(contrast);
+    int i = bytes_to_alignment(dst, size);
+    enhance_contrast_simd(src, dst, i, contrast);
+    for (; i <= size - 32; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), enhance_contrast_x32(pixels, contrast_vec));
+    }
+    enhance_contrast_simd(src + i, dst + i, size - i, contrast);
+    _mm_sfence();
+}
+
+// 3. Grayscale conversion - Scalar implementation, in place: pixel i is written
+// to byte i, at or below its RGB bytes 3i..3i+2, so a forward pass only
+// overwrites input it has already read. The gray image ends up in the first
+// width * height bytes.
+inline void convert_to_grayscale_scalar(uint8_t* image, int width, int height) {
+    const size_t pixels = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixels; i++) {
+        const uint8_t* rgb = image + i * RGB_CHANNELS;
+        image[i] = static_cast<uint8_t>(0.299f * rgb[0] + 0.587f * rgb[1] + 0.114f * rgb[2]);
+    }
+}
+
+// 3. Grayscale conversion - SIMD implementation, in place: each block of a row is
+// converted into scratch and copied down; the copy only lands on RGB bytes of
+// pixels already converted. Matches the out-of-place result row by row.
+inline void convert_to_grayscale_simd(uint8_t* image, int width, int height) {
+    const int block = 256;
+    uint8_t scratch[block];
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x += block) {
+            const int n = std::min(block, width - x);
+            const size_t pixel = static_cast<size_t>(y) * width + x;
+            convert_to_grayscale_simd(image + pixel * RGB_CHANNELS, scratch, n, 1);
+            std::memcpy(image + pixel, scratch, n);
+        }
+    }
+}
+
+// Out-of-place ImageView overloads for the SIMD forms; src and dst views must not
+// overlap. In-place grayscale is pointer-only, since it changes the row layout.
+inline void adjust_brightness_simd(const ConstImageView& src, const ImageView& dst, int brightness) {
+    check_channels(dst, src.channels);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        adjust_brightness_simd(s, d, static_cast<int>(pixels * src.channels), brightness);
+    });
+}
+
+inline void adjust_brightness_stream(const ConstImageView& src, const ImageView& dst, int brightness) {
+    check_channels(dst, src.channels);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        adjust_brightness_stream(s, d, static_cast<int>(pixels * src.channels), brightness);
+    });
+}
+
+inline void enhance_contrast_simd(const ConstImageView& src, const ImageView& dst, float contrast) {
+    check_channels(dst, src.channels);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        enhance_contrast_simd(s, d, static_cast<int>(pixels * src.channels), contrast);
+    });
+}
+
+inline void enhance_contrast_stream(const ConstImageView& src, const ImageView& dst, float contrast) {
+    check_channels(dst, src.channels);
+    for_each_span(src, dst, [&](const uint8_t* s, uint8_t* d, size_t pixels) {
+        enhance_contrast_stream(s, d, static_cast<int>(pixels * src.channels), contrast);
+    });
+}
+
+#endif // SIMD_IMAGE_H
@@ -0,0 +1,461 @@
+/**
+ * simd_io.h - Asynchronous file ingest for large kernel inputs
+ *
+ * AsyncFileReader streams a file into aligned buffers with several reads in
+ * flight and hands the blocks to a consumer in file order:
+ * - io_uring backend: raw io_uring_setup/io_uring_enter syscalls (no liburing)
+ * - Thread-pool backend: worker threads issuing pread(2), used when io_uring
+ *   is unavailable (old kernel, seccomp, io_uring_disabled)
+ *
+ * Files are opened with O_DIRECT when the filesystem allows it, bypassing the
+ * page cache. O_DIRECT needs buffers, offsets and sizes aligned to the device
+ * block size, so buffers are 4096-byte aligned (which also satisfies
+ * SIMD_ALIGN_64 for the kernels) and block_size must be a multiple of 4096.
+ *
+ * Linux only. Requires C++17 and -pthread.
+ */
+
+#ifndef SIMD_IO_H
+#define SIMD_IO_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+const size_t IO_BUFFER_ALIGNMENT = 4096;
+
+struct IngestStats {
+    uint64_t bytes = 0;
+    size_t blocks = 0;
+    double seconds = 0.0;
+
+    double gigabytes_per_second() const {
+        return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Minimal io_uring wrapper
+// ---------------------------------------------------------------------------
+
+class IoUring {
+public:
+    explicit IoUring(unsigned entries) : ring_fd(-1), sq_ptr(nullptr), cq_ptr(nullptr), sqes(nullptr) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0) {
+            throw std::runtime_error(std::string("io_uring_setup failed: ") + std::strerror(errno));
+        }
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+
+        sq_ptr = map(sq_size, IORING_OFF_SQ_RING);
+        cq_ptr = single_mmap ? sq_ptr : map(cq_size, IORING_OFF_CQ_RING);
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(map(sqes_size, IORING_OFF_SQES));
+
+        char* sq = static_cast<char*>(sq_ptr);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cq_ptr);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~IoUring() { release(); }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // Queues and submits one read; user_data comes back in the completion
+    void submit_read(int fd, void* buffer, unsigned size, uint64_t offset, uint64_t user_data) {
+        unsigned tail = *sq_tail;  // only this thread writes the tail
+        unsigned index = tail & sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = size;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        enter(1, 0, 0);
+    }
+
+    // Calls handler(user_data, result) for every available completion,
+    // blocking for at least one if `wait` is set
+    template<typename Handler>
+    void reap(bool wait, Handler handler) {
+        if (wait) {
+            enter(0, 1, IORING_ENTER_GETEVENTS);
+        }
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+            handler(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    void* map(size_t size, off_t offset) {
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+        if (ptr == MAP_FAILED) {
+            int err = errno;
+            release();
+            throw std::runtime_error(std::string("io_uring mmap failed: ") + std::strerror(err));
+        }
+        return ptr;
+    }
+
+    void enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        for (;;) {
+            long ret = syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0);
+            if (ret >= 0) return;
+            if (errno != EINTR && errno != EAGAIN) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+    }
+
+    void release() {
+        if (sqes) munmap(sqes, sqes_size);
+        if (cq_ptr && !single_mmap) munmap(cq_ptr, cq_size);
+        if (sq_ptr) munmap(sq_ptr, sq_size);
+        if (ring_fd >= 0) close(ring_fd);
+        sqes = nullptr;
+        sq_ptr = cq_ptr = nullptr;
+        ring_fd = -1;
+    }
+
+    int ring_fd;
+    void* sq_ptr;
+    void* cq_ptr;
+    io_uring_sqe* sqes;
+    size_t sq_size = 0, cq_size = 0, sqes_size = 0;
+    bool single_mmap = false;
+
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    io_uring_cqe* cqes;
+};
+
+// ---------------------------------------------------------------------------
+// Ordered asynchronous file reader
+// ---------------------------------------------------------------------------
+
+class AsyncFileReader {
+public:
+    enum Backend { AUTO, IO_URING, THREAD_POOL };
+
+    // Called for each block in file order; the buffer is reused afterwards
+    typedef std::function<void(uint8_t* data, size_t size, uint64_t offset)> Consumer;
+
+    AsyncFileReader(const std::string& path, size_t block_size = 1 << 20, unsigned queue_depth = 8,
+                    Backend backend = AUTO, bool direct = true)
+        : fd(-1), block_size(block_size), queue_depth(queue_depth), active(backend), direct(direct) {
+        if (block_size == 0 || block_size % IO_BUFFER_ALIGNMENT != 0 || queue_depth == 0) {
+            throw std::invalid_argument("block_size must be a multiple of 4096 and queue_depth > 0");
+        }
+
+        // Some filesystems (e.g. tmpfs) reject O_DIRECT; fall back to buffered reads
+        fd = direct ? open(path.c_str(), O_RDONLY | O_DIRECT) : -1;
+        if (fd < 0) {
+            this->direct = false;
+            fd = open(path.c_str(), O_RDONLY);
+        }
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            int err = errno;
+            release();
+            throw std::runtime_error("cannot stat " + path + ": " + std::strerror(err));
+        }
+        size = static_cast<uint64_t>(st.st_size);
+
+        for (unsigned i = 0; i < queue_depth; i++) {
+            void* ptr = nullptr;
+            if (posix_memalign(&ptr, IO_BUFFER_ALIGNMENT, block_size) != 0) {
+                release();
+                throw std::bad_alloc();
+            }
+            buffers.push_back(static_cast<uint8_t*>(ptr));
+        }
+
+        if (backend != THREAD_POOL) {
+            try {
+                ring.reset(new IoUring(queue_depth));
+                active = IO_URING;
+            } catch (const std::runtime_error&) {
+                if (backend == IO_URING) {
+                    release();
+                    throw;
+                }
+                active = THREAD_POOL;
+            }
+        }
+    }
+
+    ~AsyncFileReader() { release(); }
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    Backend backend() const { return active; }
+    const char* backend_name() const { return active == IO_URING ? "io_uring" : "pread pool"; }
+    bool direct_io() const { return direct; }
+    uint64_t file_size() const { return size; }
+
+    IngestStats read_all(const Consumer& consumer) {
+        auto start = std::chrono::steady_clock::now();
+        IngestStats stats;
+        if (active == IO_URING) {
+            try {
+                stats = read_all_uring(consumer);
+            } catch (const ReadOpUnsupported&) {
+                // The ring was set up but the kernel predates IORING_OP_READ (5.6):
+                // nothing reached the consumer yet, so rerun on the pool
+                ring.reset();
+                active = THREAD_POOL;
+            }
+        }
+        if (active == THREAD_POOL) stats = read_all_pool(consumer);
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+private:
+    // io_uring accepted the setup but rejected IORING_OP_READ with -EINVAL
+    struct ReadOpUnsupported : std::runtime_error {
+        ReadOpUnsupported() : std::runtime_error("io_uring does not support IORING_OP_READ") {}
+    };
+
+    struct Slot {
+        uint64_t offset = 0;
+        size_t length = 0;
+        long result = 0;
+        bool done = false;
+    };
+
+    size_t block_length(uint64_t offset) const {
+        return static_cast<size_t>(std::min<uint64_t>(block_size, size - offset));
+    }
+
+    // O_DIRECT reads must cover whole blocks, even past the end of the file
+    size_t request_length(size_t length) const {
+        return direct ? (length + IO_BUFFER_ALIGNMENT - 1) & ~(IO_BUFFER_ALIGNMENT - 1) : length;
+    }
+
+    // A read came back short before the end of the file: finish it synchronously.
+    // With O_DIRECT the retry restarts at the last aligned boundary; the buffer
+    // is aligned and holds whole blocks, so it stays a valid target.
+    void complete_short_read(uint8_t* buffer, Slot& slot) {
+        size_t got = static_cast<size_t>(slot.result);
+        const size_t end = request_length(slot.length);
+        while (got < slot.length) {
+            size_t from = direct ? got & ~(IO_BUFFER_ALIGNMENT - 1) : got;
+            ssize_t n = pread(fd, buffer + from, end - from, slot.offset + from);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                throw std::runtime_error("short read at offset " + std::to_string(slot.offset + got));
+            }
+            got = std::max(got, from + static_cast<size_t>(n));
+        }
+        slot.result = static_cast<long>(got);
+    }
+
+    // Slot i % queue_depth always holds block i, so blocks complete in any
+    // order but are consumed in file order.
+    template<typename SubmitFunc, typename WaitFunc>
+    IngestStats consume_in_order(const Consumer& consumer, SubmitFunc submit, WaitFunc wait_for) {
+        IngestStats stats;
+        uint64_t next_offset = 0;
+        for (unsigned s = 0; s < queue_depth && next_offset < size; s++) {
+            submit(s, next_offset);
+            next_offset += block_size;
+        }
+
+        for (uint64_t block = 0; stats.bytes < size; block++) {
+            unsigned s = static_cast<unsigned>(block % queue_depth);
+            wait_for(s);
+            Slot& slot = slots[s];
+            if (slot.result < 0) {
+                throw std::runtime_error(std::string("read failed: ") + std::strerror(static_cast<int>(-slot.result)));
+            }
+            if (static_cast<size_t>(slot.result) < slot.length) {
+                complete_short_read(buffers[s], slot);
+            }
+
+            consumer(buffers[s], slot.length, slot.offset);
+            stats.bytes += slot.length;
+            stats.blocks++;
+
+            if (next_offset < size) {
+                submit(s, next_offset);
+                next_offset += block_size;
+            }
+        }
+        return stats;
+    }
+
+    IngestStats read_all_uring(const Consumer& consumer) {
+        slots.assign(queue_depth, Slot());
+        unsigned in_flight = 0;
+        bool first = true;
+        auto complete = [&](uint64_t user_data, int result) {
+            slots[user_data].result = result;
+            slots[user_data].done = true;
+            in_flight--;
+        };
+        auto submit = [&](unsigned s, uint64_t offset) {
+            Slot& slot = slots[s];
+            slot.offset = offset;
+            slot.length = block_length(offset);
+            slot.done = false;
+            ring->submit_read(fd, buffers[s], static_cast<unsigned>(request_length(slot.length)), offset, s);
+            in_flight++;
+        };
+        auto wait_for = [&](unsigned s) {
+            while (!slots[s].done) ring->reap(true, complete);
+            if (first && slots[s].result == -EINVAL) throw ReadOpUnsupported();
+            first = false;
+        };
+        try {
+            return consume_in_order(consumer, submit, wait_for);
+        } catch (...) {
+            // Reads still in flight target the buffers: let the kernel finish with
+            // them before they are freed, reused by the pool or reaped into new slots
+            while (in_flight > 0) ring->reap(true, complete);
+            throw;
+        }
+    }
+
+    IngestStats read_all_pool(const Consumer& consumer) {
+        slots.assign(queue_depth, Slot());
+        std::mutex mutex;
+        std::condition_variable work_cv, done_cv;
+        std::deque<unsigned> pending;
+        bool stop = false;
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < queue_depth; t++) {
+            workers.emplace_back([&]() {
+                for (;;) {
+                    unsigned s;
+                    uint64_t offset;
+                    size_t length;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        work_cv.wait(lock, [&]() { return stop || !pending.empty(); });
+                        if (stop) return;
+                        s = pending.front();
+                        pending.pop_front();
+                        offset = slots[s].offset;
+                        length = request_length(slots[s].length);
+                    }
+
+                    ssize_t n;
+                    do {
+                        n = pread(fd, buffers[s], length, offset);
+                    } while (n < 0 && errno == EINTR);
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slots[s].result = n < 0 ? -errno : static_cast<long>(n);
+                    slots[s].done = true;
+                    done_cv.notify_all();
+                }
+            });
+        }
+
+        auto submit = [&](unsigned s, uint64_t offset) {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[s].offset = offset;
+            slots[s].length = block_length(offset);
+            slots[s].done = false;
+            pending.push_back(s);
+            work_cv.notify_one();
+        };
+        auto wait_for = [&](unsigned s) {
+            std::unique_lock<std::mutex> lock(mutex);
+            done_cv.wait(lock, [&]() { return slots[s].done; });
+        };
+
+        auto shutdown = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+                work_cv.notify_all();
+            }
+            for (std::thread& worker : workers) worker.join();
+        };
+
+        IngestStats stats;
+        try {
+            stats = consume_in_order(consumer, submit, wait_for);
+        } catch (...) {
+            shutdown();
+            throw;
+        }
+        shutdown();
+        return stats;
+    }
+
+    void release() {
+        ring.reset();
+        for (uint8_t* buffer : buffers) free(buffer);
+        buffers.clear();
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    int fd;
+    uint64_t size = 0;
+    size_t block_size;
+    unsigned queue_depth;
+    Backend active;
+    bool direct;
+    std::vector<uint8_t*> buffers;
+    std::vector<Slot> slots;
+    std::unique_ptr<IoUring> ring;
+};
+
+#endif // SIMD_IO_H
@@ -0,0 +1,271 @@
+/**
+ * simd_median.h - Median filters for grayscale and per-channel RGB
+ *
+ * The median of each (2r+1)^2 window removes salt-and-pepper noise (isolated
+ * 0/255 samples) that averaging filters only smear out. Every channel is
+ * filtered on its own; borders are replicated.
+ * - 3x3 and 5x5: branchless selection networks on 32 samples at a time with
+ *   _mm256_min_epu8 / _mm256_max_epu8. Interleaved RGB needs no deinterleaving:
+ *   the neighbours of a sample are `channels` bytes apart, so the same loads
+ *   work for any channel count. 3x3 uses the 19-exchange median-of-9 network;
+ *   5x5 uses forgetful selection (keep 14 samples, drop the smallest and the
+ *   largest, take in the next one, until 3 are left).
+ * - Any radius up to MEDIAN_MAX_RADIUS: a histogram median whose cost does not
+ *   grow with the radius. Every column keeps a 256-bin histogram of its 2r+1
+ *   samples (plus 16 coarse bins); the window histogram adds the column entering
+ *   on the right and subtracts the one leaving on the left, 16 bins per
+ *   instruction, and the median is found through the coarse bins first.
+ *
+ * median_filter_scalar is the reference for every radius (std::nth_element per
+ * window); median_filter_simd picks the network for radius 1 and 2 and the
+ * histogram beyond. All give identical results. src and dst must not overlap.
+ */
+
+#ifndef SIMD_MEDIAN_H
+#define SIMD_MEDIAN_H
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "simd_view.h"
+
+// Window counts must fit the 16-bit histogram bins: (2r+1)^2 <= 65535
+const int MEDIAN_MAX_RADIUS = 127;
+
+inline void check_median_views(const ConstImageView& src, const ImageView& dst, int radius) {
+    check_same_size(src, dst);
+    if (src.channels != dst.channels) {
+        throw std::invalid_argument("median source and target differ in channel count");
+    }
+    if (radius < 1 || radius > MEDIAN_MAX_RADIUS) {
+        throw std::invalid_argument("median radius out of range");
+    }
+}
+
+inline int median_clamp(int v, int hi) {
+    return v < 0 ? 0 : (v > hi ? hi : v);
+}
+
+// 1. Median filter - Scalar implementation: gather the window, nth_element
+inline void median_filter_scalar(const ConstImageView& src, const ImageView& dst, int radius) {
+    check_median_views(src, dst, radius);
+    const int ch = src.channels;
+    const int n = (2 * radius + 1) * (2 * radius + 1);
+    std::vector<uint8_t> window(n);
+    for (int y = 0; y < src.height; y++) {
+        for (int x = 0; x < src.width; x++) {
+            for (int c = 0; c < ch; c++) {
+                int k = 0;
+                for (int dy = -radius; dy <= radius; dy++) {
+                    const uint8_t* row = src.row(median_clamp(y + dy, src.height - 1));
+                    for (int dx = -radius; dx <= radius; dx++) {
+                        window[k++] = row[median_clamp(x + dx, src.width - 1) * ch + c];
+                    }
+                }
+                std::nth_element(window.begin(), window.begin() + n / 2, window.end());
+                dst.row(y)[x * ch + c] = window[n / 2];
+            }
+        }
+    }
+}
+
+inline void median_filter_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+                                 int radius) {
+    median_filter_scalar(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels),
+                         radius);
+}
+
+// Compare-exchange: a gets the smaller value, b the larger
+inline void median_sort2(uint8_t& a, uint8_t& b) {
+    uint8_t lo = std::min(a, b);
+    b = std::max(a, b);
+    a = lo;
+}
+
+inline void median_sort2(__m256i& a, __m256i& b) {
+    __m256i lo = _mm256_min_epu8(a, b);
+    b = _mm256_max_epu8(a, b);
+    a = lo;
+}
+
+// Median of 9 in 19 compare-exchanges (p is scrambled)
+template<typename V>
+inline V median9(V* p) {
+    median_sort2(p[1], p[2]); median_sort2(p[4], p[5]); median_sort2(p[7], p[8]);
+    median_sort2(p[0], p[1]); median_sort2(p[3], p[4]); median_sort2(p[6], p[7]);
+    median_sort2(p[1], p[2]); median_sort2(p[4], p[5]); median_sort2(p[7], p[8]);
+    median_sort2(p[0], p[3]); median_sort2(p[5], p[8]); median_sort2(p[4], p[7]);
+    median_sort2(p[3], p[6]); median_sort2(p[1], p[4]); median_sort2(p[2], p[5]);
+    median_sort2(p[4], p[7]); median_sort2(p[4], p[2]); median_sort2(p[6], p[4]);
+    median_sort2(p[4], p[2]);
+    return p[4];
+}
+
+// Moves the smallest of v[0, s) to v[0] and the largest to v[s-1]: pair the
+// front half with the back half, then run the minimum over the low side and
+// the maximum over the high side (the middle one of an odd set is on both)
+template<typename V>
+inline void median_extremes(V* v, int s) {
+    for (int i = 0; i < s / 2; i++) median_sort2(v[i], v[s - 1 - i]);
+    for (int i = 1; i < (s + 1) / 2; i++) median_sort2(v[0], v[i]);
+    for (int i = s / 2; i < s - 1; i++) median_sort2(v[i], v[s - 1]);
+}
+
+// Median of 25 by forgetful selection (p is scrambled). With 14 of the 25
+// held, the smallest held sample has 13 above it, so it ranks below the median,
+// and the largest above it. Dropping both keeps the median of what is left
+// (held and not yet seen) the same; take in the next sample and repeat.
+template<typename V>
+inline V median25(V* p) {
+    int lo = 0, hi = 14;  // held samples are p[lo, hi)
+    for (int next = 14; next < 25; next++) {
+        median_extremes(p + lo, hi - lo);
+        lo++;
+        p[hi - 1] = p[next];
+    }
+    median_extremes(p + lo, 3);
+    return p[lo + 1];
+}
+
+// Network for radius R
+template<typename V>
+inline V median_network(V* p, std::integral_constant<int, 1>) { return median9(p); }
+
+template<typename V>
+inline V median_network(V* p, std::integral_constant<int, 2>) { return median25(p); }
+
+// 3x3 or 5x5 over a replicated-border copy, 32 samples per iteration; the row
+// tail is done by one overlapping vector, or per sample for rows under 32 bytes
+template<int R>
+inline void median_network_simd(const ConstImageView& src, const ImageView& dst) {
+    const int ch = src.channels;
+    const int taps = (2 * R + 1) * (2 * R + 1);
+    const std::vector<uint8_t> padded = replicate_border(src, R);
+    const size_t pitch = static_cast<size_t>(src.width + 2 * R) * ch;
+    const int bytes = src.width * ch;
+    for (int y = 0; y < src.height; y++) {
+        const uint8_t* center = padded.data() + (y + R) * pitch + R * ch;
+        uint8_t* out = dst.row(y);
+        auto vector_at = [&](int i) {
+            __m256i v[taps];
+            int k = 0;
+            for (int dy = -R; dy <= R; dy++) {
+                for (int dx = -R; dx <= R; dx++) {
+                    v[k++] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(center + i + dy * static_cast<ptrdiff_t>(pitch) + dx * ch));
+                }
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), median_network(v, std::integral_constant<int, R>()));
+        };
+        int i = 0;
+        for (; i + 32 <= bytes; i += 32) vector_at(i);
+        if (i == bytes) continue;
+        if (bytes >= 32) {
+            vector_at(bytes - 32);
+            continue;
+        }
+        for (; i < bytes; i++) {
+            uint8_t v[taps];
+            int k = 0;
+            for (int dy = -R; dy <= R; dy++) {
+                for (int dx = -R; dx <= R; dx++) v[k++] = center[i + dy * static_cast<ptrdiff_t>(pitch) + dx * ch];
+            }
+            out[i] = median_network(v, std::integral_constant<int, R>());
+        }
+    }
+}
+
+// 2. Median filter - histogram implementation, any radius. Column histograms
+// slide down one row at a time; per channel the window histogram slides right
+// one column at a time.
+inline void median_filter_histogram(const ConstImageView& src, const ImageView& dst, int radius) {
+    check_median_views(src, dst, radius);
+    if (src.width == 0 || src.height == 0) return;
+    const int w = src.width, h = src.height, ch = src.channels;
+    const int columns = w * ch;
+    const int rank = (2 * radius + 1) * (2 * radius + 1) / 2;
+    // 256 fine and 16 coarse bins per column of samples
+    std::vector<uint16_t> fine(static_cast<size_t>(columns) * 256, 0), coarse(static_cast<size_t>(columns) * 16, 0);
+    auto update_row = [&](int y, int delta) {
+        const uint8_t* row = src.row(median_clamp(y, h - 1));
+        for (int i = 0; i < columns; i++) {
+            fine[static_cast<size_t>(i) * 256 + row[i]] += delta;
+            coarse[static_cast<size_t>(i) * 16 + (row[i] >> 4)] += delta;
+        }
+    };
+    for (int k = -radius; k <= radius; k++) update_row(k, 1);
+
+    alignas(32) uint16_t window[256];
+    alignas(32) uint16_t window_coarse[16];
+    // window += column a - column b (one channel's column indices)
+    auto slide = [&](int add, int sub) {
+        const uint16_t* fa = fine.data() + static_cast<size_t>(add) * 256;
+        const uint16_t* fs = fine.data() + static_cast<size_t>(sub) * 256;
+        for (int g = 0; g < 256; g += 16) {
+            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(window + g));
+            v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fa + g)));
+            v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fs + g)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(window + g), v);
+        }
+        __m256i c = _mm256_load_si256(reinterpret_cast<const __m256i*>(window_coarse));
+        c = _mm256_add_epi16(c, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(coarse.data() + static_cast<size_t>(add) * 16)));
+        c = _mm256_sub_epi16(c, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(coarse.data() + static_cast<size_t>(sub) * 16)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(window_coarse), c);
+    };
+
+    for (int y = 0; y < h; y++) {
+        if (y > 0) {
+            update_row(y + radius, 1);
+            update_row(y - radius - 1, -1);
+        }
+        uint8_t* out = dst.row(y);
+        for (int c = 0; c < ch; c++) {
+            std::fill(window, window + 256, 0);
+            std::fill(window_coarse, window_coarse + 16, 0);
+            // First window: the replicated border counts column 0 r+1 times
+            for (int dx = -radius; dx <= radius; dx++) {
+                const int col = median_clamp(dx, w - 1) * ch + c;
+                for (int b = 0; b < 256; b++) window[b] += fine[static_cast<size_t>(col) * 256 + b];
+                for (int b = 0; b < 16; b++) window_coarse[b] += coarse[static_cast<size_t>(col) * 16 + b];
+            }
+            for (int x = 0; x < w; x++) {
+                if (x > 0) slide(median_clamp(x + radius, w - 1) * ch + c, median_clamp(x - radius - 1, w - 1) * ch + c);
+                // The median is the sample with rank `rank`: find its coarse
+                // bin, then the fine bin inside it
+                int count = 0, g = 0;
+                while (count + window_coarse[g] <= rank) count += window_coarse[g++];
+                int b = g * 16;
+                while (count + window[b] <= rank) count += window[b++];
+                out[x * ch + c] = static_cast<uint8_t>(b);
+            }
+        }
+    }
+}
+
+inline void median_filter_histogram(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+                                    int radius) {
+    median_filter_histogram(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels),
+                            radius);
+}
+
+// 1. Median filter - SIMD implementation: networks for 3x3 and 5x5, the
+// histogram median for larger windows
+inline void median_filter_simd(const ConstImageView& src, const ImageView& dst, int radius) {
+    check_median_views(src, dst, radius);
+    if (src.width == 0 || src.height == 0) return;
+    if (radius == 1) {
+        median_network_simd<1>(src, dst);
+    } else if (radius == 2) {
+        median_network_simd<2>(src, dst);
+    } else {
+        median_filter_histogram(src, dst, radius);
+    }
+}
+
+inline void median_filter_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels, int radius) {
+    median_filter_simd(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels), radius);
+}
+
+#endif // SIMD_MEDIAN_H
@@ -0,0 +1,386 @@
+/**
+ * simd_motion.h - Frame differencing kernels for motion detection
+ *
+ * Operate on consecutive grayscale frames (one byte per pixel, rows stored back
+ * to back, as produced by convert_to_grayscale_simd):
+ * - Absolute difference image |a - b| (subs_epu8 in both directions)
+ * - Thresholded motion mask (255 where |a - b| > threshold, else 0)
+ * - Whole-frame SAD (_mm256_sad_epu8)
+ * - Per-tile SAD summaries over MOTION_TILE_W-wide tiles
+ * - Block SAD / SSD between two strided blocks (template and block matching)
+ * - SAD of an 8x8 or 16x16 block at eight consecutive horizontal offsets with
+ *   _mm256_mpsadbw_epu8, the inner step of exhaustive motion search
+ *
+ * Each kernel has a scalar reference and an AVX2 version. The frame kernels also
+ * take grayscale image views (simd_view.h) with any row stride.
+ */
+
+#ifndef SIMD_MOTION_H
+#define SIMD_MOTION_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cstdlib>
+#include "simd_view.h"
+
+// Tiles are one AVX2 vector wide; the height is chosen by the caller
+const int MOTION_TILE_W = 32;
+
+inline int motion_tiles_x(int width) {
+    return (width + MOTION_TILE_W - 1) / MOTION_TILE_W;
+}
+
+inline int motion_tiles_y(int height, int tile_height) {
+    return (height + tile_height - 1) / tile_height;
+}
+
+// 1. Absolute difference - Scalar implementation
+inline void absolute_difference_scalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, int size) {
+    for (int i = 0; i < size; i++) {
+        dst[i] = static_cast<uint8_t>(std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+}
+
+// 1. Absolute difference - SIMD implementation
+inline void absolute_difference_simd(const uint8_t* a, const uint8_t* b, uint8_t* dst, int size) {
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        // Saturating subtraction clamps the negative direction to 0,
+        // so one of the two is |a - b| and the other is 0
+        __m256i diff = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), diff);
+    }
+    for (; i < size; i++) {
+        dst[i] = static_cast<uint8_t>(std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+}
+
+// 2. Motion mask - Scalar implementation
+inline void motion_mask_scalar(const uint8_t* a, const uint8_t* b, uint8_t* mask, int size, uint8_t threshold) {
+    for (int i = 0; i < size; i++) {
+        int diff = std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+        mask[i] = diff > threshold ? 255 : 0;
+    }
+}
+
+// 2. Motion mask - SIMD implementation
+inline void motion_mask_simd(const uint8_t* a, const uint8_t* b, uint8_t* mask, int size, uint8_t threshold) {
+    const __m256i threshold_vec = _mm256_set1_epi8(static_cast<char>(threshold));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(-1);
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i diff = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+        // diff > threshold  <=>  subs(diff, threshold) != 0
+        __m256i below = _mm256_cmpeq_epi8(_mm256_subs_epu8(diff, threshold_vec), zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), _mm256_xor_si256(below, ones));
+    }
+    for (; i < size; i++) {
+        int diff = std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+        mask[i] = diff > threshold ? 255 : 0;
+    }
+}
+
+// 3. Frame SAD - Scalar implementation
+inline uint64_t frame_sad_scalar(const uint8_t* a, const uint8_t* b, int size) {
+    uint64_t sum = 0;
+    for (int i = 0; i < size; i++) {
+        sum += static_cast<uint64_t>(std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+    return sum;
+}
+
+// 3. Frame SAD - SIMD implementation
+inline uint64_t frame_sad_simd(const uint8_t* a, const uint8_t* b, int size) {
+    // _mm256_sad_epu8 sums |a - b| over each group of 8 bytes into a 64-bit lane
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i <= size - 32; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < size; i++) {
+        sum += static_cast<uint64_t>(std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+    }
+    return sum;
+}
+
+// Image view overloads of kernels 1-3; all views one channel, same size
+inline void check_motion_views(const ConstImageView& a, const ConstImageView& b) {
+    check_channels(a, 1);
+    check_channels(b, 1);
+    check_same_size(a, b);
+}
+
+inline void absolute_difference_scalar(const ConstImageView& a, const ConstImageView& b, const ImageView& dst) {
+    check_motion_views(a, b);
+    check_channels(dst, 1);
+    for_each_span(a, b, dst, [](const uint8_t* pa, const uint8_t* pb, uint8_t* pd, size_t n) {
+        absolute_difference_scalar(pa, pb, pd, static_cast<int>(n));
+    });
+}
+
+inline void absolute_difference_simd(const ConstImageView& a, const ConstImageView& b, const ImageView& dst) {
+    check_motion_views(a, b);
+    check_channels(dst, 1);
+    for_each_span(a, b, dst, [](const uint8_t* pa, const uint8_t* pb, uint8_t* pd, size_t n) {
+        absolute_difference_simd(pa, pb, pd, static_cast<int>(n));
+    });
+}
+
+inline void motion_mask_scalar(const ConstImageView& a, const ConstImageView& b, const ImageView& mask, uint8_t threshold) {
+    check_motion_views(a, b);
+    check_channels(mask, 1);
+    for_each_span(a, b, mask, [&](const uint8_t* pa, const uint8_t* pb, uint8_t* pm, size_t n) {
+        motion_mask_scalar(pa, pb, pm, static_cast<int>(n), threshold);
+    });
+}
+
+inline void motion_mask_simd(const ConstImageView& a, const ConstImageView& b, const ImageView& mask, uint8_t threshold) {
+    check_motion_views(a, b);
+    check_channels(mask, 1);
+    for_each_span(a, b, mask, [&](const uint8_t* pa, const uint8_t* pb, uint8_t* pm, size_t n) {
+        motion_mask_simd(pa, pb, pm, static_cast<int>(n), threshold);
+    });
+}
+
+inline uint64_t frame_sad_scalar(const ConstImageView& a, const ConstImageView& b) {
+    check_motion_views(a, b);
+    uint64_t sum = 0;
+    for_each_span(a, b, [&](const uint8_t* pa, const uint8_t* pb, size_t n) {
+        sum += frame_sad_scalar(pa, pb, static_cast<int>(n));
+    });
+    return sum;
+}
+
+inline uint64_t frame_sad_simd(const ConstImageView& a, const ConstImageView& b) {
+    check_motion_views(a, b);
+    uint64_t sum = 0;
+    for_each_span(a, b, [&](const uint8_t* pa, const uint8_t* pb, size_t n) {
+        sum += frame_sad_simd(pa, pb, static_cast<int>(n));
+    });
+    return sum;
+}
+
+// 4. Per-tile SAD - Scalar implementation
+// tile_sads has motion_tiles_x(width) * motion_tiles_y(height, tile_height)
+// entries, row-major; edge tiles cover whatever pixels remain
+inline void tile_sad_scalar(const ConstImageView& a, const ConstImageView& b, int tile_height, uint32_t* tile_sads) {
+    check_motion_views(a, b);
+    const int width = a.width, height = a.height;
+    int tiles_x = motion_tiles_x(width);
+    int tiles_y = motion_tiles_y(height, tile_height);
+    for (int t = 0; t < tiles_x * tiles_y; t++) tile_sads[t] = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* ra = a.row(y);
+        const uint8_t* rb = b.row(y);
+        uint32_t* row_tiles = tile_sads + (y / tile_height) * tiles_x;
+        for (int x = 0; x < width; x++) {
+            row_tiles[x / MOTION_TILE_W] += static_cast<uint32_t>(std::abs(static_cast<int>(ra[x]) - static_cast<int>(rb[x])));
+        }
+    }
+}
+
+inline void tile_sad_scalar(const uint8_t* a, const uint8_t* b, int width, int height,
+                            int tile_height, uint32_t* tile_sads) {
+    tile_sad_scalar(ConstImageView(a, width, height), ConstImageView(b, width, height), tile_height, tile_sads);
+}
+
+// 4. Per-tile SAD - SIMD implementation
+inline void tile_sad_simd(const ConstImageView& a, const ConstImageView& b, int tile_height, uint32_t* tile_sads) {
+    check_motion_views(a, b);
+    const int width = a.width, height = a.height;
+    int tiles_x = motion_tiles_x(width);
+    int tiles_y = motion_tiles_y(height, tile_height);
+    int full_tiles_x = width / MOTION_TILE_W;
+
+    for (int ty = 0; ty < tiles_y; ty++) {
+        int y0 = ty * tile_height;
+        int y1 = y0 + tile_height < height ? y0 + tile_height : height;
+
+        // One 32-byte row segment per tile row: a single sad_epu8 each
+        for (int tx = 0; tx < full_tiles_x; tx++) {
+            __m256i acc = _mm256_setzero_si256();
+            for (int y = y0; y < y1; y++) {
+                const uint8_t* pa = a.row(y) + tx * MOTION_TILE_W;
+                const uint8_t* pb = b.row(y) + tx * MOTION_TILE_W;
+                __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa));
+                __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb));
+                acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+            }
+            // Fold the four 64-bit partial sums (each fits in 32 bits)
+            __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+            tile_sads[ty * tiles_x + tx] = static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+        }
+
+        // Partial tile at the right edge
+        if (full_tiles_x < tiles_x) {
+            uint32_t sum = 0;
+            for (int y = y0; y < y1; y++) {
+                const uint8_t* ra = a.row(y);
+                const uint8_t* rb = b.row(y);
+                for (int x = full_tiles_x * MOTION_TILE_W; x < width; x++) {
+                    sum += static_cast<uint32_t>(std::abs(static_cast<int>(ra[x]) - static_cast<int>(rb[x])));
+                }
+            }
+            tile_sads[ty * tiles_x + full_tiles_x] = sum;
+        }
+    }
+}
+
+inline void tile_sad_simd(const uint8_t* a, const uint8_t* b, int width, int height,
+                          int tile_height, uint32_t* tile_sads) {
+    tile_sad_simd(ConstImageView(a, width, height), ConstImageView(b, width, height), tile_height, tile_sads);
+}
+
+// 5. Block SAD - Scalar implementation
+inline uint32_t block_sad_scalar(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                                 int width, int height) {
+    uint32_t sum = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            sum += static_cast<uint32_t>(std::abs(static_cast<int>(a[y * a_stride + x]) - static_cast<int>(b[y * b_stride + x])));
+        }
+    }
+    return sum;
+}
+
+// 5. Block SAD - SIMD implementation
+inline uint32_t block_sad_simd(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                               int width, int height) {
+    __m256i acc = _mm256_setzero_si256();
+    __m128i acc128 = _mm_setzero_si128();
+    uint32_t tail = 0;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pa = a + y * a_stride;
+        const uint8_t* pb = b + y * b_stride;
+        int x = 0;
+        for (; x <= width - 32; x += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa + x));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb + x));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+        }
+        if (x <= width - 16) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + x));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + x));
+            acc128 = _mm_add_epi64(acc128, _mm_sad_epu8(va, vb));
+            x += 16;
+        }
+        if (x <= width - 8) {
+            __m128i va = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pa + x));
+            __m128i vb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pb + x));
+            acc128 = _mm_add_epi64(acc128, _mm_sad_epu8(va, vb));
+            x += 8;
+        }
+        for (; x < width; x++) {
+            tail += static_cast<uint32_t>(std::abs(static_cast<int>(pa[x]) - static_cast<int>(pb[x])));
+        }
+    }
+    __m128i sum = _mm_add_epi64(acc128, _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+    return static_cast<uint32_t>(_mm_cvtsi128_si64(sum)) + tail;
+}
+
+// 6. Block SSD - Scalar implementation
+inline uint64_t block_ssd_scalar(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                                 int width, int height) {
+    uint64_t sum = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int d = static_cast<int>(a[y * a_stride + x]) - static_cast<int>(b[y * b_stride + x]);
+            sum += static_cast<uint64_t>(d * d);
+        }
+    }
+    return sum;
+}
+
+// 6. Block SSD - SIMD implementation
+inline uint64_t block_ssd_simd(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                               int width, int height) {
+    uint64_t sum = 0;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* pa = a + y * a_stride;
+        const uint8_t* pb = b + y * b_stride;
+        // 16 pixels at a time: widen to 16 bits, then madd squares pairs into 32 bits
+        // (one row of up to 4096 pixels cannot overflow a 32-bit lane)
+        __m256i acc = _mm256_setzero_si256();
+        int x = 0;
+        for (; x <= width - 16; x += 16) {
+            __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + x)));
+            __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + x)));
+            __m256i d = _mm256_sub_epi16(va, vb);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(d, d));
+        }
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        sum += static_cast<uint32_t>(_mm_cvtsi128_si32(s));
+        for (; x < width; x++) {
+            int d = static_cast<int>(pa[x]) - static_cast<int>(pb[x]);
+            sum += static_cast<uint64_t>(d * d);
+        }
+    }
+    return sum;
+}
+
+// 7. SAD at eight horizontal offsets - Scalar implementation
+inline void block_sad_x8_scalar(const uint8_t* block, int block_stride, const uint8_t* ref, int ref_stride,
+                                int size, uint16_t sads[8]) {
+    for (int dx = 0; dx < 8; dx++) {
+        sads[dx] = static_cast<uint16_t>(block_sad_scalar(block, block_stride, ref + dx, ref_stride, size, size));
+    }
+}
+
+// 7. SAD at eight horizontal offsets - SIMD implementation
+// Returns SAD(block, ref + dx) for dx = 0..7 as eight 16-bit lanes, for square
+// blocks of size 8 or 16. _mm256_mpsadbw_epu8 compares one 4-byte group of the
+// block against 8 consecutive positions per 128-bit lane, so each lane handles
+// one row and the groups are summed. Reads up to 24 bytes of each ref row.
+inline __m128i block_sad_x8_simd(const uint8_t* block, int block_stride, const uint8_t* ref, int ref_stride,
+                                 int size) {
+    __m256i acc = _mm256_setzero_si256();
+    for (int y = 0; y < size; y += 2) {
+        const uint8_t* r0 = ref + y * ref_stride;
+        const uint8_t* r1 = r0 + ref_stride;
+        const uint8_t* b0 = block + y * block_stride;
+        const uint8_t* b1 = b0 + block_stride;
+
+        // Low lane: row y, high lane: row y + 1
+        __m256i ref_lo = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1)), 1);
+        if (size == 8) {
+            __m256i blk = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b0))),
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b1)), 1);
+            // imm per lane: bit 2 = ref offset 4, bits 1:0 = block group
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_lo, blk, 0x00));  // bytes 0-3
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_lo, blk, 0x2D));  // bytes 4-7
+        } else {
+            __m256i ref_hi = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + 8))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + 8)), 1);
+            __m256i blk = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b0))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(b1)), 1);
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_lo, blk, 0x00));  // bytes 0-3
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_lo, blk, 0x2D));  // bytes 4-7
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_hi, blk, 0x12));  // bytes 8-11
+            acc = _mm256_add_epi16(acc, _mm256_mpsadbw_epu8(ref_hi, blk, 0x3F));  // bytes 12-15
+        }
+    }
+    // 16x16 sums reach at most 65280, so 16-bit lanes do not overflow
+    return _mm_add_epi16(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+}
+
+#endif // SIMD_MOTION_H
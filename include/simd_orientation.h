@@ -0,0 +1,314 @@
+/**
+ * simd_orientation.h - Flips and 90/180/270-degree rotations
+ *
+ * Camera feeds arrive in mixed orientations, and every reorientation is a full
+ * frame pass, so these are worth doing at memory speed. Gray (1), RGB (3) and
+ * RGBA (4) channel images have SIMD paths; other channel counts use the scalar code.
+ * - flip_horizontal: rows reversed with byte/dword shuffles (RGB: 5 pixels per
+ *   16-byte shuffle)
+ * - flip_vertical: row copies, or row swaps when src == dst
+ * - rotate: 180 is a horizontal flip into reversed rows; 90 and 270 transpose 8x8
+ *   pixel blocks in registers (rows read bottom-up for 90, written bottom-up for
+ *   270), with scalar code for the edge strips
+ *
+ * Except for flip_vertical, src and dst must not overlap. Rotating by 90 or 270
+ * swaps the dimensions: dst is height x width. The ImageView overloads take any
+ * row stride, so a region can be flipped or rotated into a window of a larger image.
+ */
+
+#ifndef SIMD_ORIENTATION_H
+#define SIMD_ORIENTATION_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "simd_view.h"
+
+enum class Rotation { CW90, R180, CCW270 };
+
+// ---------------------------------------------------------------------------
+// Flips
+// ---------------------------------------------------------------------------
+
+inline void flip_row_scalar(const uint8_t* src, uint8_t* dst, int width, int channels) {
+    for (int x = 0; x < width; x++) {
+        std::memcpy(dst + static_cast<size_t>(width - 1 - x) * channels, src + static_cast<size_t>(x) * channels, channels);
+    }
+}
+
+inline void flip_row_simd(const uint8_t* src, uint8_t* dst, int width, int channels) {
+    int d = 0;  // destination pixel
+    if (channels == 1) {
+        const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                                 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        for (; d + 32 <= width; d += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + width - d - 32));
+            v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), _MM_SHUFFLE(1, 0, 3, 2));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + d), v);
+        }
+    } else if (channels == 4) {
+        const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+        for (; d + 8 <= width; d += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + (width - d - 8) * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + d * 4), _mm256_permutevar8x32_epi32(v, reverse));
+        }
+    } else if (channels == 3) {
+        // 5 pixels = 15 bytes per shuffle. The load starts one byte early and the
+        // store writes one byte too many; d + 5 < width keeps both inside the row,
+        // and the extra byte is overwritten by the next store.
+        const __m128i reverse = _mm_setr_epi8(13, 14, 15, 10, 11, 12, 7, 8, 9, 4, 5, 6, 1, 2, 3, -1);
+        for (; d + 5 < width; d += 5) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (width - d - 5) * 3 - 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + d * 3), _mm_shuffle_epi8(v, reverse));
+        }
+    }
+    // Remaining destination pixels d..width-1 come from source pixels width-1-d..0
+    flip_row_scalar(src, dst + static_cast<size_t>(d) * channels, width - d, channels);
+}
+
+// Same size and channel count
+inline void check_flip_views(const ConstImageView& src, const ImageView& dst) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+}
+
+// 1. Horizontal flip - Scalar implementation
+inline void flip_horizontal_scalar(const ConstImageView& src, const ImageView& dst) {
+    check_flip_views(src, dst);
+    for (int y = 0; y < src.height; y++) flip_row_scalar(src.row(y), dst.row(y), src.width, src.channels);
+}
+
+inline void flip_horizontal_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels) {
+    flip_horizontal_scalar(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels));
+}
+
+// 1. Horizontal flip - SIMD implementation
+inline void flip_horizontal_simd(const ConstImageView& src, const ImageView& dst) {
+    check_flip_views(src, dst);
+    for (int y = 0; y < src.height; y++) flip_row_simd(src.row(y), dst.row(y), src.width, src.channels);
+}
+
+inline void flip_horizontal_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels) {
+    flip_horizontal_simd(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels));
+}
+
+// 2. Vertical flip - Scalar implementation (src == dst allowed)
+inline void flip_vertical_scalar(const ConstImageView& src, const ImageView& dst) {
+    check_flip_views(src, dst);
+    const int height = src.height;
+    const size_t row = src.row_bytes();
+    for (int y = 0; y < (height + 1) / 2; y++) {
+        const uint8_t* a = src.row(y);
+        const uint8_t* b = src.row(height - 1 - y);
+        uint8_t* da = dst.row(y);
+        uint8_t* db = dst.row(height - 1 - y);
+        for (size_t i = 0; i < row; i++) {
+            uint8_t t = a[i];
+            da[i] = b[i];
+            db[i] = t;
+        }
+    }
+}
+
+inline void flip_vertical_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels) {
+    flip_vertical_scalar(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels));
+}
+
+// 2. Vertical flip - SIMD implementation: swaps row pairs 32 bytes at a time
+inline void flip_vertical_simd(const ConstImageView& src, const ImageView& dst) {
+    check_flip_views(src, dst);
+    const int height = src.height;
+    const size_t row = src.row_bytes();
+    for (int y = 0; y < (height + 1) / 2; y++) {
+        const uint8_t* a = src.row(y);
+        const uint8_t* b = src.row(height - 1 - y);
+        uint8_t* da = dst.row(y);
+        uint8_t* db = dst.row(height - 1 - y);
+        size_t i = 0;
+        for (; i + 32 <= row; i += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(da + i), vb);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(db + i), va);
+        }
+        for (; i < row; i++) {
+            uint8_t t = a[i];
+            da[i] = b[i];
+            db[i] = t;
+        }
+    }
+}
+
+inline void flip_vertical_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels) {
+    flip_vertical_simd(ConstImageView(src, width, height, channels), ImageView(dst, width, height, channels));
+}
+
+// ---------------------------------------------------------------------------
+// Rotations
+// ---------------------------------------------------------------------------
+
+// dst is height x width for 90 and 270 degrees, width x height for 180
+inline void check_rotation_views(const ConstImageView& src, const ImageView& dst, Rotation rotation) {
+    bool swapped = rotation != Rotation::R180;
+    if (dst.width != (swapped ? src.height : src.width) || dst.height != (swapped ? src.width : src.height)) {
+        throw std::invalid_argument("rotation target has the wrong size");
+    }
+    check_channels(dst, src.channels);
+}
+
+// Rotates the source pixels in [x0, x1) x [y0, y1); dst is laid out for `rotation`
+inline void rotate_region_scalar(const ConstImageView& src, const ImageView& dst, Rotation rotation,
+                                 int x0, int x1, int y0, int y1) {
+    const int width = src.width, height = src.height, channels = src.channels;
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++) {
+            uint8_t* to;
+            if (rotation == Rotation::CW90) {
+                to = dst.at(height - 1 - y, x);
+            } else if (rotation == Rotation::CCW270) {
+                to = dst.at(y, width - 1 - x);
+            } else {
+                to = dst.at(width - 1 - x, height - 1 - y);
+            }
+            std::memcpy(to, src.at(x, y), channels);
+        }
+    }
+}
+
+// 8x8 block transposes: in[j] points at 8 pixels of source row j, out[i] receives
+// the 8 pixels in[0..7][i]
+
+inline void transpose8x8_gray(const uint8_t* const in[8], uint8_t* const out[8]) {
+    __m128i a[8];
+    for (int j = 0; j < 8; j++) a[j] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in[j]));
+    __m128i b0 = _mm_unpacklo_epi8(a[0], a[1]), b1 = _mm_unpacklo_epi8(a[2], a[3]);
+    __m128i b2 = _mm_unpacklo_epi8(a[4], a[5]), b3 = _mm_unpacklo_epi8(a[6], a[7]);
+    // Columns 0-3 / 4-7 of rows 0-3 and of rows 4-7
+    __m128i c0 = _mm_unpacklo_epi16(b0, b1), c1 = _mm_unpackhi_epi16(b0, b1);
+    __m128i c2 = _mm_unpacklo_epi16(b2, b3), c3 = _mm_unpackhi_epi16(b2, b3);
+    // Two complete columns each
+    __m128i d[4] = {_mm_unpacklo_epi32(c0, c2), _mm_unpackhi_epi32(c0, c2),
+                    _mm_unpacklo_epi32(c1, c3), _mm_unpackhi_epi32(c1, c3)};
+    for (int k = 0; k < 4; k++) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out[2 * k]), d[k]);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out[2 * k + 1]), _mm_srli_si128(d[k], 8));
+    }
+}
+
+inline void transpose8x8_epi32(__m256i r[8]) {
+    __m256i t[8], u[8];
+    for (int k = 0; k < 4; k++) {
+        t[2 * k] = _mm256_unpacklo_epi32(r[2 * k], r[2 * k + 1]);
+        t[2 * k + 1] = _mm256_unpackhi_epi32(r[2 * k], r[2 * k + 1]);
+    }
+    for (int k = 0; k < 2; k++) {
+        u[4 * k + 0] = _mm256_unpacklo_epi64(t[4 * k + 0], t[4 * k + 2]);
+        u[4 * k + 1] = _mm256_unpackhi_epi64(t[4 * k + 0], t[4 * k + 2]);
+        u[4 * k + 2] = _mm256_unpacklo_epi64(t[4 * k + 1], t[4 * k + 3]);
+        u[4 * k + 3] = _mm256_unpackhi_epi64(t[4 * k + 1], t[4 * k + 3]);
+    }
+    // u[k] holds columns k and k + 4 of rows 0-3, u[k + 4] the same of rows 4-7
+    for (int k = 0; k < 4; k++) {
+        r[k] = _mm256_permute2x128_si256(u[k], u[k + 4], 0x20);
+        r[k + 4] = _mm256_permute2x128_si256(u[k], u[k + 4], 0x31);
+    }
+}
+
+inline void transpose8x8_rgba(const uint8_t* const in[8], uint8_t* const out[8]) {
+    __m256i r[8];
+    for (int j = 0; j < 8; j++) r[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in[j]));
+    transpose8x8_epi32(r);
+    for (int i = 0; i < 8; i++) _mm256_storeu_si256(reinterpret_cast<__m256i*>(out[i]), r[i]);
+}
+
+// RGB pixels are widened to dwords, transposed, and packed back; loads and stores
+// touch exactly 24 bytes so blocks at the end of a row stay in bounds
+inline void transpose8x8_rgb(const uint8_t* const in[8], uint8_t* const out[8]) {
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i widen = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                           0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i narrow = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                            0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    __m256i r[8];
+    for (int j = 0; j < 8; j++) {
+        __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in[j]))),
+            _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in[j] + 16)), 1);
+        r[j] = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, spread), widen);
+    }
+    transpose8x8_epi32(r);
+    for (int i = 0; i < 8; i++) {
+        __m256i v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(r[i], narrow), gather);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[i]), _mm256_castsi256_si128(v));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out[i] + 16), _mm256_extracti128_si256(v, 1));
+    }
+}
+
+// dst views for the given rotation of a width x height image
+inline ImageView rotation_target(uint8_t* dst, int width, int height, int channels, Rotation rotation) {
+    return rotation == Rotation::R180 ? ImageView(dst, width, height, channels) : ImageView(dst, height, width, channels);
+}
+
+// 3. Rotation - Scalar implementation
+inline void rotate_scalar(const ConstImageView& src, const ImageView& dst, Rotation rotation) {
+    check_rotation_views(src, dst, rotation);
+    rotate_region_scalar(src, dst, rotation, 0, src.width, 0, src.height);
+}
+
+inline void rotate_scalar(const uint8_t* src, uint8_t* dst, int width, int height, int channels, Rotation rotation) {
+    rotate_scalar(ConstImageView(src, width, height, channels), rotation_target(dst, width, height, channels, rotation),
+                  rotation);
+}
+
+// 3. Rotation - SIMD implementation
+inline void rotate_simd(const ConstImageView& src, const ImageView& dst, Rotation rotation) {
+    check_rotation_views(src, dst, rotation);
+    const int width = src.width, height = src.height, channels = src.channels;
+    if (rotation == Rotation::R180) {
+        for (int y = 0; y < height; y++) flip_row_simd(src.row(y), dst.row(height - 1 - y), width, channels);
+        return;
+    }
+    if (channels != 1 && channels != 3 && channels != 4) {
+        rotate_region_scalar(src, dst, rotation, 0, width, 0, height);
+        return;
+    }
+
+    const int w8 = width - width % 8, h8 = height - height % 8;
+    const uint8_t* in[8];
+    uint8_t* out[8];
+    for (int by = 0; by < h8; by += 8) {
+        for (int bx = 0; bx < w8; bx += 8) {
+            for (int k = 0; k < 8; k++) {
+                if (rotation == Rotation::CW90) {
+                    // Source rows bottom-up; output row x, columns height-8-by ..
+                    in[k] = src.at(bx, by + 7 - k);
+                    out[k] = dst.at(height - 8 - by, bx + k);
+                } else {
+                    // Output rows bottom-up, columns by ..
+                    in[k] = src.at(bx, by + k);
+                    out[k] = dst.at(by, width - 1 - bx - k);
+                }
+            }
+            if (channels == 1) {
+                transpose8x8_gray(in, out);
+            } else if (channels == 3) {
+                transpose8x8_rgb(in, out);
+            } else {
+                transpose8x8_rgba(in, out);
+            }
+        }
+    }
+    // Right strip (all rows) and bottom strip (block columns only)
+    rotate_region_scalar(src, dst, rotation, w8, width, 0, height);
+    rotate_region_scalar(src, dst, rotation, 0, w8, h8, height);
+}
+
+inline void rotate_simd(const uint8_t* src, uint8_t* dst, int width, int height, int channels, Rotation rotation) {
+    rotate_simd(ConstImageView(src, width, height, channels), rotation_target(dst, width, height, channels, rotation),
+                rotation);
+}
+
+#endif // SIMD_ORIENTATION_H
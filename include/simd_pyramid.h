@@ -0,0 +1,387 @@
+/**
+ * simd_pyramid.h - Gaussian and Laplacian image pyramids
+ *
+ * Each Gaussian level is the previous one blurred with the 5-tap binomial
+ * kernel [1 4 6 4 1] / 16 (separable, borders replicated) and decimated 2x:
+ * - pyr_down_scalar: reference, one output pixel at a time
+ * - pyr_down_simd: fused, one pass per level. For every output row, the five
+ *   source rows are filtered vertically into a 16-bit row, filtered
+ *   horizontally with shifted loads, narrowed to bytes and decimated. Only
+ *   every other row is ever filtered and no blurred full-size image is written.
+ *
+ * All integer arithmetic (exact, (sum + 128) >> 8 rounding), so both versions
+ * produce identical bytes. Images are interleaved with 1 or 3 channels
+ * (other channel counts work, with a scalar decimation step) and rows stored
+ * back to back; the pyr_down and build overloads taking image views
+ * (simd_view.h) accept any row stride.
+ *
+ * GaussianPyramid keeps every level in one 64-byte-aligned arena, level after
+ * level, so walking the pyramid touches one contiguous block of memory.
+ * LaplacianPyramid stores G[i] - expand(G[i + 1]) as int16 in a second arena
+ * and reconstructs the original image exactly.
+ */
+
+#ifndef SIMD_PYRAMID_H
+#define SIMD_PYRAMID_H
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "simd_view.h"
+
+struct PyramidLevel {
+    int width;
+    int height;
+    int channels;
+    size_t offset;  // in elements from the start of the arena
+
+    size_t size() const { return static_cast<size_t>(width) * height * channels; }
+};
+
+inline int pyr_clamp(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// dst must be ((width + 1) / 2) x ((height + 1) / 2) with the same channel count
+inline void check_pyr_down_views(const ConstImageView& src, const ImageView& dst) {
+    if (dst.width != (src.width + 1) / 2 || dst.height != (src.height + 1) / 2 || dst.channels != src.channels) {
+        throw std::invalid_argument("pyr_down target must be half the source size, rounded up");
+    }
+}
+
+// 1. Downsample (blur + decimate) - Scalar implementation
+inline void pyr_down_scalar(const ConstImageView& src, const ImageView& dst) {
+    static const int taps[5] = {1, 4, 6, 4, 1};
+    check_pyr_down_views(src, dst);
+    const int width = src.width, height = src.height, channels = src.channels;
+    for (int y = 0; y < dst.height; y++) {
+        for (int x = 0; x < dst.width; x++) {
+            for (int c = 0; c < channels; c++) {
+                int sum = 0;
+                for (int j = 0; j < 5; j++) {
+                    int sy = pyr_clamp(2 * y + j - 2, 0, height - 1);
+                    for (int i = 0; i < 5; i++) {
+                        int sx = pyr_clamp(2 * x + i - 2, 0, width - 1);
+                        sum += taps[j] * taps[i] * src.at(sx, sy)[c];
+                    }
+                }
+                dst.at(x, y)[c] = static_cast<uint8_t>((sum + 128) >> 8);
+            }
+        }
+    }
+}
+
+// dst is ((width + 1) / 2) x ((height + 1) / 2)
+inline void pyr_down_scalar(const uint8_t* src, int width, int height, int channels, uint8_t* dst) {
+    pyr_down_scalar(ConstImageView(src, width, height, channels),
+                    ImageView(dst, (width + 1) / 2, (height + 1) / 2, channels));
+}
+
+// Filters source row `y` with the 5x5 kernel at full width into `out` (bytes).
+// `vrow` needs width * channels + 4 * channels elements, `out` width * channels + 32.
+inline void pyr_filter_row_simd(const ConstImageView& src, int y, uint16_t* vrow, uint8_t* out) {
+    const int height = src.height, channels = src.channels;
+    const int row_elems = static_cast<int>(src.row_elements());
+    const int pad = 2 * channels;
+    const uint8_t* r0 = src.row(pyr_clamp(y - 2, 0, height - 1));
+    const uint8_t* r1 = src.row(pyr_clamp(y - 1, 0, height - 1));
+    const uint8_t* r2 = src.row(y);
+    const uint8_t* r3 = src.row(pyr_clamp(y + 1, 0, height - 1));
+    const uint8_t* r4 = src.row(pyr_clamp(y + 2, 0, height - 1));
+    uint16_t* v = vrow + pad;
+
+    // Vertical: v = r0 + 4 (r1 + r3) + 6 r2 + r4, at most 4080 per element
+    int i = 0;
+    for (; i <= row_elems - 16; i += 16) {
+        __m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + i)));
+        __m256i a1 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + i)));
+        __m256i a2 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r2 + i)));
+        __m256i a3 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r3 + i)));
+        __m256i a4 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r4 + i)));
+        __m256i outer = _mm256_add_epi16(a0, a4);
+        __m256i inner = _mm256_slli_epi16(_mm256_add_epi16(a1, a3), 2);
+        __m256i center = _mm256_add_epi16(_mm256_slli_epi16(a2, 2), _mm256_slli_epi16(a2, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + i),
+                            _mm256_add_epi16(_mm256_add_epi16(outer, inner), center));
+    }
+    for (; i < row_elems; i++) {
+        v[i] = static_cast<uint16_t>(r0[i] + 4 * (r1[i] + r3[i]) + 6 * r2[i] + r4[i]);
+    }
+
+    // Replicate the edge pixels into the padding
+    for (int c = 0; c < pad; c++) {
+        v[-pad + c] = v[c % channels];
+        v[row_elems + c] = v[row_elems - channels + c % channels];
+    }
+
+    // Horizontal: neighbours of element j are j -/+ channels, j -/+ 2 channels.
+    // Sum at most 65280 + 128, so 16-bit lanes do not overflow.
+    const __m256i rounding = _mm256_set1_epi16(128);
+    i = 0;
+    for (; i <= row_elems - 16; i += 16) {
+        __m256i m2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i - 2 * channels));
+        __m256i m1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i - channels));
+        __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i + channels));
+        __m256i p2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i + 2 * channels));
+        __m256i sum = _mm256_add_epi16(_mm256_add_epi16(m2, p2), _mm256_slli_epi16(_mm256_add_epi16(m1, p1), 2));
+        sum = _mm256_add_epi16(sum, _mm256_add_epi16(_mm256_slli_epi16(c0, 2), _mm256_slli_epi16(c0, 1)));
+        sum = _mm256_srli_epi16(_mm256_add_epi16(sum, rounding), 8);
+        __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    for (; i < row_elems; i++) {
+        int sum = v[i - 2 * channels] + 4 * (v[i - channels] + v[i + channels]) + 6 * v[i] + v[i + 2 * channels];
+        out[i] = static_cast<uint8_t>((sum + 128) >> 8);
+    }
+}
+
+inline void pyr_filter_row_simd(const uint8_t* src, int width, int height, int channels, int y,
+                                uint16_t* vrow, uint8_t* out) {
+    pyr_filter_row_simd(ConstImageView(src, width, height, channels), y, vrow, out);
+}
+
+// Keeps every other pixel of a filtered row
+inline void pyr_decimate_row_simd(const uint8_t* row, int out_width, int channels, uint8_t* out) {
+    int x = 0;
+    if (channels == 1) {
+        const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+        for (; x <= out_width - 16; x += 16) {
+            __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * x)), low_bytes);
+            __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * x + 16)), low_bytes);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), _mm_packus_epi16(a, b));
+        }
+    } else if (channels == 3) {
+        // 8 source pixels (24 bytes) -> 4 output pixels (12 bytes)
+        const __m128i first = _mm_setr_epi8(0, 1, 2, 6, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i second = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 0, 1, 2, 6, 7, 8, -1, -1, -1, -1);
+        for (; x <= out_width - 4; x += 4) {
+            const uint8_t* p = row + 6 * x;
+            __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), first);
+            __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12)), second);
+            __m128i packed = _mm_or_si128(a, b);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 3 * x), packed);
+            uint32_t last = static_cast<uint32_t>(_mm_extract_epi32(packed, 2));
+            std::memcpy(out + 3 * x + 8, &last, sizeof(last));
+        }
+    }
+    for (; x < out_width; x++) {
+        for (int c = 0; c < channels; c++) out[x * channels + c] = row[2 * x * channels + c];
+    }
+}
+
+// 1. Downsample (blur + decimate) - SIMD implementation (fused)
+// vrow and filtered are scratch rows, grown as needed, so that callers
+// downsampling many images allocate them once
+inline void pyr_down_simd(const ConstImageView& src, const ImageView& dst, std::vector<uint16_t>& vrow,
+                          std::vector<uint8_t>& filtered) {
+    check_pyr_down_views(src, dst);
+    vrow.resize(std::max(vrow.size(), static_cast<size_t>(src.width + 4) * src.channels));
+    filtered.resize(std::max(filtered.size(), src.row_elements() + 32));
+    for (int y = 0; y < dst.height; y++) {
+        pyr_filter_row_simd(src, 2 * y, vrow.data(), filtered.data());
+        pyr_decimate_row_simd(filtered.data(), dst.width, dst.channels, dst.row(y));
+    }
+}
+
+inline void pyr_down_simd(const ConstImageView& src, const ImageView& dst) {
+    std::vector<uint16_t> vrow;
+    std::vector<uint8_t> filtered;
+    pyr_down_simd(src, dst, vrow, filtered);
+}
+
+inline void pyr_down_simd(const uint8_t* src, int width, int height, int channels, uint8_t* dst) {
+    pyr_down_simd(ConstImageView(src, width, height, channels),
+                  ImageView(dst, (width + 1) / 2, (height + 1) / 2, channels));
+}
+
+// Aligned arena allocation (freed with free())
+template<typename T>
+T* pyr_alloc(size_t count) {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, 64, count * sizeof(T)) != 0) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+}
+
+// Upsamples src (width x height) to dst_width x dst_height with the matching
+// expand kernel: even outputs [1 6 1] / 8, odd outputs [4 4] / 8, per axis
+inline void pyr_expand(const uint8_t* src, int width, int height, int channels,
+                       int dst_width, int dst_height, uint16_t* dst) {
+    std::vector<int> row(static_cast<size_t>(width) * channels);
+    for (int y = 0; y < dst_height; y++) {
+        int k = y / 2;
+        const uint8_t* above = src + pyr_clamp(k - 1, 0, height - 1) * width * channels;
+        const uint8_t* mid = src + pyr_clamp(k, 0, height - 1) * width * channels;
+        const uint8_t* below = src + pyr_clamp(k + 1, 0, height - 1) * width * channels;
+        for (int i = 0; i < width * channels; i++) {
+            row[i] = (y & 1) ? 4 * (mid[i] + below[i]) : above[i] + 6 * mid[i] + below[i];
+        }
+        for (int x = 0; x < dst_width; x++) {
+            int kx = x / 2;
+            for (int ch = 0; ch < channels; ch++) {
+                int left = row[pyr_clamp(kx - 1, 0, width - 1) * channels + ch];
+                int mid = row[pyr_clamp(kx, 0, width - 1) * channels + ch];
+                int right = row[pyr_clamp(kx + 1, 0, width - 1) * channels + ch];
+                int sum = (x & 1) ? 4 * (mid + right) : left + 6 * mid + right;
+                dst[(static_cast<size_t>(y) * dst_width + x) * channels + ch] = static_cast<uint16_t>((sum + 32) >> 6);
+            }
+        }
+    }
+}
+
+class GaussianPyramid {
+public:
+    // Levels are added until the next one would be smaller than min_size pixels
+    // on either side, or max_levels is reached (0 = no limit)
+    GaussianPyramid(int width, int height, int channels, int max_levels = 0, int min_size = 8)
+        : arena(nullptr), arena_bytes(0) {
+        if (width <= 0 || height <= 0 || channels <= 0) {
+            throw std::invalid_argument("pyramid dimensions must be positive");
+        }
+        size_t offset = 0;
+        int w = width, h = height;
+        for (;;) {
+            PyramidLevel level = {w, h, channels, offset};
+            info.push_back(level);
+            offset = (offset + level.size() + 63) & ~size_t(63);  // 64-byte aligned levels
+            if (static_cast<int>(info.size()) == max_levels || (w + 1) / 2 < min_size || (h + 1) / 2 < min_size) {
+                break;
+            }
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+        arena_bytes = offset;
+        arena = pyr_alloc<uint8_t>(arena_bytes);
+    }
+
+    ~GaussianPyramid() { free(arena); }
+
+    GaussianPyramid(const GaussianPyramid&) = delete;
+    GaussianPyramid& operator=(const GaussianPyramid&) = delete;
+
+    // Copies the image into level 0 and derives the others
+    void build(const uint8_t* image, bool simd = true) {
+        build(ConstImageView(image, info[0].width, info[0].height, info[0].channels), simd);
+    }
+
+    // Same, from a view of the level-0 size (a region or padded rows)
+    void build(const ConstImageView& image, bool simd = true) {
+        const PyramidLevel& base = info[0];
+        if (image.width != base.width || image.height != base.height || image.channels != base.channels) {
+            throw std::invalid_argument("image does not match the pyramid's base level");
+        }
+        const size_t row = image.row_bytes();
+        if (image.contiguous()) {
+            std::memcpy(arena, image.data, base.size());
+        } else {
+            for (int y = 0; y < base.height; y++) std::memcpy(arena + y * row, image.row(y), row);
+        }
+        for (size_t i = 1; i < info.size(); i++) {
+            const PyramidLevel& prev = info[i - 1];
+            if (simd) {
+                pyr_down_simd(level(i - 1), prev.width, prev.height, prev.channels, level(i));
+            } else {
+                pyr_down_scalar(level(i - 1), prev.width, prev.height, prev.channels, level(i));
+            }
+        }
+    }
+
+    int levels() const { return static_cast<int>(info.size()); }
+    const PyramidLevel& level_info(int i) const { return info[i]; }
+    uint8_t* level(int i) { return arena + info[i].offset; }
+    const uint8_t* level(int i) const { return arena + info[i].offset; }
+    size_t arena_size() const { return arena_bytes; }
+
+private:
+    std::vector<PyramidLevel> info;
+    uint8_t* arena;
+    size_t arena_bytes;
+};
+
+class LaplacianPyramid {
+public:
+    explicit LaplacianPyramid(const GaussianPyramid& gaussian)
+        : info(), arena(nullptr), elements(0) {
+        size_t offset = 0;
+        for (int i = 0; i < gaussian.levels(); i++) {
+            PyramidLevel level = gaussian.level_info(i);
+            level.offset = offset;
+            info.push_back(level);
+            offset = (offset + level.size() + 31) & ~size_t(31);  // 64-byte aligned int16 levels
+        }
+        elements = offset;
+        arena = pyr_alloc<int16_t>(elements);
+
+        // L[i] = G[i] - expand(G[i + 1]); the coarsest level is G itself
+        std::vector<uint16_t> expanded;
+        for (int i = 0; i < levels(); i++) {
+            const PyramidLevel& l = info[i];
+            const uint8_t* g = gaussian.level(i);
+            int16_t* out = level(i);
+            if (i + 1 == levels()) {
+                for (size_t k = 0; k < l.size(); k++) out[k] = g[k];
+                continue;
+            }
+            const PyramidLevel& next = info[i + 1];
+            expanded.resize(l.size());
+            pyr_expand(gaussian.level(i + 1), next.width, next.height, next.channels, l.width, l.height, expanded.data());
+            subtract(g, expanded.data(), out, l.size());
+        }
+    }
+
+    ~LaplacianPyramid() { free(arena); }
+
+    LaplacianPyramid(const LaplacianPyramid&) = delete;
+    LaplacianPyramid& operator=(const LaplacianPyramid&) = delete;
+
+    // Collapses the pyramid back into a full-resolution image
+    void reconstruct(uint8_t* image) const {
+        std::vector<uint8_t> current(info.back().size());
+        for (size_t k = 0; k < current.size(); k++) current[k] = static_cast<uint8_t>(level(levels() - 1)[k]);
+
+        std::vector<uint16_t> expanded;
+        for (int i = levels() - 2; i >= 0; i--) {
+            const PyramidLevel& l = info[i];
+            const PyramidLevel& next = info[i + 1];
+            expanded.resize(l.size());
+            pyr_expand(current.data(), next.width, next.height, next.channels, l.width, l.height, expanded.data());
+            std::vector<uint8_t> finer(l.size());
+            const int16_t* lap = level(i);
+            for (size_t k = 0; k < l.size(); k++) {
+                finer[k] = static_cast<uint8_t>(pyr_clamp(lap[k] + expanded[k], 0, 255));
+            }
+            current.swap(finer);
+        }
+        std::memcpy(image, current.data(), current.size());
+    }
+
+    int levels() const { return static_cast<int>(info.size()); }
+    const PyramidLevel& level_info(int i) const { return info[i]; }
+    int16_t* level(int i) { return arena + info[i].offset; }
+    const int16_t* level(int i) const { return arena + info[i].offset; }
+
+private:
+    // out = g - e, 16 elements at a time
+    static void subtract(const uint8_t* g, const uint16_t* e, int16_t* out, size_t size) {
+        size_t k = 0;
+        for (; k + 16 <= size; k += 16) {
+            __m256i gv = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(g + k)));
+            __m256i ev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(e + k));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), _mm256_sub_epi16(gv, ev));
+        }
+        for (; k < size; k++) out[k] = static_cast<int16_t>(g[k] - e[k]);
+    }
+
+    std::vector<PyramidLevel> info;
+    int16_t* arena;
+    size_t elements;
+};
+
+#endif // SIMD_PYRAMID_H
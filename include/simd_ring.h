@@ -0,0 +1,288 @@
+/**
+ * simd_ring.h - Lock-free ring buffers for pipeline stages
+ *
+ * Bounded queues for passing small handles (frame or tile indices, pointers)
+ * between threads that run different pipeline stages:
+ * - SpscRing<T>: single producer, single consumer. Each side caches the other
+ *   side's index so most operations touch only their own cache line.
+ * - MpmcRing<T>: multiple producers and consumers (Dmitry Vyukov's bounded
+ *   queue with a sequence number per cell).
+ *
+ * Producer and consumer indices live on separate 64-byte cache lines to avoid
+ * false sharing. Both queues support batch push/pop to amortize the atomic
+ * operations. Capacities are rounded up to a power of two. T should be a
+ * small, trivially copyable handle.
+ *
+ * Requires C++17.
+ */
+
+#ifndef SIMD_RING_H
+#define SIMD_RING_H
+
+#include <immintrin.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+const size_t CACHE_LINE_SIZE = 64;
+
+inline size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Spin briefly, then yield so waiting stages do not starve the others
+// (important when there are more stages than cores)
+class Backoff {
+public:
+    Backoff() : count(0) {}
+
+    void pause() {
+        if (count < 64) {
+            _mm_pause();
+            count++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() { count = 0; }
+
+private:
+    int count;
+};
+
+// ---------------------------------------------------------------------------
+// Single producer, single consumer
+// ---------------------------------------------------------------------------
+
+template<typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "ring elements must be trivially copyable");
+
+public:
+    explicit SpscRing(size_t capacity)
+        : mask(round_up_pow2(capacity < 2 ? 2 : capacity) - 1), cells(new T[mask + 1]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    bool try_push(const T& value) {
+        return push_batch(&value, 1) == 1;
+    }
+
+    bool try_pop(T& value) {
+        return pop_batch(&value, 1) == 1;
+    }
+
+    // Pushes up to `count` values; returns how many fit
+    size_t push_batch(const T* values, size_t count) {
+        size_t tail = producer.index.load(std::memory_order_relaxed);
+        size_t free_slots = capacity() - (tail - producer.cached);
+        if (free_slots < count) {
+            producer.cached = consumer.index.load(std::memory_order_acquire);
+            free_slots = capacity() - (tail - producer.cached);
+        }
+        size_t n = count < free_slots ? count : free_slots;
+        for (size_t i = 0; i < n; i++) {
+            cells[(tail + i) & mask] = values[i];
+        }
+        producer.index.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Pops up to `max_count` values; returns how many were available
+    size_t pop_batch(T* values, size_t max_count) {
+        size_t head = consumer.index.load(std::memory_order_relaxed);
+        size_t available = consumer.cached - head;
+        if (available < max_count) {
+            consumer.cached = producer.index.load(std::memory_order_acquire);
+            available = consumer.cached - head;
+        }
+        size_t n = max_count < available ? max_count : available;
+        for (size_t i = 0; i < n; i++) {
+            values[i] = cells[(head + i) & mask];
+        }
+        consumer.index.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    void push(const T& value) {
+        Backoff backoff;
+        while (!try_push(value)) backoff.pause();
+    }
+
+    T pop() {
+        T value;
+        Backoff backoff;
+        while (!try_pop(value)) backoff.pause();
+        return value;
+    }
+
+private:
+    // Each side's own index plus its cached copy of the other side's index
+    struct alignas(CACHE_LINE_SIZE) Side {
+        std::atomic<size_t> index{0};
+        size_t cached = 0;
+    };
+
+    const size_t mask;
+    std::unique_ptr<T[]> cells;
+    Side producer;
+    Side consumer;
+};
+
+// ---------------------------------------------------------------------------
+// Multiple producers, multiple consumers
+// ---------------------------------------------------------------------------
+
+template<typename T>
+class MpmcRing {
+    static_assert(std::is_trivially_copyable<T>::value, "ring elements must be trivially copyable");
+
+public:
+    explicit MpmcRing(size_t capacity)
+        : mask(round_up_pow2(capacity < 2 ? 2 : capacity) - 1), cells(new Cell[mask + 1]) {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    bool try_push(const T& value) {
+        size_t pos = enqueue_pos.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_pos.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos.value.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_pos.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Claims up to `count` consecutive free cells with a single CAS on the
+    // enqueue index; returns how many values were pushed (0 if full)
+    size_t push_batch(const T* values, size_t count) {
+        if (count == 0) return 0;  // an empty scan would look neither full nor claimable
+        size_t pos = enqueue_pos.value.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t n = 0;
+            size_t seq = 0;
+            while (n < count && n <= mask) {
+                seq = cells[(pos + n) & mask].sequence.load(std::memory_order_acquire);
+                if (seq != pos + n) break;
+                n++;
+            }
+            if (n == 0) {
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0) return 0;  // full
+                pos = enqueue_pos.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < n; i++) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    cell.value = values[i];
+                    cell.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                return n;
+            }
+        }
+    }
+
+    // Claims up to `max_count` consecutive filled cells with a single CAS on
+    // the dequeue index; returns how many values were popped (0 if empty)
+    size_t pop_batch(T* values, size_t max_count) {
+        if (max_count == 0) return 0;
+        size_t pos = dequeue_pos.value.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t n = 0;
+            size_t seq = 0;
+            while (n < max_count && n <= mask) {
+                seq = cells[(pos + n) & mask].sequence.load(std::memory_order_acquire);
+                if (seq != pos + n + 1) break;
+                n++;
+            }
+            if (n == 0) {
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) return 0;  // empty
+                pos = dequeue_pos.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                for (size_t i = 0; i < n; i++) {
+                    Cell& cell = cells[(pos + i) & mask];
+                    values[i] = cell.value;
+                    cell.sequence.store(pos + i + mask + 1, std::memory_order_release);
+                }
+                return n;
+            }
+        }
+    }
+
+    void push(const T& value) {
+        Backoff backoff;
+        while (!try_push(value)) backoff.pause();
+    }
+
+    T pop() {
+        T value;
+        Backoff backoff;
+        while (!try_pop(value)) backoff.pause();
+        return value;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) PaddedIndex {
+        std::atomic<size_t> value{0};
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    PaddedIndex enqueue_pos;
+    PaddedIndex dequeue_pos;
+};
+
+#endif // SIMD_RING_H
@@ -0,0 +1,393 @@
+/**
+ * simd_shm.h - Shared-memory frame pool for zero-copy exchange between processes
+ *
+ * SharedFramePool maps a named shared-memory region holding a fixed number of
+ * frame slots, so a capture process writes each frame once and a processing
+ * process runs the SIMD kernels on it in place:
+ * - Slots are page aligned (2 MB aligned when a slot is at least one huge page),
+ *   which satisfies SIMD_ALIGN_64 for aligned loads and stores
+ * - Backing: hugetlbfs when a hugetlbfs mount with free huge pages exists,
+ *   otherwise POSIX shm_open with an MADV_HUGEPAGE hint, otherwise plain shm
+ * - Slot ownership moves through two lock-free index queues stored in the
+ *   region: free slots (consumer -> producer) and ready frames (producer -> consumer)
+ *
+ * The creating process owns the name and unlinks it on destruction; other
+ * processes open the pool by name. Creating a pool whose name already exists
+ * fails, unless the caller asks to replace a stale pool left by a crashed
+ * process. Up to SHM_MAX_SLOTS slots.
+ *
+ * Linux only. Requires C++17.
+ */
+
+#ifndef SIMD_SHM_H
+#define SIMD_SHM_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "simd_ring.h"
+
+const uint32_t SHM_MAX_SLOTS = 64;
+const size_t SHM_PAGE_SIZE = 4096;
+const size_t SHM_HUGE_PAGE_SIZE = 2 << 20;
+
+inline size_t shm_round_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// Vyukov MPMC queue of slot indices with a fixed layout, so it can live in a
+// shared mapping: no heap pointers, and 64-bit atomics that are lock-free
+// (hence address-free and usable from several processes)
+class SharedIndexQueue {
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared queues need lock-free 64-bit atomics");
+
+public:
+    void init() {
+        for (uint32_t i = 0; i < SHM_MAX_SLOTS; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos.store(0, std::memory_order_relaxed);
+        dequeue_pos.store(0, std::memory_order_release);
+    }
+
+    bool try_push(uint32_t value) {
+        uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos % SHM_MAX_SLOTS];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // full
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(uint32_t& value) {
+        uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos % SHM_MAX_SLOTS];
+            uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.value;
+                    cell.sequence.store(pos + SHM_MAX_SLOTS, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // empty
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        uint32_t value;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> enqueue_pos;
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dequeue_pos;
+    alignas(CACHE_LINE_SIZE) Cell cells[SHM_MAX_SLOTS];
+};
+
+// Written by the producer before publishing a slot
+struct FrameInfo {
+    uint64_t sequence;
+    int32_t width;
+    int32_t height;
+    int32_t channels;
+    uint64_t bytes;
+};
+
+class SharedFramePool {
+public:
+    enum Backing { HUGETLBFS, SHM_HUGE_HINT, SHM };
+
+    // Creates the pool (and owns its name); all slots start out free. Throws if
+    // the name is taken; with replace_stale the old name is unlinked first,
+    // which detaches any process still using it.
+    SharedFramePool(const std::string& name, uint32_t slot_count, size_t slot_size, bool replace_stale = false)
+        : name(name), owner(false), base(nullptr), mapped_size(0), header(nullptr) {
+        if (slot_count == 0 || slot_count > SHM_MAX_SLOTS || slot_size == 0 ||
+            slot_size > (SIZE_MAX / 2) / SHM_MAX_SLOTS) {
+            throw std::invalid_argument("slot_count must be 1.." + std::to_string(SHM_MAX_SLOTS) +
+                                        " and slot_size non-zero");
+        }
+        if (replace_stale) {
+            remove_name();
+        } else if (name_in_use()) {
+            throw std::runtime_error("frame pool " + name + " already exists");
+        }
+
+        size_t alignment = slot_size >= SHM_HUGE_PAGE_SIZE ? SHM_HUGE_PAGE_SIZE : SHM_PAGE_SIZE;
+        size_t slots_offset = shm_round_up(sizeof(Header), alignment);
+        size_t slot_stride = shm_round_up(slot_size, alignment);
+        size_t size = shm_round_up(slots_offset + slot_stride * slot_count, SHM_HUGE_PAGE_SIZE);
+
+        Backing backing = SHM;
+        int fd = create_hugetlbfs(size);
+        if (fd >= 0) {
+            backing = HUGETLBFS;
+        } else {
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+            if (fd < 0 || ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                int error = errno;
+                if (fd >= 0) {
+                    close(fd);
+                    shm_unlink(name.c_str());
+                }
+                throw std::runtime_error("shm_open(" + name + ") failed: " + std::strerror(error));
+            }
+        }
+        owner = true;  // the name is ours from here on
+
+        map(fd, size);
+        if (backing == SHM && madvise(base, size, MADV_HUGEPAGE) == 0) {
+            backing = SHM_HUGE_HINT;
+        }
+
+        header = new (base) Header;
+        header->slot_count = slot_count;
+        header->slot_size = slot_size;
+        header->slot_stride = slot_stride;
+        header->slots_offset = slots_offset;
+        header->backing = backing;
+        header->closed.store(0, std::memory_order_relaxed);
+        header->free_slots.init();
+        header->ready_slots.init();
+        for (uint32_t i = 0; i < slot_count; i++) {
+            header->free_slots.try_push(i);
+        }
+        // Published last with release order; openers load it with acquire, so
+        // they never see a half-built pool
+        __atomic_store_n(&header->magic, MAGIC, __ATOMIC_RELEASE);
+    }
+
+    // Opens a pool created by another process
+    explicit SharedFramePool(const std::string& name)
+        : name(name), owner(false), base(nullptr), mapped_size(0), header(nullptr) {
+        int fd = -1;
+        std::string mount = hugetlbfs_mount();
+        if (!mount.empty()) {
+            fd = open((mount + name).c_str(), O_RDWR | O_CLOEXEC);
+        }
+        if (fd < 0) {
+            fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        }
+        if (fd < 0) {
+            throw std::runtime_error("cannot open frame pool " + name + ": " + std::strerror(errno));
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            close(fd);
+            throw std::runtime_error("frame pool " + name + " is truncated");
+        }
+        map(fd, static_cast<size_t>(st.st_size));
+        header = reinterpret_cast<Header*>(base);
+        // Everything below comes from shared memory: bound the slot count before
+        // it indexes the per-slot arrays, and compare sizes without overflowing
+        uint32_t count = header->slot_count;
+        if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != MAGIC || count == 0 || count > SHM_MAX_SLOTS ||
+            header->slots_offset > mapped_size ||
+            header->slot_stride > (mapped_size - header->slots_offset) / count ||
+            header->slot_size > header->slot_stride) {
+            munmap(base, mapped_size);
+            throw std::runtime_error("frame pool " + name + " has an invalid header");
+        }
+    }
+
+    ~SharedFramePool() {
+        if (base) munmap(base, mapped_size);
+        if (owner) remove_name();
+    }
+
+    SharedFramePool(const SharedFramePool&) = delete;
+    SharedFramePool& operator=(const SharedFramePool&) = delete;
+
+    uint32_t slot_count() const { return header->slot_count; }
+    size_t slot_size() const { return header->slot_size; }
+    size_t size() const { return mapped_size; }
+    Backing backing() const { return static_cast<Backing>(header->backing); }
+
+    const char* backing_name() const {
+        switch (backing()) {
+            case HUGETLBFS: return "hugetlbfs";
+            case SHM_HUGE_HINT: return "shm + MADV_HUGEPAGE";
+            default: return "shm";
+        }
+    }
+
+    uint8_t* slot(uint32_t index) {
+        return base + header->slots_offset + header->slot_stride * index;
+    }
+
+    FrameInfo& info(uint32_t index) { return header->info[index]; }
+
+    // Producer: take a free slot to write into
+    bool try_acquire(uint32_t& index) { return header->free_slots.try_pop(index); }
+
+    uint32_t acquire() {
+        uint32_t index;
+        Backoff backoff;
+        while (!try_acquire(index)) backoff.pause();
+        return index;
+    }
+
+    // Producer: hand a filled slot (and its info) to the consumer
+    void publish(uint32_t index) {
+        Backoff backoff;
+        while (!header->ready_slots.try_push(index)) backoff.pause();
+    }
+
+    // Consumer: take the next ready frame
+    bool try_receive(uint32_t& index) { return header->ready_slots.try_pop(index); }
+
+    // Blocks for the next ready frame; returns false once the pool is closed
+    // and every published frame has been received
+    bool receive(uint32_t& index) {
+        Backoff backoff;
+        for (;;) {
+            if (try_receive(index)) return true;
+            if (header->closed.load(std::memory_order_acquire)) {
+                return try_receive(index);
+            }
+            backoff.pause();
+        }
+    }
+
+    // Consumer: give a processed slot back to the producer
+    void release(uint32_t index) {
+        Backoff backoff;
+        while (!header->free_slots.try_push(index)) backoff.pause();
+    }
+
+    // Producer: no more frames will be published
+    void close_pool() { header->closed.store(1, std::memory_order_release); }
+
+private:
+    static const uint64_t MAGIC = 0x53494d4446504f4fULL;  // "SIMDFPOO"
+
+    struct Header {
+        uint64_t magic;
+        uint32_t slot_count;
+        uint32_t backing;
+        uint64_t slot_size;
+        uint64_t slot_stride;
+        uint64_t slots_offset;
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> closed;
+        SharedIndexQueue free_slots;
+        SharedIndexQueue ready_slots;
+        FrameInfo info[SHM_MAX_SLOTS];
+    };
+
+    // First hugetlbfs mount point from /proc/mounts, or "" if there is none
+    static std::string hugetlbfs_mount() {
+        FILE* mounts = std::fopen("/proc/mounts", "r");
+        if (!mounts) return "";
+        char device[256], dir[256], type[64];
+        std::string result;
+        while (std::fscanf(mounts, "%255s %255s %63s %*[^\n]", device, dir, type) == 3) {
+            if (std::strcmp(type, "hugetlbfs") == 0) {
+                result = dir;
+                break;
+            }
+        }
+        std::fclose(mounts);
+        return result;
+    }
+
+    // Whether a pool of this name exists in either namespace; O_EXCL on the
+    // create below still catches a creator racing this check
+    bool name_in_use() const {
+        std::string mount = hugetlbfs_mount();
+        if (!mount.empty() && access((mount + name).c_str(), F_OK) == 0) return true;
+        int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd >= 0) close(fd);
+        return fd >= 0;
+    }
+
+    // Returns a descriptor for a hugetlbfs file of `size` bytes, or -1. The
+    // pages are touched here so a shortage fails now instead of as SIGBUS later.
+    // Throws if the name already exists.
+    int create_hugetlbfs(size_t size) {
+        std::string mount = hugetlbfs_mount();
+        if (mount.empty()) return -1;
+        std::string path = mount + name;
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (fd < 0 && errno == EEXIST) throw std::runtime_error("frame pool " + name + " already exists");
+        if (fd < 0) return -1;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0 && fallocate(fd, 0, 0, static_cast<off_t>(size)) == 0) {
+            return fd;
+        }
+        close(fd);
+        unlink(path.c_str());
+        return -1;
+    }
+
+    void remove_name() {
+        std::string mount = hugetlbfs_mount();
+        if (!mount.empty()) unlink((mount + name).c_str());
+        shm_unlink(name.c_str());
+    }
+
+    // Maps the file on a 2 MB boundary, so slot alignment holds in the address
+    // space and not only relative to the base: hugetlbfs mappings are aligned
+    // anyway, plain shm is placed inside an over-sized reservation
+    void map(int fd, size_t size) {
+        const size_t reserved = size + SHM_HUGE_PAGE_SIZE;
+        void* area = mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        void* ptr = MAP_FAILED;
+        if (area != MAP_FAILED) {
+            uint8_t* start = static_cast<uint8_t*>(area);
+            uint8_t* aligned = reinterpret_cast<uint8_t*>(
+                shm_round_up(reinterpret_cast<uintptr_t>(start), SHM_HUGE_PAGE_SIZE));
+            ptr = mmap(aligned, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+            if (ptr == MAP_FAILED) {
+                int error = errno;
+                munmap(area, reserved);
+                errno = error;
+            } else {
+                if (aligned > start) munmap(start, aligned - start);
+                if (start + reserved > aligned + size) munmap(aligned + size, start + reserved - (aligned + size));
+            }
+        }
+        int error = errno;
+        close(fd);  // the mapping keeps the region alive
+        if (ptr == MAP_FAILED) {
+            if (owner) remove_name();
+            throw std::runtime_error("mmap of frame pool " + name + " failed: " + std::strerror(error));
+        }
+        base = static_cast<uint8_t*>(ptr);
+        mapped_size = size;
+    }
+
+    std::string name;
+    bool owner;
+    uint8_t* base;
+    size_t mapped_size;
+    Header* header;
+};
+
+#endif // SIMD_SHM_H
@@ -0,0 +1,333 @@
+/**
+ * simd_stream.h - Streaming chunked processing with double buffering
+ *
+ * Feeds data that arrives incrementally (files, pipes, sockets) through SIMD
+ * kernels in fixed-size, 64-byte aligned chunks. A producer thread fills the
+ * next buffer while the calling thread runs the kernel on the current one,
+ * so I/O overlaps computation.
+ *
+ * This header provides:
+ * - ChunkSource: byte source interface, with FdChunkSource (file descriptors)
+ *   and MemoryChunkSource implementations
+ * - StreamKernel: per-chunk kernel interface
+ * - StreamKernelRegistry: kernels registered by name
+ * - StreamPipeline: runs a source through a kernel, either double-buffered
+ *   on a producer thread (run) or synchronously (run_sync) for comparison
+ *
+ * Requires C++17 and -pthread.
+ */
+
+#ifndef SIMD_STREAM_H
+#define SIMD_STREAM_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------
+// Sources
+// ---------------------------------------------------------------------------
+
+class ChunkSource {
+public:
+    virtual ~ChunkSource() {}
+
+    // Reads up to max_size bytes; returns 0 at end of stream. May return
+    // fewer bytes than requested (like read(2) on a socket).
+    virtual size_t read(uint8_t* dst, size_t max_size) = 0;
+
+    // Keeps reading until `size` bytes arrived or the stream ended
+    size_t read_full(uint8_t* dst, size_t size) {
+        size_t total = 0;
+        while (total < size) {
+            size_t n = read(dst + total, size - total);
+            if (n == 0) break;
+            total += n;
+        }
+        return total;
+    }
+};
+
+// Reads from a file descriptor (regular file, pipe or socket)
+class FdChunkSource : public ChunkSource {
+public:
+    explicit FdChunkSource(int fd, bool owns_fd = false) : fd(fd), owns_fd(owns_fd) {}
+
+    explicit FdChunkSource(const std::string& path) : fd(::open(path.c_str(), O_RDONLY)), owns_fd(true) {
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    ~FdChunkSource() {
+        if (owns_fd && fd >= 0) ::close(fd);
+    }
+
+    FdChunkSource(const FdChunkSource&) = delete;
+    FdChunkSource& operator=(const FdChunkSource&) = delete;
+
+    size_t read(uint8_t* dst, size_t max_size) override {
+        for (;;) {
+            ssize_t n = ::read(fd, dst, max_size);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) {
+                throw std::runtime_error(std::string("read failed: ") + std::strerror(errno));
+            }
+        }
+    }
+
+private:
+    int fd;
+    bool owns_fd;
+};
+
+// Reads from memory, optionally in small pieces to mimic a network stream
+class MemoryChunkSource : public ChunkSource {
+public:
+    MemoryChunkSource(const uint8_t* data, size_t size, size_t max_read = SIZE_MAX)
+        : data(data), size(size), offset(0), max_read(max_read) {}
+
+    size_t read(uint8_t* dst, size_t max_size) override {
+        size_t n = std::min(std::min(max_size, max_read), size - offset);
+        std::memcpy(dst, data + offset, n);
+        offset += n;
+        return n;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    size_t max_read;
+};
+
+// ---------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------
+
+class StreamKernel {
+public:
+    virtual ~StreamKernel() {}
+
+    // Chunk sizes are always a multiple of this (except the final chunk,
+    // which is cut short only if the stream itself is)
+    virtual size_t element_size() const { return 1; }
+
+    // Processes one chunk; the buffer is 64-byte aligned and may be
+    // modified in place. It is reused after this call returns.
+    virtual void process(uint8_t* chunk, size_t size) = 0;
+
+    // Called once after the last chunk
+    virtual void finish() {}
+};
+
+// Creates kernels by name, e.g. registry.create("brightness")
+class StreamKernelRegistry {
+public:
+    typedef std::function<std::unique_ptr<StreamKernel>()> Factory;
+
+    void add(const std::string& name, Factory factory) {
+        factories[name] = factory;
+    }
+
+    std::unique_ptr<StreamKernel> create(const std::string& name) const {
+        auto it = factories.find(name);
+        if (it == factories.end()) {
+            throw std::invalid_argument("unknown stream kernel: " + name);
+        }
+        return it->second();
+    }
+
+    std::vector<std::string> names() const {
+        std::vector<std::string> result;
+        for (const auto& entry : factories) result.push_back(entry.first);
+        return result;
+    }
+
+private:
+    std::map<std::string, Factory> factories;
+};
+
+// ---------------------------------------------------------------------------
+// Pipeline
+// ---------------------------------------------------------------------------
+
+struct StreamStats {
+    size_t bytes = 0;
+    size_t chunks = 0;
+    double seconds = 0.0;
+    double compute_wait_seconds = 0.0;  // kernel thread waiting for data
+    double io_wait_seconds = 0.0;       // reader waiting for a free buffer
+
+    double gigabytes_per_second() const {
+        return seconds > 0.0 ? bytes / seconds / 1e9 : 0.0;
+    }
+};
+
+class StreamPipeline {
+public:
+    // chunk_size is rounded down to a multiple of 64; buffer_count >= 2
+    // gives double (or deeper) buffering
+    explicit StreamPipeline(size_t chunk_size, size_t buffer_count = 2)
+        : chunk_size(chunk_size & ~size_t(63)) {
+        if (this->chunk_size == 0 || buffer_count < 2) {
+            throw std::invalid_argument("chunk_size must be >= 64 and buffer_count >= 2");
+        }
+        for (size_t i = 0; i < buffer_count; i++) {
+            void* ptr = nullptr;
+            if (posix_memalign(&ptr, 64, this->chunk_size) != 0) {
+                release();
+                throw std::bad_alloc();
+            }
+            buffers.push_back(static_cast<uint8_t*>(ptr));
+        }
+    }
+
+    ~StreamPipeline() { release(); }
+
+    StreamPipeline(const StreamPipeline&) = delete;
+    StreamPipeline& operator=(const StreamPipeline&) = delete;
+
+    size_t chunk_bytes() const { return chunk_size; }
+
+    // Reads on a producer thread while the calling thread runs the kernel
+    StreamStats run(ChunkSource& source, StreamKernel& kernel) {
+        const size_t chunk = usable_chunk(kernel);
+        const size_t count = buffers.size();
+        typedef std::chrono::steady_clock clock;
+
+        std::vector<size_t> sizes(count, 0);
+        std::vector<bool> full(count, false);
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+        bool stopped = false;  // set if the kernel throws
+        double io_wait = 0.0;
+
+        auto start = clock::now();
+        std::thread producer([&]() {
+            for (size_t i = 0;; i++) {
+                size_t slot = i % count;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    auto wait_start = clock::now();
+                    cv.wait(lock, [&]() { return !full[slot] || stopped; });
+                    io_wait += std::chrono::duration<double>(clock::now() - wait_start).count();
+                    if (stopped) return;
+                }
+
+                size_t n = 0;
+                try {
+                    n = source.read_full(buffers[slot], chunk);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                sizes[slot] = error ? 0 : n;
+                full[slot] = true;
+                cv.notify_all();
+                if (error || n < chunk) return;  // end of stream
+            }
+        });
+
+        StreamStats stats;
+        try {
+            for (size_t i = 0;; i++) {
+                size_t slot = i % count;
+                size_t n;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    auto wait_start = clock::now();
+                    cv.wait(lock, [&]() { return full[slot]; });
+                    stats.compute_wait_seconds += std::chrono::duration<double>(clock::now() - wait_start).count();
+                    n = sizes[slot];
+                }
+
+                if (n > 0) {
+                    kernel.process(buffers[slot], n);
+                    stats.bytes += n;
+                    stats.chunks++;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                full[slot] = false;
+                cv.notify_all();
+                if (n < chunk) break;
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+                cv.notify_all();
+            }
+            producer.join();
+            throw;
+        }
+
+        producer.join();
+        if (error) std::rethrow_exception(error);
+
+        kernel.finish();
+        stats.seconds = std::chrono::duration<double>(clock::now() - start).count();
+        stats.io_wait_seconds = io_wait;
+        return stats;
+    }
+
+    // Baseline: read a chunk, process it, repeat (single buffer, no overlap)
+    StreamStats run_sync(ChunkSource& source, StreamKernel& kernel) {
+        const size_t chunk = usable_chunk(kernel);
+        auto start = std::chrono::steady_clock::now();
+
+        StreamStats stats;
+        for (;;) {
+            size_t n = source.read_full(buffers[0], chunk);
+            if (n > 0) {
+                kernel.process(buffers[0], n);
+                stats.bytes += n;
+                stats.chunks++;
+            }
+            if (n < chunk) break;
+        }
+
+        kernel.finish();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+private:
+    // Largest multiple of the kernel's element size that fits a buffer
+    size_t usable_chunk(const StreamKernel& kernel) const {
+        size_t element = kernel.element_size();
+        size_t chunk = chunk_size - chunk_size % element;
+        if (chunk == 0) {
+            throw std::invalid_argument("chunk_size is smaller than the kernel element size");
+        }
+        return chunk;
+    }
+
+    void release() {
+        for (uint8_t* buffer : buffers) free(buffer);
+        buffers.clear();
+    }
+
+    size_t chunk_size;
+    std::vector<uint8_t*> buffers;
+};
+
+#endif // SIMD_STREAM_H
@@ -0,0 +1,186 @@
+/**
+ * simd_tables.h - Lookup tables for shuffle- and LUT-based SIMD kernels
+ *
+ * All tables are generated by constexpr functions, so they are computed by
+ * the compiler, placed in read-only data (.rodata) and need no initialization
+ * at program startup. Each table is aligned to a 64-byte cache line.
+ *
+ * This header provides:
+ * - make_table<T, N>(gen): generic compile-time table builder
+ * - left_pack_permute_table: 8-bit mask -> _mm256_permutevar8x32_ps indices
+ *   (selected lanes first, then the rest, so it also works for partitioning)
+ * - left_pack_shuffle_table: 8-bit mask -> _mm_shuffle_epi8 indices for bytes
+ * - NibbleClassifier / make_nibble_classifier(pred): pshufb tables that test
+ *   set membership of bytes (e.g. the base64 alphabet) 32 bytes at a time
+ * - base64_encode_table / base64_decode_table
+ * - utf8_sequence_length_table: lead byte -> sequence length (0 = invalid)
+ *
+ * Requires C++17 (constexpr lambdas, inline variables).
+ */
+
+#ifndef SIMD_TABLES_H
+#define SIMD_TABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Builds std::array<T, N> with table[i] = gen(i), usable in constant expressions
+template<typename T, size_t N, typename Gen>
+constexpr std::array<T, N> make_table(Gen gen) {
+    std::array<T, N> table{};
+    for (size_t i = 0; i < N; i++) {
+        table[i] = gen(i);
+    }
+    return table;
+}
+
+// ---------------------------------------------------------------------------
+// Left-packing (compaction) tables
+// ---------------------------------------------------------------------------
+
+// Lane indices for _mm256_permutevar8x32_ps / _epi32 (load with _mm256_load_si256)
+struct alignas(32) PermuteEntry8x32 {
+    uint32_t index[8];
+};
+
+// Lanes whose mask bit is set come first, in order, followed by the lanes
+// whose bit is clear. Compaction uses the first popcount(mask) lanes;
+// partitioning uses the whole permutation.
+constexpr PermuteEntry8x32 left_pack_permute_entry(size_t mask) {
+    PermuteEntry8x32 entry{};
+    int out = 0;
+    for (int lane = 0; lane < 8; lane++) {
+        if (mask & (size_t(1) << lane)) entry.index[out++] = lane;
+    }
+    for (int lane = 0; lane < 8; lane++) {
+        if (!(mask & (size_t(1) << lane))) entry.index[out++] = lane;
+    }
+    return entry;
+}
+
+alignas(64) inline constexpr std::array<PermuteEntry8x32, 256> left_pack_permute_table =
+    make_table<PermuteEntry8x32, 256>(left_pack_permute_entry);
+
+// Byte indices for _mm_shuffle_epi8 on the low 8 bytes (load with _mm_loadl_epi64).
+// Unused positions are 0x80 so pshufb writes zero there.
+struct alignas(8) ShuffleEntry8x8 {
+    uint8_t index[8];
+};
+
+constexpr ShuffleEntry8x8 left_pack_shuffle_entry(size_t mask) {
+    ShuffleEntry8x8 entry{};
+    int out = 0;
+    for (int lane = 0; lane < 8; lane++) {
+        if (mask & (size_t(1) << lane)) entry.index[out++] = static_cast<uint8_t>(lane);
+    }
+    for (; out < 8; out++) {
+        entry.index[out] = 0x80;
+    }
+    return entry;
+}
+
+alignas(64) inline constexpr std::array<ShuffleEntry8x8, 256> left_pack_shuffle_table =
+    make_table<ShuffleEntry8x8, 256>(left_pack_shuffle_entry);
+
+// ---------------------------------------------------------------------------
+// Nibble-based byte classification (pshufb lookup)
+// ---------------------------------------------------------------------------
+
+// A byte c is in the set iff (lo[c & 0x0F] & hi[c >> 4]) != 0.
+// Both tables are 16 bytes and get broadcast to each 128-bit lane.
+struct alignas(16) NibbleClassifier {
+    uint8_t lo[16];
+    uint8_t hi[16];
+    bool valid;  // false if the set needs more than 8 distinct row patterns
+};
+
+// Each high nibble selects a "row" of 16 possible low nibbles. Rows with the
+// same pattern share one class bit; the low-nibble table holds, for each low
+// nibble, the class bits of all rows containing it. Exact for any set whose
+// rows have at most 8 distinct non-empty patterns.
+template<typename Pred>
+constexpr NibbleClassifier make_nibble_classifier(Pred in_set) {
+    NibbleClassifier c{};
+    uint16_t patterns[8] = {};
+    int pattern_count = 0;
+    c.valid = true;
+
+    for (int h = 0; h < 16; h++) {
+        uint16_t row = 0;
+        for (int l = 0; l < 16; l++) {
+            if (in_set(static_cast<uint8_t>((h << 4) | l))) row |= static_cast<uint16_t>(1u << l);
+        }
+        if (row == 0) continue;
+
+        int bit = -1;
+        for (int p = 0; p < pattern_count; p++) {
+            if (patterns[p] == row) bit = p;
+        }
+        if (bit < 0) {
+            if (pattern_count == 8) {
+                c.valid = false;
+                return c;
+            }
+            bit = pattern_count;
+            patterns[pattern_count++] = row;
+        }
+        c.hi[h] = static_cast<uint8_t>(1u << bit);
+    }
+
+    for (int p = 0; p < pattern_count; p++) {
+        for (int l = 0; l < 16; l++) {
+            if (patterns[p] & (1u << l)) c.lo[l] |= static_cast<uint8_t>(1u << p);
+        }
+    }
+    return c;
+}
+
+// ---------------------------------------------------------------------------
+// Base64
+// ---------------------------------------------------------------------------
+
+constexpr char base64_char(size_t value) {
+    return value < 26 ? static_cast<char>('A' + value)
+         : value < 52 ? static_cast<char>('a' + value - 26)
+         : value < 62 ? static_cast<char>('0' + value - 52)
+         : value == 62 ? '+' : '/';
+}
+
+// Sextet value of a base64 character, or 0xFF if it is not in the alphabet
+constexpr uint8_t base64_value(size_t c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c - 'A')
+         : (c >= 'a' && c <= 'z') ? static_cast<uint8_t>(c - 'a' + 26)
+         : (c >= '0' && c <= '9') ? static_cast<uint8_t>(c - '0' + 52)
+         : c == '+' ? 62 : c == '/' ? 63 : 0xFF;
+}
+
+alignas(64) inline constexpr std::array<char, 64> base64_encode_table =
+    make_table<char, 64>(base64_char);
+
+alignas(64) inline constexpr std::array<uint8_t, 256> base64_decode_table =
+    make_table<uint8_t, 256>(base64_value);
+
+alignas(64) inline constexpr NibbleClassifier base64_classifier =
+    make_nibble_classifier([](uint8_t c) { return base64_value(c) != 0xFF; });
+
+static_assert(base64_classifier.valid, "base64 alphabet must fit a nibble classifier");
+
+// ---------------------------------------------------------------------------
+// UTF-8
+// ---------------------------------------------------------------------------
+
+// Total sequence length for a lead byte; 0 for continuation bytes (10xxxxxx)
+// and bytes that can never start a valid sequence (C0, C1, F5..FF).
+constexpr uint8_t utf8_sequence_length(size_t b) {
+    return b < 0x80 ? 1
+         : b < 0xC2 ? 0
+         : b < 0xE0 ? 2
+         : b < 0xF0 ? 3
+         : b < 0xF5 ? 4 : 0;
+}
+
+alignas(64) inline constexpr std::array<uint8_t, 256> utf8_sequence_length_table =
+    make_table<uint8_t, 256>(utf8_sequence_length);
+
+#endif // SIMD_TABLES_H
@@ -0,0 +1,391 @@
+/**
+ * simd_threshold.h - Global, Otsu and adaptive thresholding of grayscale images
+ *
+ * Binarization for the document-scanning path, on the 1-byte grayscale images
+ * produced by convert_to_grayscale_simd:
+ * - Global threshold: pixel > t, as a byte mask (0/255) or a packed 1-bit mask
+ *   (one _mm256_movemask_epi8 per 32 pixels)
+ * - Otsu: picks t from the histogram by maximizing the between-class variance;
+ *   the histogram reads 64-bit words and spreads its counts over four
+ *   sub-histograms so runs of equal pixels don't serialize on one counter
+ * - Adaptive: pixel > mean of its (2r+1)^2 window - offset, with window sums from
+ *   an integral image (SIMD prefix sums), so the cost does not depend on r.
+ *   Copes with uneven lighting, where no single global threshold works.
+ * Every kernel takes `invert` to select the dark pixels (ink) instead.
+ *
+ * Packed bit masks store each row in whole 64-bit words (bit_mask_stride bytes),
+ * bit x % 8 of byte x / 8, padding bits zero.
+ *
+ * The ImageView overloads (simd_view.h) read grayscale views with any stride, so
+ * a region of a page can be binarized in place; bit masks and integral images
+ * keep their own tight layouts.
+ */
+
+#ifndef SIMD_THRESHOLD_H
+#define SIMD_THRESHOLD_H
+
+#include <immintrin.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "simd_view.h"
+
+inline size_t bit_mask_stride(int width) {
+    return static_cast<size_t>((width + 63) / 64) * 8;
+}
+
+// 1. Global threshold (byte mask) - Scalar implementation
+inline void threshold_scalar(const uint8_t* gray, uint8_t* mask, size_t count, uint8_t t, bool invert = false) {
+    for (size_t i = 0; i < count; i++) {
+        mask[i] = (gray[i] > t) != invert ? 255 : 0;
+    }
+}
+
+// v > t as 0xFF/0x00 bytes: max(v, t + 1) == v, or nothing when t == 255
+inline __m256i threshold_compare(__m256i v, uint8_t t, __m256i flip) {
+    if (t == 255) return flip;
+    __m256i above = _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(static_cast<char>(t + 1))), v);
+    return _mm256_xor_si256(above, flip);
+}
+
+// 1. Global threshold (byte mask) - SIMD implementation
+inline void threshold_simd(const uint8_t* gray, uint8_t* mask, size_t count, uint8_t t, bool invert = false) {
+    const __m256i flip = invert ? _mm256_set1_epi8(-1) : _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(gray + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), threshold_compare(v, t, flip));
+    }
+    threshold_scalar(gray + i, mask + i, count - i, t, invert);
+}
+
+inline void threshold_scalar(const ConstImageView& gray, const ImageView& mask, uint8_t t, bool invert = false) {
+    check_channels(mask, gray.channels);
+    for_each_span(gray, mask, [&](const uint8_t* g, uint8_t* m, size_t pixels) {
+        threshold_scalar(g, m, pixels * gray.channels, t, invert);
+    });
+}
+
+inline void threshold_simd(const ConstImageView& gray, const ImageView& mask, uint8_t t, bool invert = false) {
+    check_channels(mask, gray.channels);
+    for_each_span(gray, mask, [&](const uint8_t* g, uint8_t* m, size_t pixels) {
+        threshold_simd(g, m, pixels * gray.channels, t, invert);
+    });
+}
+
+// 2. Global threshold (packed bits) - Scalar implementation
+inline void threshold_bits_scalar(const ConstImageView& gray, uint8_t* bits, uint8_t t, bool invert = false) {
+    check_channels(gray, 1);
+    const size_t stride = bit_mask_stride(gray.width);
+    for (int y = 0; y < gray.height; y++) {
+        const uint8_t* row = gray.row(y);
+        uint8_t* out = bits + y * stride;
+        std::memset(out, 0, stride);
+        for (int x = 0; x < gray.width; x++) {
+            if ((row[x] > t) != invert) out[x / 8] |= static_cast<uint8_t>(1 << (x % 8));
+        }
+    }
+}
+
+inline void threshold_bits_scalar(const uint8_t* gray, uint8_t* bits, int width, int height, uint8_t t, bool invert = false) {
+    threshold_bits_scalar(ConstImageView(gray, width, height), bits, t, invert);
+}
+
+// 2. Global threshold (packed bits) - SIMD implementation
+inline void threshold_bits_simd(const ConstImageView& gray, uint8_t* bits, uint8_t t, bool invert = false) {
+    check_channels(gray, 1);
+    const int width = gray.width;
+    const size_t stride = bit_mask_stride(width);
+    const __m256i flip = invert ? _mm256_set1_epi8(-1) : _mm256_setzero_si256();
+    for (int y = 0; y < gray.height; y++) {
+        const uint8_t* row = gray.row(y);
+        uint8_t* out = bits + y * stride;
+        std::memset(out, 0, stride);
+        int x = 0;
+        for (; x + 32 <= width; x += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+            uint32_t m = static_cast<uint32_t>(_mm256_movemask_epi8(threshold_compare(v, t, flip)));
+            std::memcpy(out + x / 8, &m, 4);
+        }
+        for (; x < width; x++) {
+            if ((row[x] > t) != invert) out[x / 8] |= static_cast<uint8_t>(1 << (x % 8));
+        }
+    }
+}
+
+inline void threshold_bits_simd(const uint8_t* gray, uint8_t* bits, int width, int height, uint8_t t, bool invert = false) {
+    threshold_bits_simd(ConstImageView(gray, width, height), bits, t, invert);
+}
+
+// Byte mask (any nonzero = set) to packed bits
+inline void mask_to_bits_simd(const ConstImageView& mask, uint8_t* bits) {
+    check_channels(mask, 1);
+    const int width = mask.width;
+    const size_t stride = bit_mask_stride(width);
+    const __m256i zero = _mm256_setzero_si256();
+    for (int y = 0; y < mask.height; y++) {
+        const uint8_t* row = mask.row(y);
+        uint8_t* out = bits + y * stride;
+        std::memset(out, 0, stride);
+        int x = 0;
+        for (; x + 32 <= width; x += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+            uint32_t m = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+            std::memcpy(out + x / 8, &m, 4);
+        }
+        for (; x < width; x++) {
+            if (row[x]) out[x / 8] |= static_cast<uint8_t>(1 << (x % 8));
+        }
+    }
+}
+
+inline void mask_to_bits_simd(const uint8_t* mask, uint8_t* bits, int width, int height) {
+    mask_to_bits_simd(ConstImageView(mask, width, height), bits);
+}
+
+// 3. Histogram - Scalar implementation
+inline void histogram_scalar(const uint8_t* gray, size_t count, uint32_t hist[256]) {
+    std::memset(hist, 0, 256 * sizeof(uint32_t));
+    for (size_t i = 0; i < count; i++) hist[gray[i]]++;
+}
+
+// 3. Histogram - SIMD implementation: pixels are read 8 at a time as 64-bit words
+// and counted into four sub-histograms, so neighbouring equal pixels hit
+// different counters instead of waiting on each other's increments; the
+// sub-histograms are merged with vector adds. (Extracting the bytes from a vector
+// register instead measured slower than these word loads.)
+inline void histogram_count4(const uint8_t* gray, size_t count, uint32_t sub[4][256]) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint64_t a, b;
+        std::memcpy(&a, gray + i, 8);
+        std::memcpy(&b, gray + i + 8, 8);
+        sub[0][a & 0xFF]++;
+        sub[1][(a >> 8) & 0xFF]++;
+        sub[2][(a >> 16) & 0xFF]++;
+        sub[3][(a >> 24) & 0xFF]++;
+        sub[0][(a >> 32) & 0xFF]++;
+        sub[1][(a >> 40) & 0xFF]++;
+        sub[2][(a >> 48) & 0xFF]++;
+        sub[3][a >> 56]++;
+        sub[0][b & 0xFF]++;
+        sub[1][(b >> 8) & 0xFF]++;
+        sub[2][(b >> 16) & 0xFF]++;
+        sub[3][(b >> 24) & 0xFF]++;
+        sub[0][(b >> 32) & 0xFF]++;
+        sub[1][(b >> 40) & 0xFF]++;
+        sub[2][(b >> 48) & 0xFF]++;
+        sub[3][b >> 56]++;
+    }
+    for (; i < count; i++) sub[0][gray[i]]++;
+}
+
+inline void histogram_merge4(const uint32_t sub[4][256], uint32_t hist[256]) {
+    for (int b = 0; b < 256; b += 8) {
+        __m256i s = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(&sub[0][b])),
+                             _mm256_load_si256(reinterpret_cast<const __m256i*>(&sub[1][b]))),
+            _mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(&sub[2][b])),
+                             _mm256_load_si256(reinterpret_cast<const __m256i*>(&sub[3][b]))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&hist[b]), s);
+    }
+}
+
+inline void histogram_simd(const uint8_t* gray, size_t count, uint32_t hist[256]) {
+    alignas(32) uint32_t sub[4][256] = {};
+    histogram_count4(gray, count, sub);
+    histogram_merge4(sub, hist);
+}
+
+// Histogram of every sample in the view
+inline void histogram_scalar(const ConstImageView& gray, uint32_t hist[256]) {
+    std::memset(hist, 0, 256 * sizeof(uint32_t));
+    for_each_span(gray, [&](const uint8_t* p, size_t pixels) {
+        for (size_t i = 0; i < pixels * gray.channels; i++) hist[p[i]]++;
+    });
+}
+
+inline void histogram_simd(const ConstImageView& gray, uint32_t hist[256]) {
+    alignas(32) uint32_t sub[4][256] = {};
+    for_each_span(gray, [&](const uint8_t* p, size_t pixels) { histogram_count4(p, pixels * gray.channels, sub); });
+    histogram_merge4(sub, hist);
+}
+
+// Otsu's threshold: the t maximizing between-class variance of {<= t} and {> t}
+inline uint8_t otsu_threshold(const uint32_t hist[256]) {
+    double total = 0, weighted = 0;
+    for (int v = 0; v < 256; v++) {
+        total += hist[v];
+        weighted += static_cast<double>(v) * hist[v];
+    }
+    double below = 0, below_weighted = 0, best = -1;
+    int best_t = 0;
+    for (int t = 0; t < 255; t++) {
+        below += hist[t];
+        below_weighted += static_cast<double>(t) * hist[t];
+        double above = total - below;
+        if (below == 0 || above == 0) continue;
+        double mean_below = below_weighted / below;
+        double mean_above = (weighted - below_weighted) / above;
+        double between = below * above * (mean_below - mean_above) * (mean_below - mean_above);
+        if (between > best) {
+            best = between;
+            best_t = t;
+        }
+    }
+    return static_cast<uint8_t>(best_t);
+}
+
+// 4. Integral image - Scalar implementation. sums is (width + 1) x (height + 1)
+// with a zero first row and column; uint32 wraps for huge images, but window
+// sums (differences) stay exact as long as one window sums below 2^32.
+inline void integral_image_scalar(const ConstImageView& gray, uint32_t* sums) {
+    check_channels(gray, 1);
+    const int width = gray.width;
+    const size_t stride = static_cast<size_t>(width) + 1;
+    std::memset(sums, 0, stride * sizeof(uint32_t));
+    for (int y = 0; y < gray.height; y++) {
+        const uint8_t* src = gray.row(y);
+        uint32_t* above = sums + y * stride;
+        uint32_t* row = above + stride;
+        row[0] = 0;
+        uint32_t run = 0;
+        for (int x = 0; x < width; x++) {
+            run += src[x];
+            row[x + 1] = above[x + 1] + run;
+        }
+    }
+}
+
+inline void integral_image_scalar(const uint8_t* gray, uint32_t* sums, int width, int height) {
+    integral_image_scalar(ConstImageView(gray, width, height), sums);
+}
+
+// 4. Integral image - SIMD implementation: 8-wide prefix sums (two in-lane shift
+// steps plus the low lane's total carried into the high lane)
+inline void integral_image_simd(const ConstImageView& gray, uint32_t* sums) {
+    check_channels(gray, 1);
+    const int width = gray.width;
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const __m256i last_of_low = _mm256_set1_epi32(3);
+    const __m256i last = _mm256_set1_epi32(7);
+    std::memset(sums, 0, stride * sizeof(uint32_t));
+    for (int y = 0; y < gray.height; y++) {
+        const uint8_t* src = gray.row(y);
+        uint32_t* above = sums + y * stride;
+        uint32_t* row = above + stride;
+        row[0] = 0;
+        __m256i carry = _mm256_setzero_si256();
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x)));
+            v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+            v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+            __m256i low_total = _mm256_permutevar8x32_epi32(v, last_of_low);
+            v = _mm256_add_epi32(v, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+            v = _mm256_add_epi32(v, carry);
+            carry = _mm256_permutevar8x32_epi32(v, last);
+            __m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + x + 1));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x + 1), _mm256_add_epi32(v, up));
+        }
+        uint32_t run = static_cast<uint32_t>(_mm256_extract_epi32(carry, 0));
+        for (; x < width; x++) {
+            run += src[x];
+            row[x + 1] = above[x + 1] + run;
+        }
+    }
+}
+
+inline void integral_image_simd(const uint8_t* gray, uint32_t* sums, int width, int height) {
+    integral_image_simd(ConstImageView(gray, width, height), sums);
+}
+
+// Window sum and pixel count around (x, y), clamped to the image
+inline bool adaptive_pixel(uint8_t pixel, const uint32_t* sums, int width, int height, int x, int y,
+                           int radius, int offset, bool invert) {
+    const size_t stride = static_cast<size_t>(width) + 1;
+    int x0 = std::max(0, x - radius), x1 = std::min(width, x + radius + 1);
+    int y0 = std::max(0, y - radius), y1 = std::min(height, y + radius + 1);
+    uint32_t sum = sums[y1 * stride + x1] - sums[y0 * stride + x1] - sums[y1 * stride + x0] + sums[y0 * stride + x0];
+    int64_t count = static_cast<int64_t>(x1 - x0) * (y1 - y0);
+    // pixel > sum / count - offset, without the division
+    return ((pixel + offset) * count > static_cast<int64_t>(sum)) != invert;
+}
+
+// 5. Adaptive threshold - Scalar implementation (sums from integral_image_*)
+inline void adaptive_threshold_scalar(const ConstImageView& gray, const uint32_t* sums, const ImageView& mask,
+                                      int radius, int offset, bool invert = false) {
+    check_channels(gray, 1);
+    check_channels(mask, 1);
+    check_same_size(gray, mask);
+    for (int y = 0; y < gray.height; y++) {
+        const uint8_t* row = gray.row(y);
+        uint8_t* out = mask.row(y);
+        for (int x = 0; x < gray.width; x++) {
+            out[x] = adaptive_pixel(row[x], sums, gray.width, gray.height, x, y, radius, offset, invert) ? 255 : 0;
+        }
+    }
+}
+
+inline void adaptive_threshold_scalar(const uint8_t* gray, const uint32_t* sums, uint8_t* mask, int width, int height,
+                                      int radius, int offset, bool invert = false) {
+    adaptive_threshold_scalar(ConstImageView(gray, width, height), sums, ImageView(mask, width, height), radius,
+                              offset, invert);
+}
+
+// 5. Adaptive threshold - SIMD implementation: 16 pixels per iteration across the
+// columns whose window is not clipped horizontally; 32-bit products keep
+// (pixel + offset) * count exact for windows up to 8M pixels.
+inline void adaptive_threshold_simd(const ConstImageView& gray, const uint32_t* sums, const ImageView& mask,
+                                    int radius, int offset, bool invert = false) {
+    check_channels(gray, 1);
+    check_channels(mask, 1);
+    check_same_size(gray, mask);
+    const int width = gray.width, height = gray.height;
+    const size_t stride = static_cast<size_t>(width) + 1;
+    const __m256i flip = invert ? _mm256_set1_epi8(-1) : _mm256_setzero_si256();
+    const __m256i off = _mm256_set1_epi32(offset);
+    const int x_begin = std::min(width, radius), x_end = std::max(x_begin, width - radius);
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = gray.row(y);
+        uint8_t* out = mask.row(y);
+        int y0 = std::max(0, y - radius), y1 = std::min(height, y + radius + 1);
+        const uint32_t* top = sums + y0 * stride;
+        const uint32_t* bottom = sums + y1 * stride;
+        const __m256i count = _mm256_set1_epi32((2 * radius + 1) * (y1 - y0));
+
+        for (int x = 0; x < x_begin; x++) {
+            out[x] = adaptive_pixel(row[x], sums, width, height, x, y, radius, offset, invert) ? 255 : 0;
+        }
+        int x = x_begin;
+        for (; x + 16 <= x_end; x += 16) {
+            __m256i above[2];
+            for (int h = 0; h < 2; h++) {
+                int x0 = x + 8 * h - radius, x1 = x + 8 * h + radius + 1;
+                auto load = [](const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+                __m256i sum = _mm256_sub_epi32(_mm256_add_epi32(load(bottom + x1), load(top + x0)),
+                                               _mm256_add_epi32(load(top + x1), load(bottom + x0)));
+                __m256i g = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x + 8 * h)));
+                __m256i scaled = _mm256_mullo_epi32(_mm256_add_epi32(g, off), count);
+                above[h] = _mm256_cmpgt_epi32(scaled, sum);
+            }
+            __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(above[0], above[1]), _MM_SHUFFLE(3, 1, 2, 0));
+            __m128i bytes = _mm_packs_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+            bytes = _mm_xor_si128(bytes, _mm256_castsi256_si128(flip));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), bytes);
+        }
+        for (; x < width; x++) {
+            out[x] = adaptive_pixel(row[x], sums, width, height, x, y, radius, offset, invert) ? 255 : 0;
+        }
+    }
+}
+
+inline void adaptive_threshold_simd(const uint8_t* gray, const uint32_t* sums, uint8_t* mask, int width, int height,
+                                    int radius, int offset, bool invert = false) {
+    adaptive_threshold_simd(ConstImageView(gray, width, height), sums, ImageView(mask, width, height), radius, offset,
+                            invert);
+}
+
+#endif // SIMD_THRESHOLD_H
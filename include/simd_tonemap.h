@@ -0,0 +1,239 @@
+/**
+ * simd_tonemap.h - Tone mapping from float HDR RGB to 8-bit RGB
+ *
+ * Rendered and merged-exposure frames hold linear light as floats, with highlights
+ * far above 1.0. Displays and the 8-bit kernels want 0..255, so each sample is
+ * scaled by an exposure, compressed by a tone curve into 0..1 and gamma encoded:
+ * - Exposure/gamma: clip at 1.0
+ * - Reinhard: x (1 + x / white^2) / (1 + x); white = 0 gives plain x / (1 + x),
+ *   otherwise `white` maps to 1.0
+ * - ACES (Narkowicz's fit of the filmic RRT+ODT): x (2.51 x + 0.03) /
+ *   (x (2.43 x + 0.59) + 0.14)
+ * Curves apply per channel, so the functions take a flat count of samples
+ * (3 per RGB pixel, any layout) or float views. The output is tightly packed
+ * bytes, ready for print_image_section, write_ppm or the 8-bit kernels.
+ *
+ * The scalar versions are the reference (division, std::pow). The SIMD versions
+ * handle 32 samples per iteration: divisions become _mm256_rcp_ps refined by one
+ * Newton step, and x^(1/gamma) is exp2(log2(x) / gamma) with log2 from the
+ * exponent bits plus an atanh series and exp2 from a polynomial. They land on
+ * the reference byte or one step next to it. Negative and NaN samples count as 0
+ * and samples are capped at 65504 (the half-float maximum).
+ */
+
+#ifndef SIMD_TONEMAP_H
+#define SIMD_TONEMAP_H
+
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "simd_view.h"
+
+const float TONEMAP_MAX_INPUT = 65504.0f;
+
+inline void check_tonemap_args(float exposure, float gamma) {
+    if (!(exposure >= 0.0f) || !(gamma > 0.0f)) {
+        throw std::invalid_argument("tone mapping needs exposure >= 0 and gamma > 0");
+    }
+}
+
+// Reinhard's 1 / white^2, 0 for no white point
+inline float reinhard_white_term(float white) {
+    if (!(white >= 0.0f)) throw std::invalid_argument("Reinhard white point must not be negative");
+    return white > 0.0f ? 1.0f / (white * white) : 0.0f;
+}
+
+// Scalar building blocks
+
+inline float tonemap_input(float x, float exposure) {
+    x *= exposure;
+    return x > 0.0f ? std::min(x, TONEMAP_MAX_INPUT) : 0.0f;
+}
+
+inline uint8_t tonemap_encode(float v, float inv_gamma) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return static_cast<uint8_t>(std::nearbyint(255.0f * std::pow(v, inv_gamma)));
+}
+
+template<typename Curve>
+inline void tonemap_scalar(const float* src, uint8_t* dst, size_t count, float exposure, float gamma, Curve curve) {
+    check_tonemap_args(exposure, gamma);
+    const float inv_gamma = 1.0f / gamma;
+    for (size_t i = 0; i < count; i++) dst[i] = tonemap_encode(curve(tonemap_input(src[i], exposure)), inv_gamma);
+}
+
+// SIMD building blocks
+
+// 1 / d: hardware estimate (12 bits) plus one Newton step
+inline __m256 tonemap_rcp(__m256 d) {
+    __m256 r = _mm256_rcp_ps(d);
+    return _mm256_mul_ps(r, _mm256_fnmadd_ps(d, r, _mm256_set1_ps(2.0f)));
+}
+
+// log2 of positive normal floats: x = m 2^e with m in [sqrt(1/2), sqrt(2)),
+// log2(m) = 2 atanh(t) / ln 2 with t = (m - 1) / (m + 1), |t| < 0.172
+inline __m256 tonemap_log2(__m256 x) {
+    const __m256i sqrt_half = _mm256_set1_epi32(0x3f3504f3);
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i e = _mm256_srai_epi32(_mm256_sub_epi32(bits, sqrt_half), 23);
+    __m256 m = _mm256_castsi256_ps(_mm256_sub_epi32(bits, _mm256_slli_epi32(e, 23)));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 t = _mm256_mul_ps(_mm256_sub_ps(m, one), tonemap_rcp(_mm256_add_ps(m, one)));
+    __m256 t2 = _mm256_mul_ps(t, t);
+    __m256 p = _mm256_set1_ps(2.0f / (7.0f * 0.693147181f));
+    p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(2.0f / (5.0f * 0.693147181f)));
+    p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(2.0f / (3.0f * 0.693147181f)));
+    p = _mm256_fmadd_ps(p, t2, _mm256_set1_ps(2.0f / 0.693147181f));
+    return _mm256_fmadd_ps(p, t, _mm256_cvtepi32_ps(e));
+}
+
+// 2^y for y in [-126, 0]: 2^round(y) from the exponent bits times a degree-6
+// Taylor polynomial of 2^f, f in [-0.5, 0.5]
+inline __m256 tonemap_exp2(__m256 y) {
+    y = _mm256_max_ps(y, _mm256_set1_ps(-126.0f));
+    __m256 n = _mm256_round_ps(y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 f = _mm256_sub_ps(y, n);
+    __m256 p = _mm256_set1_ps(1.5403530e-4f);
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.3333558e-3f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(9.6181291e-3f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(5.5504109e-2f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(2.4022651e-1f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(6.9314718e-1f));
+    p = _mm256_fmadd_ps(p, f, _mm256_set1_ps(1.0f));
+    __m256i scale = _mm256_slli_epi32(_mm256_cvtps_epi32(n), 23);
+    return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(p), scale));
+}
+
+inline __m256 tonemap_input(__m256 x, __m256 exposure) {
+    // max_ps returns its second operand for NaN, so NaN becomes 0
+    x = _mm256_max_ps(_mm256_mul_ps(x, exposure), _mm256_setzero_ps());
+    return _mm256_min_ps(x, _mm256_set1_ps(TONEMAP_MAX_INPUT));
+}
+
+// 0..1 -> 255 v^(1/gamma) as int32; values under 2^-64 round to 0 anyway
+inline __m256i tonemap_encode(__m256 v, __m256 inv_gamma) {
+    v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(5.421e-20f)), _mm256_set1_ps(1.0f));
+    __m256 p = tonemap_exp2(_mm256_mul_ps(tonemap_log2(v), inv_gamma));
+    return _mm256_cvtps_epi32(_mm256_mul_ps(p, _mm256_set1_ps(255.0f)));
+}
+
+template<typename Curve>
+inline void tonemap_block32(const float* src, uint8_t* dst, __m256 exposure, __m256 inv_gamma, Curve curve) {
+    __m256i q[4];
+    for (int k = 0; k < 4; k++) {
+        q[k] = tonemap_encode(curve(tonemap_input(_mm256_loadu_ps(src + 8 * k), exposure)), inv_gamma);
+    }
+    // The packs work per 128-bit lane; the permute puts the 4-byte groups in order
+    __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+    bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), bytes);
+}
+
+// 32 samples per iteration; the tail goes through the same code on a zero-padded copy
+template<typename Curve>
+inline void tonemap_simd(const float* src, uint8_t* dst, size_t count, float exposure, float gamma, Curve curve) {
+    check_tonemap_args(exposure, gamma);
+    const __m256 exposure_vec = _mm256_set1_ps(exposure);
+    const __m256 inv_gamma = _mm256_set1_ps(1.0f / gamma);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) tonemap_block32(src + i, dst + i, exposure_vec, inv_gamma, curve);
+    if (i < count) {
+        float tail[32] = {};
+        uint8_t out[32];
+        std::memcpy(tail, src + i, (count - i) * sizeof(float));
+        tonemap_block32(tail, out, exposure_vec, inv_gamma, curve);
+        std::memcpy(dst + i, out, count - i);
+    }
+}
+
+// float views -> byte views of the same size and channel count
+template<typename Kernel>
+inline void tonemap_view(const ConstImageViewF& src, const ImageView& dst, Kernel kernel) {
+    check_same_size(src, dst);
+    check_channels(dst, src.channels);
+    const int channels = src.channels;
+    for_each_span(src, dst, [&](const float* s, uint8_t* d, size_t pixels) { kernel(s, d, pixels * channels); });
+}
+
+// 1. Exposure and gamma - Scalar implementation
+inline void tonemap_exposure_scalar(const float* src, uint8_t* dst, size_t count, float exposure, float gamma) {
+    tonemap_scalar(src, dst, count, exposure, gamma, [](float x) { return x; });
+}
+
+// 1. Exposure and gamma - SIMD implementation
+inline void tonemap_exposure_simd(const float* src, uint8_t* dst, size_t count, float exposure, float gamma) {
+    tonemap_simd(src, dst, count, exposure, gamma, [](__m256 x) { return x; });
+}
+
+// 2. Reinhard - Scalar implementation
+inline void tonemap_reinhard_scalar(const float* src, uint8_t* dst, size_t count, float exposure, float white,
+                                    float gamma) {
+    const float w = reinhard_white_term(white);
+    tonemap_scalar(src, dst, count, exposure, gamma, [w](float x) { return x * (1.0f + x * w) / (1.0f + x); });
+}
+
+// 2. Reinhard - SIMD implementation
+inline void tonemap_reinhard_simd(const float* src, uint8_t* dst, size_t count, float exposure, float white,
+                                  float gamma) {
+    const __m256 w = _mm256_set1_ps(reinhard_white_term(white));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    tonemap_simd(src, dst, count, exposure, gamma, [w, one](__m256 x) {
+        __m256 num = _mm256_mul_ps(x, _mm256_fmadd_ps(x, w, one));
+        return _mm256_mul_ps(num, tonemap_rcp(_mm256_add_ps(x, one)));
+    });
+}
+
+// 3. ACES filmic (fitted) - Scalar implementation
+inline void tonemap_aces_scalar(const float* src, uint8_t* dst, size_t count, float exposure, float gamma) {
+    tonemap_scalar(src, dst, count, exposure, gamma, [](float x) {
+        return x * (2.51f * x + 0.03f) / (x * (2.43f * x + 0.59f) + 0.14f);
+    });
+}
+
+// 3. ACES filmic (fitted) - SIMD implementation
+inline void tonemap_aces_simd(const float* src, uint8_t* dst, size_t count, float exposure, float gamma) {
+    tonemap_simd(src, dst, count, exposure, gamma, [](__m256 x) {
+        __m256 num = _mm256_mul_ps(x, _mm256_fmadd_ps(x, _mm256_set1_ps(2.51f), _mm256_set1_ps(0.03f)));
+        __m256 den = _mm256_fmadd_ps(x, _mm256_fmadd_ps(x, _mm256_set1_ps(2.43f), _mm256_set1_ps(0.59f)),
+                                     _mm256_set1_ps(0.14f));
+        return _mm256_mul_ps(num, tonemap_rcp(den));
+    });
+}
+
+// View overloads
+
+inline void tonemap_exposure_scalar(const ConstImageViewF& src, const ImageView& dst, float exposure, float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) { tonemap_exposure_scalar(s, d, n, exposure, gamma); });
+}
+
+inline void tonemap_exposure_simd(const ConstImageViewF& src, const ImageView& dst, float exposure, float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) { tonemap_exposure_simd(s, d, n, exposure, gamma); });
+}
+
+inline void tonemap_reinhard_scalar(const ConstImageViewF& src, const ImageView& dst, float exposure, float white,
+                                    float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) {
+        tonemap_reinhard_scalar(s, d, n, exposure, white, gamma);
+    });
+}
+
+inline void tonemap_reinhard_simd(const ConstImageViewF& src, const ImageView& dst, float exposure, float white,
+                                  float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) {
+        tonemap_reinhard_simd(s, d, n, exposure, white, gamma);
+    });
+}
+
+inline void tonemap_aces_scalar(const ConstImageViewF& src, const ImageView& dst, float exposure, float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) { tonemap_aces_scalar(s, d, n, exposure, gamma); });
+}
+
+inline void tonemap_aces_simd(const ConstImageViewF& src, const ImageView& dst, float exposure, float gamma) {
+    tonemap_view(src, dst, [&](const float* s, uint8_t* d, size_t n) { tonemap_aces_simd(s, d, n, exposure, gamma); });
+}
+
+#endif // SIMD_TONEMAP_H
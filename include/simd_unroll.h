@@ -0,0 +1,163 @@
+/**
+ * simd_unroll.h - Compile-time unrolling and kernel specialization helpers
+ *
+ * This header provides:
+ * - static_for<N>: a compile-time loop that expands its body N times
+ * - VecU8 / VecF32: width-parameterized wrappers over SSE, AVX2 and AVX-512
+ * - SizeDispatcher: picks the fastest kernel specialization per input size
+ *
+ * Kernels take the vector width and unroll factor as template parameters,
+ * so one source can be instantiated as e.g. <256, 4> or <128, 1> and the
+ * benchmark driver can choose between them at runtime.
+ *
+ * Requires C++17 (generic lambdas with constexpr index arguments).
+ */
+
+#ifndef SIMD_UNROLL_H
+#define SIMD_UNROLL_H
+
+#include <immintrin.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// static_for
+// ---------------------------------------------------------------------------
+
+// Compile-time index passed to static_for bodies; use decltype(i)::value
+// (or just `i`, which converts implicitly) inside the lambda.
+template<size_t I>
+using index_constant = std::integral_constant<size_t, I>;
+
+template<typename Func, size_t... Is>
+inline void static_for_impl(Func&& func, std::index_sequence<Is...>) {
+    (func(index_constant<Is>{}), ...);
+}
+
+// Expands func(index_constant<0>{}) ... func(index_constant<N-1>{}) inline.
+template<size_t N, typename Func>
+inline void static_for(Func&& func) {
+    static_for_impl(std::forward<Func>(func), std::make_index_sequence<N>{});
+}
+
+// ---------------------------------------------------------------------------
+// Width-parameterized vector wrappers
+// ---------------------------------------------------------------------------
+
+// Unsigned byte vectors (used by saturating image kernels)
+template<int Bits> struct VecU8;
+
+template<> struct VecU8<128> {
+    typedef __m128i type;
+    static const int lanes = 16;
+    static type load(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint8_t* p, type v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static type set1(uint8_t x) { return _mm_set1_epi8(static_cast<char>(x)); }
+    static type adds(type a, type b) { return _mm_adds_epu8(a, b); }
+};
+
+template<> struct VecU8<256> {
+    typedef __m256i type;
+    static const int lanes = 32;
+    static type load(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint8_t* p, type v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static type set1(uint8_t x) { return _mm256_set1_epi8(static_cast<char>(x)); }
+    static type adds(type a, type b) { return _mm256_adds_epu8(a, b); }
+};
+
+#ifdef __AVX512BW__
+template<> struct VecU8<512> {
+    typedef __m512i type;
+    static const int lanes = 64;
+    static type load(const uint8_t* p) { return _mm512_loadu_si512(p); }
+    static void store(uint8_t* p, type v) { _mm512_storeu_si512(p, v); }
+    static type set1(uint8_t x) { return _mm512_set1_epi8(static_cast<char>(x)); }
+    static type adds(type a, type b) { return _mm512_adds_epu8(a, b); }
+};
+#endif
+
+// Single-precision float vectors (used by reductions such as dot products)
+template<int Bits> struct VecF32;
+
+template<> struct VecF32<128> {
+    typedef __m128 type;
+    static const int lanes = 4;
+    static type load(const float* p) { return _mm_loadu_ps(p); }
+    static type zero() { return _mm_setzero_ps(); }
+    static type add(type a, type b) { return _mm_add_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_fmadd_ps(a, b, c); }
+    static float hsum(type v) {
+        __m128 shuf = _mm_movehdup_ps(v);
+        __m128 sums = _mm_add_ps(v, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+};
+
+template<> struct VecF32<256> {
+    typedef __m256 type;
+    static const int lanes = 8;
+    static type load(const float* p) { return _mm256_loadu_ps(p); }
+    static type zero() { return _mm256_setzero_ps(); }
+    static type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+    static float hsum(type v) {
+        __m128 lo = _mm256_castps256_ps128(v);
+        __m128 hi = _mm256_extractf128_ps(v, 1);
+        return VecF32<128>::hsum(_mm_add_ps(lo, hi));
+    }
+};
+
+#ifdef __AVX512F__
+template<> struct VecF32<512> {
+    typedef __m512 type;
+    static const int lanes = 16;
+    static type load(const float* p) { return _mm512_loadu_ps(p); }
+    static type zero() { return _mm512_setzero_ps(); }
+    static type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+    static float hsum(type v) { return _mm512_reduce_add_ps(v); }
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// Size-based dispatch between specializations
+// ---------------------------------------------------------------------------
+
+// Holds one kernel specialization per size bucket. Buckets are added in
+// increasing order of max_size; select() returns the first bucket that can
+// hold the given size (the last bucket covers everything larger).
+template<typename Fn>
+class SizeDispatcher {
+public:
+    struct Entry {
+        size_t max_size;
+        Fn func;
+        std::string name;
+    };
+
+    void add(size_t max_size, Fn func, const std::string& name) {
+        entries.push_back(Entry{max_size, func, name});
+    }
+
+    const Entry& select(size_t size) const {
+        for (size_t i = 0; i + 1 < entries.size(); i++) {
+            if (size <= entries[i].max_size) {
+                return entries[i];
+            }
+        }
+        return entries.back();
+    }
+
+    bool empty() const { return entries.empty(); }
+    const std::vector<Entry>& buckets() const { return entries; }
+
+private:
+    std::vector<Entry> entries;
+};
+
+#endif // SIMD_UNROLL_H
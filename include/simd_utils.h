@@ -141,6 +141,19 @@ void benchmark_comparison(
     std::cout << "===============================" << std::endl;
 }
 
+// Average time of one call in microseconds (after one warm-up call)
+template<typename Func>
+double measure_microseconds(Func func, int iterations = 100) {
+    func();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        func();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> elapsed = end - start;
+    return elapsed.count() / iterations;
+}
+
 // Allocate aligned memory
 template<typename T>
 T* aligned_alloc(size_t size, size_t alignment = 32) {
@@ -0,0 +1,249 @@
+/**
+ * simd_view.h - Strided image views for regions of interest and padded rows
+ *
+ * The kernels take tightly packed buffers ((image, size) or (src, dst, width,
+ * height)). An image view describes width x height pixels of `channels`
+ * interleaved samples whose rows start `stride` bytes apart, so the same
+ * kernels also run on a region of interest, on rows padded to 64 bytes and on
+ * sub-images, without copying:
+ * - ImageView / ConstImageView: 8-bit samples; ImageView16 / ConstImageView16:
+ *   16-bit samples (linear light); ImageViewF / ConstImageViewF: float samples
+ *   (HDR). Mutable views convert to const ones.
+ * - sub(x, y, w, h): a window into a view, sharing its stride
+ * - for_each_span: hands a per-element kernel one span for the whole image when
+ *   the rows are back to back, one span per row otherwise
+ *
+ * Every kernel header has ImageView overloads next to its pointer versions.
+ * Per-element kernels go through for_each_span; kernels that read neighbouring
+ * rows take the views directly and their pointer versions wrap tight views.
+ * Shape mismatches throw std::invalid_argument.
+ *
+ * ImageBuffer owns 8-bit pixels in rows padded to a multiple of 64 pixels, so
+ * every row is a whole number of pixels, starts 64-byte aligned and is a
+ * multiple of 64 bytes long for any channel count. Kernels written for it
+ * (the *_aligned kernels) use aligned loads and run over the padding instead of
+ * handling tails; the padding holds no meaningful pixels.
+ */
+
+#ifndef SIMD_VIEW_H
+#define SIMD_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+template<typename T>
+struct ImageViewT {
+    T* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 1;
+    size_t stride = 0;  // bytes from one row to the next
+
+    ImageViewT() = default;
+
+    // stride 0 means tightly packed rows
+    ImageViewT(T* data, int width, int height, int channels = 1, size_t stride = 0)
+        : data(data), width(width), height(height), channels(channels),
+          stride(stride ? stride : static_cast<size_t>(width) * channels * sizeof(T)) {
+        if (width < 0 || height < 0 || channels <= 0) {
+            throw std::invalid_argument("image view dimensions must not be negative");
+        }
+        if (this->stride < row_bytes() || this->stride % sizeof(T) != 0) {
+            throw std::invalid_argument("image view stride must cover a row of whole samples");
+        }
+    }
+
+    // Mutable view -> read-only view
+    template<typename U, typename = typename std::enable_if<std::is_same<const U, T>::value>::type>
+    ImageViewT(const ImageViewT<U>& other)
+        : data(other.data), width(other.width), height(other.height), channels(other.channels),
+          stride(other.stride) {}
+
+    size_t row_elements() const { return static_cast<size_t>(width) * channels; }
+    size_t row_bytes() const { return row_elements() * sizeof(T); }
+    bool contiguous() const { return height <= 1 || stride == row_bytes(); }
+
+    T* row(int y) const {
+        using Byte = typename std::conditional<std::is_const<T>::value, const uint8_t, uint8_t>::type;
+        return reinterpret_cast<T*>(reinterpret_cast<Byte*>(data) + static_cast<size_t>(y) * stride);
+    }
+
+    T* at(int x, int y) const { return row(y) + static_cast<size_t>(x) * channels; }
+
+    ImageViewT sub(int x, int y, int w, int h) const {
+        if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > width || y + h > height) {
+            throw std::out_of_range("sub-view outside the image");
+        }
+        return ImageViewT(at(x, y), w, h, channels, stride);
+    }
+};
+
+using ImageView = ImageViewT<uint8_t>;
+using ConstImageView = ImageViewT<const uint8_t>;
+using ImageView16 = ImageViewT<uint16_t>;
+using ConstImageView16 = ImageViewT<const uint16_t>;
+using ImageViewF = ImageViewT<float>;
+using ConstImageViewF = ImageViewT<const float>;
+
+template<typename A, typename B>
+inline void check_same_size(const ImageViewT<A>& a, const ImageViewT<B>& b) {
+    if (a.width != b.width || a.height != b.height) {
+        throw std::invalid_argument("image views differ in size");
+    }
+}
+
+template<typename T>
+inline void check_channels(const ImageViewT<T>& view, int channels) {
+    if (view.channels != channels) {
+        throw std::invalid_argument("image view has the wrong channel count");
+    }
+}
+
+// fn(pointer, pixels) over the whole image at once if possible, else row by row
+template<typename T, typename Fn>
+inline void for_each_span(const ImageViewT<T>& view, Fn fn) {
+    if (view.contiguous()) {
+        fn(view.data, static_cast<size_t>(view.width) * view.height);
+        return;
+    }
+    for (int y = 0; y < view.height; y++) fn(view.row(y), static_cast<size_t>(view.width));
+}
+
+// fn(a pointer, b pointer, pixels) over two views of the same size
+template<typename A, typename B, typename Fn>
+inline void for_each_span(const ImageViewT<A>& a, const ImageViewT<B>& b, Fn fn) {
+    check_same_size(a, b);
+    if (a.contiguous() && b.contiguous()) {
+        fn(a.data, b.data, static_cast<size_t>(a.width) * a.height);
+        return;
+    }
+    for (int y = 0; y < a.height; y++) fn(a.row(y), b.row(y), static_cast<size_t>(a.width));
+}
+
+// fn(a pointer, b pointer, c pointer, pixels) over three views of the same size
+template<typename A, typename B, typename C, typename Fn>
+inline void for_each_span(const ImageViewT<A>& a, const ImageViewT<B>& b, const ImageViewT<C>& c, Fn fn) {
+    check_same_size(a, b);
+    check_same_size(a, c);
+    if (a.contiguous() && b.contiguous() && c.contiguous()) {
+        fn(a.data, b.data, c.data, static_cast<size_t>(a.width) * a.height);
+        return;
+    }
+    for (int y = 0; y < a.height; y++) fn(a.row(y), b.row(y), c.row(y), static_cast<size_t>(a.width));
+}
+
+// Tightly packed copy of an 8-bit image with `border` replicated pixels on
+// every side, for kernels that read a fixed neighbourhood without edge cases.
+// The image must not be empty.
+inline std::vector<uint8_t> replicate_border(const ConstImageView& src, int border) {
+    const int ch = src.channels;
+    const size_t row_bytes = static_cast<size_t>(src.width + 2 * border) * ch;
+    std::vector<uint8_t> padded(row_bytes * (src.height + 2 * border));
+    for (int y = 0; y < src.height + 2 * border; y++) {
+        int sy = y - border;
+        sy = sy < 0 ? 0 : (sy >= src.height ? src.height - 1 : sy);
+        const uint8_t* in = src.row(sy);
+        uint8_t* out = padded.data() + y * row_bytes;
+        for (int x = 0; x < border; x++) {
+            std::memcpy(out + static_cast<size_t>(x) * ch, in, ch);
+            std::memcpy(out + (static_cast<size_t>(border) + src.width + x) * ch, in + (src.width - 1) * ch, ch);
+        }
+        std::memcpy(out + static_cast<size_t>(border) * ch, in, src.row_bytes());
+    }
+    return padded;
+}
+
+// Row starts of an ImageBuffer are aligned to this many bytes
+const size_t IMAGE_ALIGNMENT = 64;
+// Row lengths of an ImageBuffer are padded to a multiple of this many pixels
+const int IMAGE_PIXEL_QUANTUM = 64;
+
+class ImageBuffer {
+public:
+    ImageBuffer(int width, int height, int channels)
+        : pixels(nullptr), w(width), h(height), c(channels),
+          padded_w((width + IMAGE_PIXEL_QUANTUM - 1) / IMAGE_PIXEL_QUANTUM * IMAGE_PIXEL_QUANTUM),
+          row_stride(static_cast<size_t>(padded_w) * channels) {
+        if (width <= 0 || height <= 0 || channels <= 0) {
+            throw std::invalid_argument("image buffer dimensions must be positive");
+        }
+        // One spare alignment block after the last row, so a vector load that
+        // starts inside the image may run past its end
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, IMAGE_ALIGNMENT, size_bytes() + IMAGE_ALIGNMENT) != 0) {
+            throw std::bad_alloc();
+        }
+        pixels = static_cast<uint8_t*>(ptr);
+        std::memset(pixels, 0, size_bytes() + IMAGE_ALIGNMENT);
+    }
+
+    ~ImageBuffer() { free(pixels); }
+
+    ImageBuffer(const ImageBuffer&) = delete;
+    ImageBuffer& operator=(const ImageBuffer&) = delete;
+
+    ImageBuffer(ImageBuffer&& other) noexcept
+        : pixels(other.pixels), w(other.w), h(other.h), c(other.c), padded_w(other.padded_w),
+          row_stride(other.row_stride) {
+        other.pixels = nullptr;
+    }
+
+    ImageBuffer& operator=(ImageBuffer&& other) noexcept {
+        if (this != &other) {
+            free(pixels);
+            pixels = other.pixels;
+            w = other.w;
+            h = other.h;
+            c = other.c;
+            padded_w = other.padded_w;
+            row_stride = other.row_stride;
+            other.pixels = nullptr;
+        }
+        return *this;
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int channels() const { return c; }
+    int padded_width() const { return padded_w; }
+    size_t stride() const { return row_stride; }
+    // All rows including padding: a multiple of 64 bytes
+    size_t size_bytes() const { return row_stride * h; }
+
+    uint8_t* data() { return pixels; }
+    const uint8_t* data() const { return pixels; }
+    uint8_t* row(int y) { return pixels + static_cast<size_t>(y) * row_stride; }
+    const uint8_t* row(int y) const { return pixels + static_cast<size_t>(y) * row_stride; }
+
+    ImageView view() { return ImageView(pixels, w, h, c, row_stride); }
+    ConstImageView view() const { return ConstImageView(pixels, w, h, c, row_stride); }
+
+    // Row-by-row copies from and to views of the same shape
+    void copy_from(const ConstImageView& src) {
+        check_same_size(src, view());
+        check_channels(src, c);
+        const size_t bytes = static_cast<size_t>(w) * c;
+        for (int y = 0; y < h; y++) std::memcpy(row(y), src.row(y), bytes);
+    }
+
+    void copy_to(const ImageView& dst) const {
+        check_same_size(view(), dst);
+        check_channels(dst, c);
+        const size_t bytes = static_cast<size_t>(w) * c;
+        for (int y = 0; y < h; y++) std::memcpy(dst.row(y), row(y), bytes);
+    }
+
+private:
+    uint8_t* pixels;
+    int w, h, c;
+    int padded_w;
+    size_t row_stride;
+};
+
+#endif // SIMD_VIEW_H